@@ -251,13 +251,19 @@ function mapController:onGameStart()
         loadFnc(minimapFile)
     end
 
+    if otmm then
+        mapController:cycleEvent(function()
+            g_minimap.saveOtmmAsync(minimapFile)
+        end, 60000, 'autoSave')
+    end
+
     self.ui.minimapBorder.minimap:load()
 end
 
 function mapController:onGameEnd()
     -- Save Map
     if otmm then
-        g_minimap.saveOtmm('/minimap.otmm')
+        g_minimap.saveOtmmAsync('/minimap.otmm')
     else
         g_map.saveOtcm('/minimap_' .. g_game.getClientVersion() .. '.otcm')
     end
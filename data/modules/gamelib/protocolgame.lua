@@ -4,12 +4,12 @@ local extendedJSONCallbacks = {}
 local extendedJSONData = {}
 local maxPacketSize = 65000
 
+-- only called for the opcodes in registerOpcode, see ProtocolGame.setLuaOpcode
 function ProtocolGame:onOpcode(opcode, msg)
-    for i, callback in pairs(opcodeCallbacks) do
-        if i == opcode then
-            callback(self, msg)
-            return true
-        end
+    local callback = opcodeCallbacks[opcode]
+    if callback then
+        callback(self, msg)
+        return true
     end
     return false
 end
@@ -52,10 +52,12 @@ function ProtocolGame.registerOpcode(opcode, callback)
     end
 
     opcodeCallbacks[opcode] = callback
+    ProtocolGame.setLuaOpcode(opcode, true)
 end
 
 function ProtocolGame.unregisterOpcode(opcode)
     opcodeCallbacks[opcode] = nil
+    ProtocolGame.setLuaOpcode(opcode, false)
 end
 
 function ProtocolGame.registerExtendedOpcode(opcode, callback)
@@ -196,6 +196,9 @@ function g_things.getRaceData(raceId) end
 ---@return Vector<RaceType>
 function g_things.getRacesByName(searchString) end
 
+---@return integer
+function g_things.getTextureMemoryUsage() end
+
 ---* FRAMEWORK_EDITOR
 ---@param id integer
 ---@return ThingType | nil
@@ -349,6 +352,95 @@ function g_spriteAppearances.saveSpriteToFile(id, file) end
 ---@param file string
 function g_spriteAppearances.saveSheetToFileBySprite(id, file) end
 
+---@param bytes integer
+function g_spriteAppearances.setCacheLimit(bytes) end
+
+---@return integer
+function g_spriteAppearances.getCacheLimit() end
+
+---@return integer
+function g_spriteAppearances.getCacheUsage() end
+
+---@return integer
+function g_spriteAppearances.getCacheHits() end
+
+---@return integer
+function g_spriteAppearances.getCacheMisses() end
+
+---@return integer
+function g_spriteAppearances.getCacheEvictions() end
+
+function g_spriteAppearances.resetCacheStats() end
+
+---@param bytes integer
+function g_spriteAppearances.setDiskCacheLimit(bytes) end
+
+---@return integer
+function g_spriteAppearances.getDiskCacheLimit() end
+
+---@return integer
+function g_spriteAppearances.getDiskCacheUsage() end
+
+---@return integer
+function g_spriteAppearances.getDiskCacheHits() end
+
+---@return integer
+function g_spriteAppearances.getDiskCacheMisses() end
+
+--------------------------------
+------- g_spritePrefetcher ------
+--------------------------------
+
+---@class g_spritePrefetcher
+g_spritePrefetcher = {}
+
+---@param enabled boolean
+function g_spritePrefetcher.setEnabled(enabled) end
+
+---@return boolean
+function g_spritePrefetcher.isEnabled() end
+
+---@param max integer
+function g_spritePrefetcher.setMaxConcurrency(max) end
+
+---@return integer
+function g_spritePrefetcher.getMaxConcurrency() end
+
+---@return integer
+function g_spritePrefetcher.getVisibleWaits() end
+
+---@return integer
+function g_spritePrefetcher.getPrefetchPromotions() end
+
+---@return integer
+function g_spritePrefetcher.getPrefetched() end
+
+---@return integer
+function g_spritePrefetcher.getPending() end
+
+function g_spritePrefetcher.resetStats() end
+
+--------------------------------
+--------- g_walkTicker ---------
+--------------------------------
+
+---@class g_walkTicker
+g_walkTicker = {}
+
+---@return integer
+function g_walkTicker.getActiveWalkers() end
+
+---@return integer
+function g_walkTicker.getUpdates() end
+
+---@return integer
+function g_walkTicker.getLastTickTime() end
+
+---@return integer
+function g_walkTicker.getMaxTickTime() end
+
+function g_walkTicker.resetStats() end
+
 --------------------------------
 ------------ g_map -------------
 --------------------------------
@@ -460,6 +552,16 @@ function g_map.getSpectatorsInRangeEx(centerPos, multiFloor, minXRange, maxXRang
 ---@return integer[], integer
 function g_map.findPath(start, goal, maxComplexity, flags) end
 
+---@param start Position | string
+---@param goal Position | string
+---@param flags? integer 0
+---@return PathPlanner
+function g_map.createPathPlanner(start, goal, flags) end
+
+---@param flags? integer 0
+---@return DistanceField
+function g_map.createDistanceField(flags) end
+
 ---@param pos Position | string
 ---@return Tile | nil
 function g_map.createTile(pos) end
@@ -632,6 +734,15 @@ function g_minimap.loadOtmm(fileName) end
 ---@param fileName string
 function g_minimap.saveOtmm(fileName) end
 
+---@param fileName string
+function g_minimap.saveOtmmAsync(fileName) end
+
+---@param bytes integer
+function g_minimap.setMemoryLimit(bytes) end
+
+---@return integer
+function g_minimap.getMemoryLimit() end
+
 --------------------------------
 --------- g_creatures ----------
 --------------------------------
@@ -715,6 +826,13 @@ function g_game.loginWorld(account, password, worldName, worldHost, worldPort, c
                            sessionKey, recordTo)
 end
 
+---@param file string
+function g_game.playRecord(file) end
+
+---@param file string
+---@return string
+function g_game.benchmarkRecord(file) end
+
 function g_game.cancelLogin() end
 
 function g_game.forceLogout() end
@@ -1296,6 +1414,22 @@ function ProtocolGame.create() end
 ---@param buffer string
 function ProtocolGame:sendExtendedOpcode(opcode, buffer) end
 
+---@param opcode integer
+---@param enabled boolean
+function ProtocolGame.setLuaOpcode(opcode, enabled) end
+
+---@param opcode integer
+---@return boolean
+function ProtocolGame.isLuaOpcode(opcode) end
+
+---@return integer
+function ProtocolGame.getLuaOpcodeCalls() end
+
+---@return integer
+function ProtocolGame.getAvoidedLuaOpcodeCalls() end
+
+function ProtocolGame.resetLuaOpcodeCounters() end
+
 --------------------------------
 ---------- Container -----------
 --------------------------------
@@ -2449,6 +2583,90 @@ function StaticText:setColor(color) end
 ---@return Color
 function StaticText:getColor() end
 
+--------------------------------
+--------- PathPlanner ----------
+--------------------------------
+
+---@class PathPlanner
+PathPlanner = {}
+
+---@param start Position | string
+function PathPlanner:setStart(start) end
+
+---@param goal Position | string
+function PathPlanner:setGoal(goal) end
+
+---@param maxComplexity integer
+function PathPlanner:setMaxComplexity(maxComplexity) end
+
+---@return Position
+function PathPlanner:getStart() end
+
+---@return Position
+function PathPlanner:getGoal() end
+
+---@return integer
+function PathPlanner:getFlags() end
+
+---@return integer
+function PathPlanner:getMaxComplexity() end
+
+---@return integer
+function PathPlanner:getLastComplexity() end
+
+---@return integer[], integer
+function PathPlanner:getPath() end
+
+function PathPlanner:reset() end
+
+--------------------------------
+-------- DistanceField ---------
+--------------------------------
+
+---@class DistanceField
+DistanceField = {}
+
+---@param start Position | string
+---@param maxDistance integer
+function DistanceField:compute(start, maxDistance) end
+
+---@return Position
+function DistanceField:getStart() end
+
+---@return integer
+function DistanceField:getFlags() end
+
+---@return integer
+function DistanceField:getMaxDistance() end
+
+---@param pos Position | string
+---@return boolean
+function DistanceField:isReachable(pos) end
+
+---@param pos Position | string
+---@return number
+function DistanceField:getCost(pos) end
+
+---@param pos Position | string
+---@return integer
+function DistanceField:getDistance(pos) end
+
+---@param pos Position | string
+---@return integer
+function DistanceField:getDirection(pos) end
+
+---@param pos Position | string
+---@return integer
+function DistanceField:getNextStep(pos) end
+
+---@param pos Position | string
+---@return integer[]
+function DistanceField:getPath(pos) end
+
+---@param positions Position[]
+---@return Position
+function DistanceField:getClosest(positions) end
+
 --------------------------------
 --------- AnimatedText ---------
 --------------------------------
@@ -3086,6 +3304,16 @@ function UIMap:setAntiAliasingMode(mode) end
 ---@param value integer
 function UIMap:setFloorFading(value) end
 
+---@param enable boolean
+function UIMap:setParallelFloorRecording(enable) end
+
+---@return boolean
+function UIMap:isParallelFloorRecording() end
+
+---@param z integer
+---@return integer
+function UIMap:getFloorRecordTime(z) end
+
 function UIMap:clearTiles() end
 
 --------------------------------
@@ -3667,6 +3895,64 @@ function g_dispatcher.scheduleEvent(callback, delay) end
 ---@return ScheduledEvent | nil
 function g_dispatcher.cycleEvent(callback, delay) end
 
+---@return integer
+function g_dispatcher.getQueuedTasks() end
+
+---@return integer
+function g_dispatcher.getContendedPushes() end
+
+---@return integer
+function g_dispatcher.getOverflowPushes() end
+
+---@return integer
+function g_dispatcher.getMaxQueueDepth() end
+
+function g_dispatcher.resetQueueStats() end
+
+--------------------------------
+------------- g_gc -------------
+--------------------------------
+
+---@class g_gc
+g_gc = {}
+
+function g_gc.collectLua() end
+
+---@param enabled boolean
+function g_gc.setLuaIncremental(enabled) end
+
+---@return boolean
+function g_gc.isLuaIncremental() end
+
+---@param budget integer micros per frame
+function g_gc.setLuaStepBudget(budget) end
+
+---@return integer
+function g_gc.getLuaStepBudget() end
+
+---@return integer kbytes
+function g_gc.getLuaHeapSize() end
+
+---@return integer kbytes
+function g_gc.getLuaStepSize() end
+
+---@return integer micros
+function g_gc.getLuaLastPause() end
+
+---@return integer micros
+function g_gc.getLuaMaxPause() end
+
+---@return integer micros
+function g_gc.getLuaTotalPause() end
+
+---@return integer
+function g_gc.getLuaCycles() end
+
+---@return integer kbytes
+function g_gc.getLuaLastFreed() end
+
+function g_gc.resetLuaStats() end
+
 --------------------------------
 --------- g_resources ----------
 --------------------------------
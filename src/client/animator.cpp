@@ -76,8 +76,42 @@ void Animator::serialize(const FileStreamPtr& fin) const
     }
 }
 
+void Animator::unserializeSnapshot(const FileStreamPtr& fin)
+{
+    m_animationPhases = fin->getU16();
+    m_async = fin->getU8() == 1;
+    m_loopCount = fin->get8();
+    m_startPhase = fin->get8();
+    m_minDuration = fin->getU16();
+
+    m_phaseDurations.reserve(m_animationPhases);
+    for (int i = 0; i < m_animationPhases; ++i) {
+        const uint16_t minimum = fin->getU16();
+        const uint16_t maximum = fin->getU16();
+        m_phaseDurations.emplace_back(minimum, maximum);
+    }
+
+    m_phase = getStartPhase();
+}
+
+void Animator::serializeSnapshot(const FileStreamPtr& fin) const
+{
+    fin->addU16(m_animationPhases);
+    fin->addU8(m_async ? 1 : 0);
+    fin->add8(m_loopCount);
+    fin->add8(m_startPhase);
+    fin->addU16(m_minDuration);
+
+    for (const auto& [min, max] : m_phaseDurations) {
+        fin->addU16(min);
+        fin->addU16(max);
+    }
+}
+
 void Animator::setPhase(const int phase)
 {
+    SpinLock::Guard guard(m_lock);
+
     if (m_phase == phase)
         return;
 
@@ -103,6 +137,8 @@ void Animator::setPhase(const int phase)
 
 int Animator::getPhase()
 {
+    SpinLock::Guard guard(m_lock);
+
     const ticks_t ticks = g_clock.millis();
     if (ticks != m_lastPhaseTicks && !m_isComplete) {
         const int elapsedTicks = static_cast<int>(ticks - m_lastPhaseTicks);
@@ -160,9 +196,12 @@ int Animator::getStartPhase() const
 
 void Animator::resetAnimation()
 {
-    m_isComplete = false;
-    m_currentDirection = AnimDirForward;
-    m_currentLoop = 0;
+    {
+        SpinLock::Guard guard(m_lock);
+        m_isComplete = false;
+        m_currentDirection = AnimDirForward;
+        m_currentLoop = 0;
+    }
     setPhase(AnimPhaseAutomatic);
 }
 
@@ -24,6 +24,7 @@
 
 #include <framework/core/declarations.h>
 #include <framework/core/timer.h>
+#include <framework/util/spinlock.h>
 
 #include <appearances.pb.h>
 
@@ -48,6 +49,8 @@ public:
     void unserializeAppearance(const appearances::SpriteAnimation& animation);
     void unserialize(int animationPhases, const FileStreamPtr& fin);
     void serialize(const FileStreamPtr& fin) const;
+    void unserializeSnapshot(const FileStreamPtr& fin);
+    void serializeSnapshot(const FileStreamPtr& fin) const;
     void setPhase(int phase);
     void resetAnimation();
 
@@ -87,4 +90,7 @@ private:
     std::vector<std::pair<uint16_t, uint16_t>> m_phaseDurations;
     AnimationDirection m_currentDirection{ AnimDirForward };
     ticks_t m_lastPhaseTicks{ 0 };
+
+    // the animator is shared by every thing of the type, which may be drawn from several threads
+    SpinLock m_lock;
 };
@@ -29,8 +29,10 @@
 #include "minimap.h"
 #include "spriteappearances.h"
 #include "spritemanager.h"
+#include "spriteprefetcher.h"
 #include "thingtypemanager.h"
 #include "uimap.h"
+#include "walkticker.h"
 #include "framework/core/eventdispatcher.h"
 #include "framework/graphics/drawpoolmanager.h"
 #include "framework/graphics/shadermanager.h"
@@ -53,6 +55,7 @@ void Client::init(std::vector<std::string>& /*args*/)
     g_shaders.init();
     g_sprites.init();
     g_spriteAppearances.init();
+    g_spritePrefetcher.init();
     g_things.init();
 }
 
@@ -64,8 +67,10 @@ void Client::terminate()
     g_creatures.terminate();
 #endif
     g_game.terminate();
+    g_walkTicker.terminate();
     g_map.terminate();
     g_minimap.terminate();
+    g_spritePrefetcher.terminate();
     g_things.terminate();
     g_sprites.terminate();
     g_spriteAppearances.terminate();
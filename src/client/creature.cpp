@@ -36,6 +36,7 @@
 #include "thingtype.h"
 #include "thingtypemanager.h"
 #include "tile.h"
+#include "walkticker.h"
 #include "framework/core/clock.h"
 #include "framework/core/eventdispatcher.h"
 #include "framework/core/scheduledevent.h"
@@ -692,9 +693,11 @@ void Creature::updateWalkingTile()
 
 void Creature::nextWalkUpdate()
 {
-    // remove any previous scheduled walk updates
-    if (m_walkUpdateEvent)
+    // the walk replaces any static walking animation
+    if (m_walkUpdateEvent) {
         m_walkUpdateEvent->cancel();
+        m_walkUpdateEvent = nullptr;
+    }
 
     // do the update
     updateWalk();
@@ -702,12 +705,8 @@ void Creature::nextWalkUpdate()
 
     if (!m_walking) return;
 
-    auto action = [self = static_self_cast<Creature>()] {
-        self->m_walkUpdateEvent = nullptr;
-        self->nextWalkUpdate();
-    };
-
-    m_walkUpdateEvent = isCameraFollowing() ? g_dispatcher.addEvent(action) : g_dispatcher.scheduleEvent(action, m_stepCache.walkDuration);
+    // the ticker runs the next update
+    g_walkTicker.add(static_self_cast<Creature>());
 }
 
 void Creature::updateWalk()
@@ -737,6 +736,7 @@ void Creature::updateWalk()
 void Creature::terminateWalk()
 {
     // remove any scheduled walk update
+    g_walkTicker.remove(static_self_cast<Creature>());
     if (m_walkUpdateEvent) {
         m_walkUpdateEvent->cancel();
         m_walkUpdateEvent = nullptr;
@@ -313,6 +313,9 @@ private:
     uint32_t m_id{ 0 };
     uint32_t m_masterId{ 0 };
 
+    // position in the walk ticker, UINT32_MAX when not walking
+    uint32_t m_walkTickerIndex{ UINT32_MAX };
+
     uint16_t m_calculatedStepSpeed{ 0 };
     uint16_t m_speed{ 0 };
     uint16_t m_baseSpeed{ 0 };
@@ -356,6 +359,8 @@ private:
     StaticTextPtr m_text;
 
     uint8_t m_vocation{ 0 };
+
+    friend class WalkTicker;
 };
 
 // @bindclass
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "creatureindex.h"
+#include "tile.h"
+
+void CreatureIndex::add(const TilePtr& tile)
+{
+    const auto& pos = tile->getPosition();
+    if (pos.z >= m_floors.size())
+        m_floors.resize(pos.z + 1);
+
+    auto& bucket = m_floors[pos.z][getBucketKey(pos.x, pos.y)];
+    if (std::ranges::find(bucket, tile) != bucket.end())
+        return;
+
+    bucket.emplace_back(tile);
+    ++m_size;
+}
+
+void CreatureIndex::remove(const TilePtr& tile)
+{
+    const auto& pos = tile->getPosition();
+    if (pos.z >= m_floors.size())
+        return;
+
+    auto& buckets = m_floors[pos.z];
+    const auto bucketIt = buckets.find(getBucketKey(pos.x, pos.y));
+    if (bucketIt == buckets.end())
+        return;
+
+    auto& bucket = bucketIt->second;
+    const auto it = std::ranges::find(bucket, tile);
+    if (it == bucket.end())
+        return;
+
+    // order inside a bucket doesn't matter, collect sorts the result
+    *it = std::move(bucket.back());
+    bucket.pop_back();
+    --m_size;
+
+    if (bucket.empty())
+        buckets.erase(bucketIt);
+}
+
+void CreatureIndex::clear()
+{
+    m_floors.clear();
+    m_size = 0;
+}
+
+void CreatureIndex::collect(const uint8_t z, const int32_t startX, const int32_t startY, const int32_t endX, const int32_t endY, std::vector<Tile*>& out) const
+{
+    if (z >= m_floors.size() || startX > endX || startY > endY)
+        return;
+
+    const auto& buckets = m_floors[z];
+    if (buckets.empty())
+        return;
+
+    const auto first = out.size();
+
+    const auto appendBucket = [&](const std::vector<TilePtr>& bucket) {
+        for (const auto& tile : bucket) {
+            const auto& pos = tile->getPosition();
+            if (pos.x >= startX && pos.x <= endX && pos.y >= startY && pos.y <= endY)
+                out.emplace_back(tile.get());
+        }
+    };
+
+    const int32_t firstBucketX = std::max(startX, 0) / BUCKET_SIZE;
+    const int32_t firstBucketY = std::max(startY, 0) / BUCKET_SIZE;
+    const int32_t lastBucketX = std::max(endX, 0) / BUCKET_SIZE;
+    const int32_t lastBucketY = std::max(endY, 0) / BUCKET_SIZE;
+
+    // huge areas are cheaper to filter from the occupied buckets
+    const auto areaBuckets = static_cast<size_t>(lastBucketX - firstBucketX + 1) * (lastBucketY - firstBucketY + 1);
+    if (areaBuckets > buckets.size()) {
+        for (const auto& [key, bucket] : buckets)
+            appendBucket(bucket);
+    } else {
+        for (int32_t by = firstBucketY; by <= lastBucketY; ++by) {
+            for (int32_t bx = firstBucketX; bx <= lastBucketX; ++bx) {
+                if (const auto it = buckets.find((static_cast<uint32_t>(by) << 16) | static_cast<uint32_t>(bx)); it != buckets.end())
+                    appendBucket(it->second);
+            }
+        }
+    }
+
+    std::sort(out.begin() + first, out.end(), [](Tile* a, Tile* b) {
+        const auto& posA = a->getPosition();
+        const auto& posB = b->getPosition();
+        return posA.y < posB.y || (posA.y == posB.y && posA.x < posB.x);
+    });
+}
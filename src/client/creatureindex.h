@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "declarations.h"
+
+// Tiles that hold creatures, bucketed per floor by map block. Tiles register
+// themselves when their first creature arrives and leave with the last one,
+// so spectator queries only visit occupied tiles instead of every position in range.
+class CreatureIndex
+{
+public:
+    void add(const TilePtr& tile);
+    void remove(const TilePtr& tile);
+    void clear();
+
+    // appends the tiles with creatures inside the area, ordered by y and then by x
+    void collect(uint8_t z, int32_t startX, int32_t startY, int32_t endX, int32_t endY, std::vector<Tile*>& out) const;
+
+    size_t size() const { return m_size; }
+
+private:
+    static constexpr int32_t BUCKET_SIZE = 32;
+
+    static uint32_t getBucketKey(const int32_t x, const int32_t y) { return (static_cast<uint32_t>(y / BUCKET_SIZE) << 16) | static_cast<uint32_t>(x / BUCKET_SIZE); }
+
+    std::vector<stdext::map<uint32_t, std::vector<TilePtr>>> m_floors;
+    size_t m_size{ 0 };
+};
@@ -56,8 +56,12 @@ class Animator;
 class ThingType;
 class ItemType;
 class TileBlock;
+class CreatureIndex;
 class AttachedEffect;
 class AttachableObject;
+class PathPlanner;
+class DistanceField;
+class WalkSnapshot;
 
 #ifdef FRAMEWORK_EDITOR
 class House;
@@ -85,6 +89,10 @@ using ThingTypePtr = std::shared_ptr<ThingType>;
 using ItemTypePtr = std::shared_ptr<ItemType>;
 using AttachedEffectPtr = std::shared_ptr<AttachedEffect>;
 using AttachableObjectPtr = std::shared_ptr<AttachableObject>;
+using PathPlannerPtr = std::shared_ptr<PathPlanner>;
+using DistanceFieldPtr = std::shared_ptr<DistanceField>;
+using WalkSnapshotPtr = std::shared_ptr<WalkSnapshot>;
+using WalkSnapshotConstPtr = std::shared_ptr<const WalkSnapshot>;
 
 #ifdef FRAMEWORK_EDITOR
 using HousePtr = std::shared_ptr<House>;
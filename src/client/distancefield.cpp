@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "distancefield.h"
+
+namespace
+{
+    // min-heap on cost
+    constexpr auto queueCompare = [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) { return a.first > b.first; };
+}
+
+void DistanceField::compute(const Position& start, const int maxDistance)
+{
+    const int32_t radius = std::clamp(maxDistance, 1, MAX_RADIUS);
+
+    m_start = start;
+    m_maxDistance = radius;
+    m_side = static_cast<uint32_t>(radius) * 2 + 1;
+    m_originX = start.x - radius;
+    m_originY = start.y - radius;
+
+    const size_t size = static_cast<size_t>(m_side) * m_side;
+    if (m_nodes.size() < size)
+        m_nodes.resize(size, Node{ .generation = 0 });
+
+    if (++m_generation == 0) {
+        for (auto& node : m_nodes)
+            node.generation = 0;
+        m_generation = 1;
+    }
+
+    m_queue.clear();
+
+    const uint32_t startIndex = static_cast<uint32_t>(radius) * m_side + radius;
+    m_nodes[startIndex] = { .generation = m_generation, .cost = 0, .speed = 100, .distance = 0, .dir = Otc::InvalidDirection, .firstDir = Otc::InvalidDirection, .flags = NodeReached };
+    m_queue.emplace_back(0.f, startIndex);
+
+    while (!m_queue.empty()) {
+        std::ranges::pop_heap(m_queue, queueCompare);
+        const auto [cost, index] = m_queue.back();
+        m_queue.pop_back();
+
+        auto& current = m_nodes[index];
+        if ((current.flags & NodeClosed) || cost > current.cost)
+            continue;
+        current.flags |= NodeClosed;
+
+        if (current.distance >= radius)
+            continue;
+
+        const int32_t x = m_originX + static_cast<int32_t>(index % m_side);
+        const int32_t y = m_originY + static_cast<int32_t>(index / m_side);
+
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                const int32_t nx = x + i;
+                const int32_t ny = y + j;
+                if (nx < 0 || ny < 0)
+                    continue;
+
+                // distance is bounded by the radius, so neighbors are always inside the window
+                const uint32_t neighborIndex = static_cast<uint32_t>(ny - m_originY) * m_side + static_cast<uint32_t>(nx - m_originX);
+                auto& neighbor = touchNode(neighborIndex, Position(nx, ny, start.z));
+                if (neighbor.flags & (NodeClosed | NodeBlocked))
+                    continue;
+
+                const auto walkDir = PathFinder::getStepDirection(i, j);
+                const float walkFactor = PathFinder::getStepFactor(walkDir);
+                const float neighborCost = cost + (neighbor.speed * walkFactor) / 100.0f;
+
+                if ((neighbor.flags & NodeReached) && neighbor.cost <= neighborCost)
+                    continue;
+
+                neighbor.flags |= NodeReached;
+                neighbor.cost = neighborCost;
+                neighbor.distance = current.distance + 1;
+                neighbor.dir = walkDir;
+                neighbor.firstDir = index == startIndex ? walkDir : current.firstDir;
+
+                // goal only tiles get a cost but are never expanded
+                if (!(neighbor.flags & NodeGoalOnly)) {
+                    m_queue.emplace_back(neighborCost, neighborIndex);
+                    std::ranges::push_heap(m_queue, queueCompare);
+                }
+            }
+        }
+    }
+}
+
+DistanceField::Node& DistanceField::touchNode(const uint32_t index, const Position& pos)
+{
+    Node& node = m_nodes[index];
+    if (node.generation == m_generation)
+        return node;
+
+    const auto& cell = m_sampler(pos);
+
+    node.generation = m_generation;
+    node.flags = 0;
+    node.speed = cell.speed;
+
+    // same rules as PathFinder::find, where every tile may be the goal
+    if (cell.flags & PathFinder::CellNotWalkable)
+        node.flags |= NodeNotGoal;
+
+    const bool wasSeen = cell.flags & PathFinder::CellWasSeen;
+    if (!(m_flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+        node.flags |= NodeBlocked;
+    else if (wasSeen) {
+        if (!(m_flags & Otc::PathFindAllowNonWalkable) && (cell.flags & PathFinder::CellNotWalkable))
+            node.flags |= NodeBlocked;
+        else if ((!(m_flags & Otc::PathFindAllowCreatures) && (cell.flags & PathFinder::CellHasCreature))
+                 || (!(m_flags & Otc::PathFindAllowNonPathable) && (cell.flags & PathFinder::CellNotPathable)))
+            node.flags |= NodeGoalOnly;
+    }
+
+    return node;
+}
+
+const DistanceField::Node* DistanceField::getReachedNode(const Position& pos) const
+{
+    if (m_generation == 0 || pos.z != m_start.z)
+        return nullptr;
+
+    const auto localX = static_cast<uint32_t>(pos.x - m_originX);
+    const auto localY = static_cast<uint32_t>(pos.y - m_originY);
+    if (localX >= m_side || localY >= m_side)
+        return nullptr;
+
+    const Node& node = m_nodes[localY * m_side + localX];
+    return node.generation == m_generation && (node.flags & NodeReached) ? &node : nullptr;
+}
+
+const DistanceField::Node* DistanceField::getNode(const Position& pos) const
+{
+    const auto* node = getReachedNode(pos);
+    return node && !(node->flags & NodeNotGoal) ? node : nullptr;
+}
+
+float DistanceField::getCost(const Position& pos) const
+{
+    const auto* node = getNode(pos);
+    return node ? node->cost : -1;
+}
+
+int DistanceField::getDistance(const Position& pos) const
+{
+    const auto* node = getNode(pos);
+    return node ? node->distance : -1;
+}
+
+Otc::Direction DistanceField::getDirection(const Position& pos) const
+{
+    const auto* node = getNode(pos);
+    return node ? static_cast<Otc::Direction>(node->dir) : Otc::InvalidDirection;
+}
+
+Otc::Direction DistanceField::getNextStep(const Position& pos) const
+{
+    const auto* node = getNode(pos);
+    return node ? static_cast<Otc::Direction>(node->firstDir) : Otc::InvalidDirection;
+}
+
+std::vector<Otc::Direction> DistanceField::getPath(const Position& pos) const
+{
+    std::vector<Otc::Direction> dirs;
+
+    const auto* node = getNode(pos);
+    if (!node)
+        return dirs;
+
+    dirs.reserve(node->distance);
+
+    Position current = pos;
+    while (node && node->dir != Otc::InvalidDirection) {
+        const auto dir = static_cast<Otc::Direction>(node->dir);
+        const auto& [dx, dy] = PathFinder::getStepOffset(dir);
+        dirs.push_back(dir);
+        current.translate(-dx, -dy);
+        node = getReachedNode(current);
+    }
+
+    std::ranges::reverse(dirs);
+    return dirs;
+}
+
+Position DistanceField::getClosest(const std::vector<Position>& positions) const
+{
+    Position closest;
+    float closestCost = std::numeric_limits<float>::max();
+    for (const auto& pos : positions) {
+        if (const auto* node = getNode(pos); node && node->cost < closestCost) {
+            closestCost = node->cost;
+            closest = pos;
+        }
+    }
+    return closest;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+#include "pathfinder.h"
+#include <framework/luaengine/luaobject.h>
+
+// Walking cost from one position to every tile around it, computed in a single
+// dijkstra pass over a dense window. The window is kept between computations,
+// so querying hundreds of targets costs one search and a lookup per target.
+// Tiles that can only be a goal (creatures, non pathable) get a cost but are not walked through.
+ // @bindclass
+class DistanceField final : public LuaObject
+{
+public:
+    DistanceField(int flags, PathFinder::CellSampler sampler) : m_sampler(std::move(sampler)), m_flags(flags) {}
+
+    void compute(const Position& start, int maxDistance);
+
+    Position getStart() const { return m_start; }
+    int getFlags() const { return m_flags; }
+    int getMaxDistance() const { return m_maxDistance; }
+
+    bool isReachable(const Position& pos) const { return getNode(pos) != nullptr; }
+
+    // -1 when the position can't be reached
+    float getCost(const Position& pos) const;
+    int getDistance(const Position& pos) const;
+
+    // direction of the last step into pos
+    Otc::Direction getDirection(const Position& pos) const;
+    // direction of the first step from the start towards pos
+    Otc::Direction getNextStep(const Position& pos) const;
+    std::vector<Otc::Direction> getPath(const Position& pos) const;
+
+    // cheapest reachable position of the list, an invalid position when none is reachable
+    Position getClosest(const std::vector<Position>& positions) const;
+
+    // max distance (in tiles) from the start that can be computed
+    static constexpr int32_t MAX_RADIUS = 128;
+
+private:
+    enum NodeState : uint8_t
+    {
+        NodeReached = 1 << 0,
+        NodeClosed = 1 << 1,
+        NodeGoalOnly = 1 << 2,
+        NodeBlocked = 1 << 3,
+        NodeNotGoal = 1 << 4
+    };
+
+    struct Node
+    {
+        uint32_t generation;
+        float cost;
+        uint16_t speed;
+        uint16_t distance;
+        uint8_t dir;
+        uint8_t firstDir;
+        uint8_t flags; // NodeState
+    };
+
+    Node& touchNode(uint32_t index, const Position& pos);
+    const Node* getReachedNode(const Position& pos) const;
+    // reached nodes that can be the end of a path
+    const Node* getNode(const Position& pos) const;
+
+    PathFinder::CellSampler m_sampler;
+
+    std::vector<Node> m_nodes;
+    std::vector<std::pair<float, uint32_t>> m_queue;
+
+    Position m_start;
+
+    int m_flags{ 0 };
+    int m_maxDistance{ 0 };
+
+    uint32_t m_generation{ 0 };
+    uint32_t m_side{ 0 };
+
+    int32_t m_originX{ 0 };
+    int32_t m_originY{ 0 };
+};
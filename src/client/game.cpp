@@ -30,6 +30,7 @@
 #include "map.h"
 #include "protocolgame.h"
 #include "protocolcodes.h"
+#include "protocolreplay.h"
 #include "thingtype.h"
 #include "thingtypemanager.h"
 #include "tile.h"
@@ -631,6 +632,34 @@ void Game::playRecord(const std::string_view& file)
     m_worldName = "Record";
 }
 
+std::string Game::benchmarkRecord(const std::string& file)
+{
+    if (m_protocolGame || isOnline())
+        throw Exception("Unable to benchmark a record while already online or logging.");
+
+    if (m_protocolVersion == 0)
+        throw Exception("Must set a valid game protocol version before benchmarking.");
+
+    resetGameStates();
+
+    m_localPlayer = std::make_shared<LocalPlayer>();
+    m_localPlayer->setName("Player");
+    m_characterName = "Player";
+    m_worldName = "Record";
+
+    m_protocolGame = std::make_shared<ProtocolGame>();
+
+    ProtocolReplay replay;
+    const bool loaded = replay.run(m_protocolGame, file);
+
+    processDisconnect();
+
+    if (!loaded)
+        throw Exception("Unable to load record '{}'.", file);
+
+    return replay.getReport();
+}
+
 void Game::cancelLogin()
 {
     // send logout even if the game has not started yet, to make sure that the player doesn't stay logged there
@@ -162,6 +162,8 @@ public:
     // login related
     void loginWorld(std::string_view account, std::string_view password, std::string_view worldName, std::string_view worldHost, int worldPort, std::string_view characterName, std::string_view authenticatorToken, std::string_view sessionKey, const std::string_view& recordTo);
     void playRecord(const std::string_view& file);
+    // parses the whole record as fast as possible and returns the parser statistics, printing them is left to the caller
+    std::string benchmarkRecord(const std::string& file);
     void cancelLogin();
     void forceLogout();
     void safeLogout();
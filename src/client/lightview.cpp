@@ -26,6 +26,24 @@
 #include "framework/core/eventdispatcher.h"
 #include "framework/graphics/drawpoolmanager.h"
 #include "framework/graphics/painter.h"
+#include "framework/graphics/pixelkernels.h"
+
+namespace
+{
+    // Color::from8bit of every 8 bit color, as float channels
+    const std::array<std::array<float, 3>, 256>& getLightColors()
+    {
+        static const auto colors = [] {
+            std::array<std::array<float, 3>, 256> colors{};
+            for (int i = 0; i < 256; ++i) {
+                const auto& color = Color::from8bit(i);
+                colors[i] = { color.rF(), color.gF(), color.bF() };
+            }
+            return colors;
+        }();
+        return colors;
+    }
+}
 
 LightView::LightView(const Size& size) : m_pool(g_drawPool.get(DrawPoolType::LIGHT)) {
     g_mainDispatcher.addEvent([this, size] {
@@ -85,6 +103,11 @@ void LightView::resetShade(const Point& pos)
     const size_t index = (pos.y / m_tileSize) * m_mapSize.width() + (pos.x / m_tileSize);
     if (index >= m_lightData.tiles.size()) return;
     m_lightData.tiles[index] = m_lightData.lights.size();
+
+    // lights drawn before the shade no longer reach the tile
+    size_t hash = pos.hash();
+    stdext::hash_combine(hash, m_lightData.lights.size());
+    m_pool->getHashController().put(hash);
 }
 
 void LightView::draw(const Rect& dest, const Rect& src)
@@ -137,33 +160,59 @@ void LightView::updateCoords(const Rect& dest, const Rect& src) {
 
 void LightView::updatePixels()
 {
+    const auto& lightColors = getLightColors();
+
     const auto lightSize = m_lightData.lights.size();
-    const auto mapWidth = m_mapSize.width();
-    const auto mapHeight = m_mapSize.height();
+    const int mapWidth = m_mapSize.width();
+    const int mapHeight = m_mapSize.height();
+    const int tileSize = m_tileSize;
     const auto tileCenterOffset = m_tileSize / 2;
     const auto invTileSize = 1.0f / m_tileSize;
 
     auto* pixelData = m_pixels[0].data();
 
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            const auto centerX = x * m_tileSize + tileCenterOffset;
-            const auto centerY = y * m_tileSize + tileCenterOffset;
-            const auto index = y * mapWidth + x;
+    // every tile starts with the global light
+    const uint8_t globalColor[4] = { m_globalLightColor.r(), m_globalLightColor.g(), m_globalLightColor.b(), 255 };
+    for (int i = 0, s = mapWidth * mapHeight; i < s; ++i)
+        std::memcpy(pixelData + i * 4, globalColor, 4);
+
+    m_lightRow.resize(static_cast<size_t>(mapWidth) * 4);
 
-            auto r = m_globalLightColor.r();
-            auto g = m_globalLightColor.g();
-            auto b = m_globalLightColor.b();
+    // each light only visits the tiles its radius reaches, the row it lit is then merged with a max
+    for (size_t i = 0; i < lightSize; ++i) {
+        const auto& light = m_lightData.lights[i];
+        const auto& color = lightColors[light.color];
 
-            for (auto i = m_lightData.tiles[index]; i < lightSize; ++i) {
-                const auto& light = m_lightData.lights[i];
+        const int radius = light.intensity * tileSize;
+        const int radiusSq = radius * radius;
 
+        // one tile of margin, the distance test below is the exact one
+        const int minX = std::max<int>(0, (light.pos.x - radius) / tileSize - 1);
+        const int maxX = std::min<int>(mapWidth - 1, (light.pos.x + radius) / tileSize + 1);
+        const int minY = std::max<int>(0, (light.pos.y - radius) / tileSize - 1);
+        const int maxY = std::min<int>(mapHeight - 1, (light.pos.y + radius) / tileSize + 1);
+        if (minX > maxX || minY > maxY)
+            continue;
+
+        const int width = maxX - minX + 1;
+
+        for (int y = minY; y <= maxY; ++y) {
+            const auto centerY = y * tileSize + tileCenterOffset;
+            const auto dy = centerY - light.pos.y;
+
+            auto* row = m_lightRow.data();
+            std::memset(row, 0, static_cast<size_t>(width) * 4);
+
+            bool lit = false;
+            for (int x = minX; x <= maxX; ++x) {
+                // the tile was shaded after this light was added
+                if (m_lightData.tiles[y * mapWidth + x] > i)
+                    continue;
+
+                const auto centerX = x * tileSize + tileCenterOffset;
                 const auto dx = centerX - light.pos.x;
-                const auto dy = centerY - light.pos.y;
                 const auto distanceSq = dx * dx + dy * dy;
-
-                const auto lightRadiusSq = (light.intensity * m_tileSize) * (light.intensity * m_tileSize);
-                if (distanceSq > lightRadiusSq) continue;
+                if (distanceSq > radiusSq) continue;
 
                 const auto distanceNorm = std::sqrt(distanceSq) * invTileSize;
                 float intensity = (-distanceNorm + light.intensity) * 0.2f;
@@ -171,19 +220,15 @@ void LightView::updatePixels()
 
                 intensity = std::min<float>(intensity, 1.0f);
 
-                const auto& lightColor = Color::from8bit(light.color) * intensity;
-
-                r = std::max<int>(r, lightColor.r());
-                g = std::max<int>(g, lightColor.g());
-                b = std::max<int>(b, lightColor.b());
+                auto* pixel = row + (x - minX) * 4;
+                pixel[0] = static_cast<uint8_t>(color[0] * intensity * 255.f);
+                pixel[1] = static_cast<uint8_t>(color[1] * intensity * 255.f);
+                pixel[2] = static_cast<uint8_t>(color[2] * intensity * 255.f);
+                lit = true;
             }
 
-            const auto colorIndex = index * 4;
-
-            pixelData[colorIndex] = r;
-            pixelData[colorIndex + 1] = g;
-            pixelData[colorIndex + 2] = b;
-            pixelData[colorIndex + 3] = 255;
+            if (lit)
+                Pixels::maxPixels(pixelData + (y * mapWidth + minX) * 4, row, width);
         }
     }
-}
\ No newline at end of file
+}
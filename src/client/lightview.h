@@ -84,4 +84,5 @@ private:
     TexturePtr m_texture;
     LightData m_lightData;
     std::array<std::vector<uint8_t>, 2> m_pixels;
+    std::vector<uint8_t> m_lightRow;
 };
@@ -26,6 +26,7 @@
 #include "game.h"
 #include "item.h"
 #include "map.h"
+#include "spriteprefetcher.h"
 #include "tile.h"
 #include "framework/core/clock.h"
 #include "framework/core/eventdispatcher.h"
@@ -86,6 +87,9 @@ void LocalPlayer::preWalk(Otc::Direction direction)
     Creature::walk(oldPos, m_preWalks.emplace_back(oldPos.translatedToDirection(direction)));
     Creature::onPositionChange(getLastStepToPosition(), getLastStepFromPosition());
     registerAdjustInvalidPosEvent();
+
+    // the server hasn't confirmed the step yet, but the ring ahead is already known
+    g_spritePrefetcher.prefetch(m_preWalks.back(), direction);
 }
 
 void LocalPlayer::onWalking() {
@@ -26,6 +26,7 @@
 #include "client.h"
 #include "container.h"
 #include "creature.h"
+#include "distancefield.h"
 #include "effect.h"
 #include "game.h"
 #include "gameconfig.h"
@@ -36,10 +37,12 @@
 #include "minimap.h"
 #include "missile.h"
 #include "outfit.h"
+#include "pathplanner.h"
 #include "player.h"
 #include "protocolgame.h"
 #include "spriteappearances.h"
 #include "spritemanager.h"
+#include "spriteprefetcher.h"
 #include "statictext.h"
 #include "thingtypemanager.h"
 #include "tile.h"
@@ -48,6 +51,7 @@
 #include "uieffect.h"
 #include "uiitem.h"
 #include "uimissile.h"
+#include "walkticker.h"
 #include <framework/graphics/paintershaderprogram.h>
 #include "attachableobject.h"
 #include "thingtype.h"
@@ -82,6 +86,7 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_things", "findThingTypeByAttr", &ThingTypeManager::findThingTypeByAttr, &g_things);
     g_lua.bindSingletonFunction("g_things", "getRaceData", &ThingTypeManager::getRaceData, &g_things);
     g_lua.bindSingletonFunction("g_things", "getRacesByName", &ThingTypeManager::getRacesByName, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getTextureMemoryUsage", &ThingTypeManager::getTextureMemoryUsage, &g_things);
 
 #ifdef FRAMEWORK_EDITOR
     g_lua.bindSingletonFunction("g_things", "getItemType", &ThingTypeManager::getItemType, &g_things);
@@ -131,6 +136,36 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_spriteAppearances");
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSpriteToFile", &SpriteAppearances::saveSpriteToFile, &g_spriteAppearances);
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSheetToFileBySprite", &SpriteAppearances::saveSheetToFileBySprite, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "setCacheLimit", &SpriteAppearances::setCacheLimit, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheLimit", &SpriteAppearances::getCacheLimit, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheUsage", &SpriteAppearances::getCacheUsage, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheHits", &SpriteAppearances::getCacheHits, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheMisses", &SpriteAppearances::getCacheMisses, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheEvictions", &SpriteAppearances::getCacheEvictions, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "resetCacheStats", &SpriteAppearances::resetCacheStats, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "setDiskCacheLimit", &SpriteAppearances::setDiskCacheLimit, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getDiskCacheLimit", &SpriteAppearances::getDiskCacheLimit, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getDiskCacheUsage", &SpriteAppearances::getDiskCacheUsage, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getDiskCacheHits", &SpriteAppearances::getDiskCacheHits, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getDiskCacheMisses", &SpriteAppearances::getDiskCacheMisses, &g_spriteAppearances);
+
+    g_lua.registerSingletonClass("g_spritePrefetcher");
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "setEnabled", &SpritePrefetcher::setEnabled, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "isEnabled", &SpritePrefetcher::isEnabled, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "setMaxConcurrency", &SpritePrefetcher::setMaxConcurrency, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "getMaxConcurrency", &SpritePrefetcher::getMaxConcurrency, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "getVisibleWaits", &SpritePrefetcher::getVisibleWaits, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "getPrefetchPromotions", &SpritePrefetcher::getPrefetchPromotions, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "getPrefetched", &SpritePrefetcher::getPrefetched, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "getPending", &SpritePrefetcher::getPending, &g_spritePrefetcher);
+    g_lua.bindSingletonFunction("g_spritePrefetcher", "resetStats", &SpritePrefetcher::resetStats, &g_spritePrefetcher);
+
+    g_lua.registerSingletonClass("g_walkTicker");
+    g_lua.bindSingletonFunction("g_walkTicker", "getActiveWalkers", &WalkTicker::getActiveWalkers, &g_walkTicker);
+    g_lua.bindSingletonFunction("g_walkTicker", "getUpdates", &WalkTicker::getUpdates, &g_walkTicker);
+    g_lua.bindSingletonFunction("g_walkTicker", "getLastTickTime", &WalkTicker::getLastTickTime, &g_walkTicker);
+    g_lua.bindSingletonFunction("g_walkTicker", "getMaxTickTime", &WalkTicker::getMaxTickTime, &g_walkTicker);
+    g_lua.bindSingletonFunction("g_walkTicker", "resetStats", &WalkTicker::resetStats, &g_walkTicker);
 
     g_lua.registerSingletonClass("g_map");
     g_lua.bindSingletonFunction("g_map", "isLookPossible", &Map::isLookPossible, &g_map);
@@ -155,6 +190,8 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_map", "getSpectatorsInRange", &Map::getSpectatorsInRange, &g_map);
     g_lua.bindSingletonFunction("g_map", "getSpectatorsInRangeEx", &Map::getSpectatorsInRangeEx, &g_map);
     g_lua.bindSingletonFunction("g_map", "findPath", &Map::findPath, &g_map);
+    g_lua.bindSingletonFunction("g_map", "createPathPlanner", &Map::createPathPlanner, &g_map);
+    g_lua.bindSingletonFunction("g_map", "createDistanceField", &Map::createDistanceField, &g_map);
     g_lua.bindSingletonFunction("g_map", "createTile", &Map::createTile, &g_map);
     g_lua.bindSingletonFunction("g_map", "setWidth", &Map::setWidth, &g_map);
     g_lua.bindSingletonFunction("g_map", "setHeight", &Map::setHeight, &g_map);
@@ -203,6 +240,9 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_minimap", "saveImage", &Minimap::saveImage, &g_minimap);
     g_lua.bindSingletonFunction("g_minimap", "loadOtmm", &Minimap::loadOtmm, &g_minimap);
     g_lua.bindSingletonFunction("g_minimap", "saveOtmm", &Minimap::saveOtmm, &g_minimap);
+    g_lua.bindSingletonFunction("g_minimap", "saveOtmmAsync", &Minimap::saveOtmmAsync, &g_minimap);
+    g_lua.bindSingletonFunction("g_minimap", "setMemoryLimit", &Minimap::setMemoryLimit, &g_minimap);
+    g_lua.bindSingletonFunction("g_minimap", "getMemoryLimit", &Minimap::getMemoryLimit, &g_minimap);
 
 #ifdef FRAMEWORK_EDITOR
     g_lua.registerSingletonClass("g_creatures");
@@ -228,6 +268,7 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_game");
     g_lua.bindSingletonFunction("g_game", "loginWorld", &Game::loginWorld, &g_game);
     g_lua.bindSingletonFunction("g_game", "playRecord", &Game::playRecord, &g_game);
+    g_lua.bindSingletonFunction("g_game", "benchmarkRecord", &Game::benchmarkRecord, &g_game);
     g_lua.bindSingletonFunction("g_game", "cancelLogin", &Game::cancelLogin, &g_game);
     g_lua.bindSingletonFunction("g_game", "forceLogout", &Game::forceLogout, &g_game);
     g_lua.bindSingletonFunction("g_game", "safeLogout", &Game::safeLogout, &g_game);
@@ -432,6 +473,11 @@ void Client::registerLuaFunctions()
     g_lua.registerClass<ProtocolGame, Protocol>();
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return std::make_shared<ProtocolGame>(); });
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setLuaOpcode", &ProtocolGame::setLuaOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isLuaOpcode", &ProtocolGame::isLuaOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getLuaOpcodeCalls", &ProtocolGame::getLuaOpcodeCalls);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getAvoidedLuaOpcodeCalls", &ProtocolGame::getAvoidedLuaOpcodeCalls);
+    g_lua.bindClassStaticFunction<ProtocolGame>("resetLuaOpcodeCounters", &ProtocolGame::resetLuaOpcodeCounters);
 
     g_lua.registerClass<Container>();
     g_lua.bindClassMemberFunction<Container>("getItem", &Container::getItem);
@@ -729,6 +775,7 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<ThingType>("getName", &ThingType::getName);
     g_lua.bindClassMemberFunction<ThingType>("getDescription", &ThingType::getDescription);
     g_lua.bindClassMemberFunction<ThingType>("isAmmo", &ThingType::isAmmo);
+    g_lua.bindClassMemberFunction<ThingType>("getTextureMemoryUsage", &ThingType::getTextureMemoryUsage);
 #ifdef FRAMEWORK_EDITOR
     g_lua.bindClassMemberFunction<ThingType>("exportImage", &ThingType::exportImage);
 #endif
@@ -837,6 +884,31 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<StaticText>("setColor", &StaticText::setColor);
     g_lua.bindClassMemberFunction<StaticText>("getColor", &StaticText::getColor);
 
+    g_lua.registerClass<PathPlanner>();
+    g_lua.bindClassMemberFunction<PathPlanner>("setStart", &PathPlanner::setStart);
+    g_lua.bindClassMemberFunction<PathPlanner>("setGoal", &PathPlanner::setGoal);
+    g_lua.bindClassMemberFunction<PathPlanner>("setMaxComplexity", &PathPlanner::setMaxComplexity);
+    g_lua.bindClassMemberFunction<PathPlanner>("getStart", &PathPlanner::getStart);
+    g_lua.bindClassMemberFunction<PathPlanner>("getGoal", &PathPlanner::getGoal);
+    g_lua.bindClassMemberFunction<PathPlanner>("getFlags", &PathPlanner::getFlags);
+    g_lua.bindClassMemberFunction<PathPlanner>("getMaxComplexity", &PathPlanner::getMaxComplexity);
+    g_lua.bindClassMemberFunction<PathPlanner>("getLastComplexity", &PathPlanner::getLastComplexity);
+    g_lua.bindClassMemberFunction<PathPlanner>("getPath", &PathPlanner::getPath);
+    g_lua.bindClassMemberFunction<PathPlanner>("reset", &PathPlanner::reset);
+
+    g_lua.registerClass<DistanceField>();
+    g_lua.bindClassMemberFunction<DistanceField>("compute", &DistanceField::compute);
+    g_lua.bindClassMemberFunction<DistanceField>("getStart", &DistanceField::getStart);
+    g_lua.bindClassMemberFunction<DistanceField>("getFlags", &DistanceField::getFlags);
+    g_lua.bindClassMemberFunction<DistanceField>("getMaxDistance", &DistanceField::getMaxDistance);
+    g_lua.bindClassMemberFunction<DistanceField>("isReachable", &DistanceField::isReachable);
+    g_lua.bindClassMemberFunction<DistanceField>("getCost", &DistanceField::getCost);
+    g_lua.bindClassMemberFunction<DistanceField>("getDistance", &DistanceField::getDistance);
+    g_lua.bindClassMemberFunction<DistanceField>("getDirection", &DistanceField::getDirection);
+    g_lua.bindClassMemberFunction<DistanceField>("getNextStep", &DistanceField::getNextStep);
+    g_lua.bindClassMemberFunction<DistanceField>("getPath", &DistanceField::getPath);
+    g_lua.bindClassMemberFunction<DistanceField>("getClosest", &DistanceField::getClosest);
+
     g_lua.registerClass<AnimatedText>();
     g_lua.bindClassMemberFunction<AnimatedText>("getText", &AnimatedText::getText);
     g_lua.bindClassMemberFunction<AnimatedText>("getOffset", &AnimatedText::getOffset);
@@ -1082,6 +1154,9 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIMap>("setDrawHighlightTarget", &UIMap::setDrawHighlightTarget);
     g_lua.bindClassMemberFunction<UIMap>("setAntiAliasingMode", &UIMap::setAntiAliasingMode);
     g_lua.bindClassMemberFunction<UIMap>("setFloorFading", &UIMap::setFloorFading);
+    g_lua.bindClassMemberFunction<UIMap>("setParallelFloorRecording", &UIMap::setParallelFloorRecording);
+    g_lua.bindClassMemberFunction<UIMap>("isParallelFloorRecording", &UIMap::isParallelFloorRecording);
+    g_lua.bindClassMemberFunction<UIMap>("getFloorRecordTime", &UIMap::getFloorRecordTime);
     g_lua.bindClassMemberFunction<UIMap>("clearTiles", &UIMap::clearTiles);
 
     g_lua.registerClass<UIMinimap, UIWidget>();
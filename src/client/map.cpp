@@ -24,6 +24,7 @@
 
 #include "animatedtext.h"
 #include "creatures.h"
+#include "distancefield.h"
 #include "game.h"
 #include "gameconfig.h"
 #include "item.h"
@@ -31,8 +32,11 @@
 #include "mapview.h"
 #include "minimap.h"
 #include "missile.h"
+#include "pathplanner.h"
+#include "spriteprefetcher.h"
 #include "thing.h"
 #include "tile.h"
+#include "walksnapshot.h"
 
 #include <framework/core/asyncdispatcher.h>
 #include <framework/core/eventdispatcher.h>
@@ -42,7 +46,8 @@
 
 namespace
 {
-void cleanNewSpectators(std::vector<CreaturePtr>& creatures, std::unordered_set<uint32_t>& seenIds, const std::size_t startIndex)
+template<typename IdSet>
+void cleanNewSpectators(std::vector<CreaturePtr>& creatures, IdSet& seenIds, const std::size_t startIndex)
 {
     auto it = creatures.begin() + startIndex;
     while (it != creatures.end()) {
@@ -124,6 +129,20 @@ void Map::notificateTileUpdate(const Position& pos, const ThingPtr& thing, const
     if (thing && thing->isItem()) {
         g_minimap.updateTile(pos, getTile(pos));
     }
+
+    notificatePathPlanners(pos);
+    updateWalkSnapshot(pos);
+}
+
+void Map::notificatePathPlanners(const Position& pos)
+{
+    for (auto it = m_pathPlanners.begin(); it != m_pathPlanners.end();) {
+        if (const auto& planner = it->lock()) {
+            planner->onTileUpdate(pos);
+            ++it;
+        } else
+            it = m_pathPlanners.erase(it);
+    }
 }
 
 void Map::clean()
@@ -133,6 +152,14 @@ void Map::clean()
     for (auto i = -1; ++i <= g_gameConfig.getMapMaxZ();)
         m_floors[i].tileBlocks.clear();
 
+    m_creatureIndex.clear();
+
+    // tiles were dropped without notifications
+    for (const auto& weakPlanner : m_pathPlanners) {
+        if (const auto& planner = weakPlanner.lock())
+            planner->reset();
+    }
+
 #ifdef FRAMEWORK_EDITOR
     m_waypoints.clear();
     g_towns.clear();
@@ -173,6 +200,7 @@ void Map::cleanDynamicThings()
     }
 
     cleanTexts();
+    resetWalkSnapshots();
 
     g_lua.collectGarbage();
 }
@@ -361,8 +389,29 @@ StaticTextPtr Map::getStaticText(const Position& pos) const
     return nullptr;
 }
 
-const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].create(pos) : m_nulltile; }
-const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].getOrCreate(pos) : m_nulltile; }
+const TilePtr& Map::createTile(const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return m_nulltile;
+
+    auto& block = m_floors[pos.z].tileBlocks.getOrCreate(pos);
+    if (const auto& oldTile = block.get(pos))
+        m_creatureIndex.remove(oldTile);
+
+    const auto& tile = block.create(pos);
+    tile->setCreatureIndex(&m_creatureIndex);
+    return tile;
+}
+
+const TilePtr& Map::getOrCreateTile(const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return m_nulltile;
+
+    const auto& tile = m_floors[pos.z].tileBlocks.getOrCreate(pos).getOrCreate(pos);
+    tile->setCreatureIndex(&m_creatureIndex);
+    return tile;
+}
 
 template <typename... Items>
 const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
@@ -382,11 +431,8 @@ const TilePtr& Map::getTile(const Position& pos)
     if (!pos.isMapPosition())
         return m_nulltile;
 
-    auto& tileBlocks = m_floors[pos.z].tileBlocks;
-
-    const auto it = tileBlocks.find(getBlockIndex(pos));
-    if (it != tileBlocks.end())
-        return it->second.get(pos);
+    if (const auto block = m_floors[pos.z].tileBlocks.find(pos))
+        return block->get(pos);
 
     return m_nulltile;
 }
@@ -401,7 +447,7 @@ TileList Map::getTiles(const int8_t floor/* = -1*/)
         // Search all floors
         for (auto z = -1; ++z <= g_gameConfig.getMapMaxZ();) {
             for (const auto& [key, block] : m_floors[z].tileBlocks) {
-                for (const auto& tile : block.getTiles()) {
+                for (const auto& tile : block->getTiles()) {
                     if (tile != nullptr)
                         tiles.emplace_back(tile);
                 }
@@ -409,7 +455,7 @@ TileList Map::getTiles(const int8_t floor/* = -1*/)
         }
     } else {
         for (const auto& [key, block] : m_floors[floor].tileBlocks) {
-            for (const auto& tile : block.getTiles()) {
+            for (const auto& tile : block->getTiles()) {
                 if (tile != nullptr)
                     tiles.emplace_back(tile);
             }
@@ -424,17 +470,16 @@ void Map::cleanTile(const Position& pos)
     if (!pos.isMapPosition())
         return;
 
-    const auto it = m_floors[pos.z].tileBlocks.find(getBlockIndex(pos));
-    if (it != m_floors[pos.z].tileBlocks.end()) {
-        auto& block = it->second;
-        if (const auto& tile = block.get(pos)) {
+    if (const auto block = m_floors[pos.z].tileBlocks.find(pos)) {
+        if (const auto& tile = block->get(pos)) {
             tile->clean();
             if (tile->canErase())
-                block.remove(pos);
+                block->remove(pos);
 
             notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
         } else {
             g_minimap.updateTile(pos, nullptr);
+            notificatePathPlanners(pos);
         }
     }
 
@@ -511,7 +556,7 @@ stdext::map<Position, ItemPtr, Position::Hasher> Map::findItemsById(const uint16
     uint32_t  count = 0;
     for (uint8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
         for (const auto& [uid, block] : m_floors[z].tileBlocks) {
-            for (const auto& tile : block.getTiles()) {
+            for (const auto& tile : block->getTiles()) {
                 if (unlikely(!tile || tile->isEmpty()))
                     continue;
                 for (const auto& item : tile->getItems()) {
@@ -575,8 +620,8 @@ void Map::removeUnawareThings()
         // remove tiles that we are not aware anymore
         for (auto z = -1; ++z <= g_gameConfig.getMapMaxZ();) {
             auto& tileBlocks = m_floors[z].tileBlocks;
-            for (auto it = tileBlocks.begin(); it != tileBlocks.end();) {
-                auto& block = it->second;
+            for (size_t i = 0; i < tileBlocks.size();) {
+                auto& block = *tileBlocks[i].second;
                 bool blockEmpty = true;
                 for (const auto& tile : block.getTiles()) {
                     if (!tile) continue;
@@ -595,9 +640,9 @@ void Map::removeUnawareThings()
                 }
 
                 if (blockEmpty)
-                    it = tileBlocks.erase(it);
+                    tileBlocks.erase(i);
                 else
-                    ++it;
+                    ++i;
             }
         }
     }
@@ -608,8 +653,13 @@ void Map::setCentralPosition(const Position& centralPosition)
     if (m_centralPosition == centralPosition)
         return;
 
+    const auto direction = m_centralPosition.isValid() && m_centralPosition.z == centralPosition.z && m_centralPosition.isInRange(centralPosition, 1, 1)
+        ? m_centralPosition.getDirectionFromPosition(centralPosition) : Otc::InvalidDirection;
+
     m_centralPosition = centralPosition;
 
+    // the aware area moved, snapshots are built again on the next request
+    resetWalkSnapshots();
     removeUnawareThings();
 
     // this fixes local player position when the local player is removed from the map,
@@ -636,6 +686,13 @@ void Map::setCentralPosition(const Position& centralPosition)
         }
     });
 
+    // the tiles entering the aware range are parsed after the new center, so they are queued once the message is done
+    if (direction != Otc::InvalidDirection) {
+        g_dispatcher.addEvent([centralPosition, direction] {
+            g_spritePrefetcher.prefetch(centralPosition, direction);
+        });
+    }
+
     for (const auto& mapView : m_mapViews)
         mapView->onMapCenterChange(centralPosition, mapView->m_lastCameraPosition);
 }
@@ -651,8 +708,6 @@ std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos,
 {
     std::vector<CreaturePtr> creatures;
     creatures.reserve(m_knownCreatures.size());
-    std::unordered_set<uint32_t> seenIds;
-    seenIds.reserve(m_knownCreatures.size());
 
     uint8_t minZRange = 0;
     uint8_t maxZRange = 0;
@@ -669,23 +724,17 @@ std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos,
     const int startX = centerPos.x - minXRange;
     const int endX = centerPos.x + maxXRange;
 
-    const auto appendSpectatorsFromLayer = [&](const int z) {
-        for (int y = startY; y <= endY; ++y) {
-            for (int x = startX; x <= endX; ++x) {
-                const auto tile = getTile(Position(x, y, z));
-                if (!tile || !tile->hasCreatures()) {
-                    continue;
-                }
-
-                const auto sizeBeforeAppend = creatures.size();
-                tile->appendSpectators(creatures);
-                cleanNewSpectators(creatures, seenIds, sizeBeforeAppend);
-            }
-        }
-    };
-
+    // only tiles holding creatures are visited, in the same z, y, x order as a full scan
+    m_spectatorTiles.clear();
     for (int z = startZ; z <= endZ; ++z) {
-        appendSpectatorsFromLayer(z);
+        m_creatureIndex.collect(z, startX, startY, endX, endY, m_spectatorTiles);
+    }
+
+    m_spectatorIds.clear();
+    for (const auto* tile : m_spectatorTiles) {
+        const auto sizeBeforeAppend = creatures.size();
+        tile->appendSpectators(creatures);
+        cleanNewSpectators(creatures, m_spectatorIds, sizeBeforeAppend);
     }
     return creatures;
 }
@@ -799,6 +848,7 @@ bool Map::isAwareOfPosition(const Position& pos, const AwareRange& awareRange) c
 void Map::setAwareRange(const AwareRange& range)
 {
     m_awareRange = range;
+    resetWalkSnapshots();
     removeUnawareThings();
 }
 
@@ -829,177 +879,118 @@ uint8_t Map::getLastAwareFloor() const
 
 std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const Position& startPos, const Position& goalPos, const int maxComplexity, const int flags)
 {
-    // pathfinding using dijkstra search algorithm
+    const bool ignoreCreatures = flags & Otc::PathFindIgnoreCreatures;
 
-    struct SNode
-    {
-        SNode(const Position& pos) :
-            pos(pos) {}
-        float cost{ 0 };
-        float totalCost{ 0 };
-        Position pos;
-        SNode* prev{ nullptr };
-        Otc::Direction dir{ Otc::InvalidDirection };
-    };
-
-    struct LessNode
-    {
-        bool operator()(const std::pair<SNode*, float> a, const std::pair<SNode*, float> b) const
-        {
-            return b.second < a.second;
-        }
-    };
-
-    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
-    std::vector<Otc::Direction>& dirs = std::get<0>(ret);
-    Otc::PathFindResult& result = std::get<1>(ret);
-
-    result = Otc::PathFindResultNoWay;
-
-    if (startPos == goalPos) {
-        result = Otc::PathFindResultSamePosition;
-        return ret;
-    }
-
-    if (startPos.z != goalPos.z) {
-        result = Otc::PathFindResultImpossible;
-        return ret;
-    }
+    return m_pathFinder.find(startPos, goalPos, maxComplexity, flags, [this, ignoreCreatures](const Position& pos) {
+        return getPathCell(pos, ignoreCreatures);
+    });
+}
 
-    // check the goal pos is walkable
-    if (g_map.isAwareOfPosition(goalPos)) {
-        const auto& goalTile = getTile(goalPos);
-        if (!goalTile || (!goalTile->isWalkable(flags & Otc::PathFindIgnoreCreatures))) {
-            return ret;
-        }
+PathFinder::Cell Map::getPathCell(const Position& pos, const bool ignoreCreatures)
+{
+    PathFinder::Cell cell;
+    if (isAwareOfPosition(pos)) {
+        cell.flags = PathFinder::CellWasSeen;
+        if (const auto& tile = getTile(pos)) {
+            if (tile->hasCreatures() && !ignoreCreatures)
+                cell.flags |= PathFinder::CellHasCreature;
+            if (!tile->isWalkable(ignoreCreatures))
+                cell.flags |= PathFinder::CellNotWalkable;
+            if (!tile->isPathable())
+                cell.flags |= PathFinder::CellNotPathable;
+            cell.speed = tile->getGroundSpeed();
+        } else
+            cell.flags |= PathFinder::CellNotWalkable | PathFinder::CellNotPathable;
     } else {
-        const auto& goalTile = g_minimap.getTile(goalPos);
-        if (goalTile.hasFlag(MinimapTileNotWalkable)) {
-            return ret;
-        }
+        const auto& mtile = g_minimap.getTile(pos);
+        if (mtile.hasFlag(MinimapTileNotWalkable))
+            cell.flags |= PathFinder::CellNotWalkable;
+        if (mtile.hasFlag(MinimapTileNotPathable))
+            cell.flags |= PathFinder::CellNotPathable;
+        if (cell.flags != 0 || mtile.hasFlag(MinimapTileWasSeen))
+            cell.flags |= PathFinder::CellWasSeen;
+        cell.speed = mtile.getSpeed();
     }
+    return cell;
+}
 
-    stdext::map<Position, SNode*, Position::Hasher> nodes;
-    std::priority_queue<std::pair<SNode*, float>, std::vector<std::pair<SNode*, float>>, LessNode> searchList;
-
-    auto* currentNode = new SNode(startPos);
-    currentNode->pos = startPos;
-    nodes[startPos] = currentNode;
-    SNode* foundNode = nullptr;
-    while (currentNode) {
-        if (static_cast<int>(nodes.size()) > maxComplexity) {
-            result = Otc::PathFindResultTooFar;
-            break;
+WalkSnapshotConstPtr Map::getWalkSnapshot(const uint8_t z)
+{
+    if (!m_centralPosition.isValid() || z >= m_floors.size())
+        return nullptr;
+
+    auto& floor = m_floors[z];
+    floor.walkSnapshotShared = true;
+    if (floor.walkSnapshot)
+        return floor.walkSnapshot;
+
+    // aware area of the floor, shifted the same way isAwareOfPosition grounds a position
+    const int32_t offset = m_centralPosition.z - z;
+    const Position origin(m_centralPosition.x - m_awareRange.left + offset, m_centralPosition.y - m_awareRange.top + offset, z);
+
+    const auto& snapshot = std::make_shared<WalkSnapshot>(origin, m_awareRange.horizontal(), m_awareRange.vertical());
+    for (int32_t y = 0; y < m_awareRange.vertical(); ++y) {
+        for (int32_t x = 0; x < m_awareRange.horizontal(); ++x) {
+            const auto& pos = origin.translated(x, y);
+            if (const auto& tile = getTile(pos))
+                snapshot->setCell(pos, { .speed = static_cast<uint16_t>(tile->getGroundSpeed()), .walkable = tile->isWalkable(false), .pathable = tile->isPathable() });
         }
+    }
+    snapshot->setVersion(++m_walkSnapshotVersion);
 
-        // path found
-        if (currentNode->pos == goalPos && (!foundNode || currentNode->cost < foundNode->cost))
-            foundNode = currentNode;
-
-        // cost too high
-        if (foundNode && currentNode->totalCost >= foundNode->cost)
-            break;
-
-        for (int i = -1; i <= 1; ++i) {
-            for (int j = -1; j <= 1; ++j) {
-                if (i == 0 && j == 0)
-                    continue;
-
-                bool wasSeen = false;
-                bool hasCreature = false;
-                bool isNotWalkable = true;
-                bool isNotPathable = true;
-                int speed = 100;
-
-                Position neighborPos = currentNode->pos.translated(i, j);
-                if (neighborPos.x < 0 || neighborPos.y < 0) continue;
-                if (g_map.isAwareOfPosition(neighborPos)) {
-                    wasSeen = true;
-                    if (const auto& tile = getTile(neighborPos)) {
-                        hasCreature = tile->hasCreatures() && (!(flags & Otc::PathFindIgnoreCreatures));
-                        isNotWalkable = !tile->isWalkable(flags & Otc::PathFindIgnoreCreatures);
-                        isNotPathable = !tile->isPathable();
-                        speed = tile->getGroundSpeed();
-                    }
-                } else {
-                    const auto& mtile = g_minimap.getTile(neighborPos);
-                    wasSeen = mtile.hasFlag(MinimapTileWasSeen);
-                    isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
-                    isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
-                    if (isNotWalkable || isNotPathable)
-                        wasSeen = true;
-                    speed = mtile.getSpeed();
-                }
-
-                float walkFactor = 0;
-                if (neighborPos != goalPos) {
-                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
-                        continue;
-                    if (wasSeen) {
-                        if (!(flags & Otc::PathFindAllowCreatures) && hasCreature)
-                            continue;
-                        if (!(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
-                            continue;
-                        if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
-                            continue;
-                    }
-                } else {
-                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
-                        continue;
-                    if (wasSeen) {
-                        if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
-                            continue;
-                    }
-                }
+    floor.walkSnapshot = snapshot;
+    return snapshot;
+}
 
-                const Otc::Direction walkDir = currentNode->pos.getDirectionFromPosition(neighborPos);
-                if (walkDir >= Otc::NorthEast)
-                    walkFactor += 3.0f;
-                else
-                    walkFactor += 1.0f;
+void Map::updateWalkSnapshot(const Position& pos)
+{
+    if (pos.z >= m_floors.size())
+        return;
 
-                const float cost = currentNode->cost + (speed * walkFactor) / 100.0f;
+    auto& floor = m_floors[pos.z];
+    auto& snapshot = floor.walkSnapshot;
+    if (!snapshot || !snapshot->contains(pos))
+        return;
 
-                SNode* neighborNode;
-                if (!nodes.contains(neighborPos)) {
-                    neighborNode = new SNode(neighborPos);
-                    nodes[neighborPos] = neighborNode;
-                } else {
-                    neighborNode = nodes[neighborPos];
-                    if (neighborNode->cost <= cost)
-                        continue;
-                }
+    // a handed out version is never written again, searches may still be reading it
+    if (floor.walkSnapshotShared) {
+        snapshot = std::make_shared<WalkSnapshot>(*snapshot);
+        floor.walkSnapshotShared = false;
+    }
 
-                neighborNode->prev = currentNode;
-                neighborNode->cost = cost;
-                neighborNode->totalCost = neighborNode->cost + neighborPos.distance(goalPos);
-                neighborNode->dir = walkDir;
-                searchList.emplace(neighborNode, neighborNode->totalCost);
-            }
-        }
+    if (const auto& tile = getTile(pos))
+        snapshot->setCell(pos, { .speed = static_cast<uint16_t>(tile->getGroundSpeed()), .walkable = tile->isWalkable(false), .pathable = tile->isPathable() });
+    else
+        snapshot->removeCell(pos);
+    snapshot->setVersion(++m_walkSnapshotVersion);
+}
 
-        if (!searchList.empty()) {
-            currentNode = searchList.top().first;
-            searchList.pop();
-        } else
-            currentNode = nullptr;
+void Map::resetWalkSnapshots()
+{
+    for (auto& floor : m_floors) {
+        floor.walkSnapshot = nullptr;
+        floor.walkSnapshotShared = false;
     }
+}
 
-    if (foundNode) {
-        currentNode = foundNode;
-        while (currentNode) {
-            dirs.push_back(currentNode->dir);
-            currentNode = currentNode->prev;
-        }
-        dirs.pop_back();
-        std::ranges::reverse(dirs);
-        result = Otc::PathFindResultOk;
-    }
+PathPlannerPtr Map::createPathPlanner(const Position& start, const Position& goal, const int flags)
+{
+    const bool ignoreCreatures = flags & Otc::PathFindIgnoreCreatures;
 
-    for (const auto& it : nodes)
-        delete it.second;
+    const auto& planner = std::make_shared<PathPlanner>(start, goal, flags, [this, ignoreCreatures](const Position& pos) {
+        return getPathCell(pos, ignoreCreatures);
+    });
+    m_pathPlanners.emplace_back(planner);
+    return planner;
+}
 
-    return ret;
+DistanceFieldPtr Map::createDistanceField(const int flags)
+{
+    const bool ignoreCreatures = flags & Otc::PathFindIgnoreCreatures;
+
+    return std::make_shared<DistanceField>(flags, [this, ignoreCreatures](const Position& pos) {
+        return getPathCell(pos, ignoreCreatures);
+    });
 }
 
 void Map::resetLastCamera() const
@@ -1008,8 +999,7 @@ void Map::resetLastCamera() const
         mapView->resetLastCamera();
 }
 
-PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>
-                                    & visibleNodes)
+PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const WalkSnapshotConstPtr& snapshot)
 {
     auto ret = std::make_shared<PathFindResult>();
     ret->start = start;
@@ -1025,9 +1015,8 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
     }
 
     // check the goal pos is walkable
-    if (g_map.isAwareOfPosition(goal)) {
-        const auto& goalTile = getTile(goal);
-        if (!goalTile || (!goalTile->isWalkable())) {
+    if (snapshot && snapshot->contains(goal)) {
+        if (!snapshot->hasTile(goal) || !snapshot->isWalkable(goal)) {
             return ret;
         }
     } else {
@@ -1045,15 +1034,12 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
         }
     };
 
+    // node addresses must stay valid while the search grows
+    std::deque<Node> storage;
     stdext::map<Position, Node*, Position::Hasher> nodes;
     std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
 
-    if (visibleNodes) {
-        for (auto& node : *visibleNodes)
-            nodes.emplace(node->pos, node);
-    }
-
-    const auto& initNode = new Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
+    const auto& initNode = &storage.emplace_back(Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 });
     nodes[start] = initNode;
     searchList.push(initNode);
 
@@ -1077,7 +1063,15 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
                 Position neighbor = node->pos.translated(i, j);
                 if (neighbor.x < 0 || neighbor.y < 0) continue;
                 auto it = nodes.find(neighbor);
-                if (it == nodes.end()) {
+                if (it == nodes.end() && snapshot && snapshot->hasTile(neighbor)) {
+                    // aware tiles, the goal is reachable even if it can't be walked through
+                    if ((!snapshot->isWalkable(neighbor) || !snapshot->isPathable(neighbor)) && neighbor != goal) {
+                        it = nodes.emplace(neighbor, nullptr).first;
+                    } else {
+                        it = nodes.emplace(neighbor, &storage.emplace_back(Node{ .cost = static_cast<float>(snapshot->getSpeed(neighbor)), .totalCost = 10000000.0f,
+                                               .pos = neighbor, .prev = node, .distance = node->distance + 1, .unseen = 0 })).first;
+                    }
+                } else if (it == nodes.end()) {
                     const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
                     const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
                     const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
@@ -1089,9 +1083,9 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
                     } else {
                         if (!wasSeen)
                             speed = 2000;
-                        it = nodes.emplace(neighbor, new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev =
+                        it = nodes.emplace(neighbor, &storage.emplace_back(Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev =
                                                node,
-                                               .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 }).first;
+                                               .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 })).first;
                     }
                 }
                 if (!it->second) // no way
@@ -1129,37 +1123,17 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
     }
     ret->complexity = 50000 - limit;
 
-    for (const auto& node : nodes) {
-        delete node.second;
-    }
-
     return ret;
 }
 
 void Map::findPathAsync(const Position& start, const Position& goal, const std::function<void(PathFindResult_ptr)>&
                         callback)
 {
-    const auto visibleNodes = std::make_shared<std::list<Node*>>();
-    for (const auto& tile : getTiles(start.z)) {
-        if (tile->getPosition() == start)
-            continue;
-        const bool isNotWalkable = !tile->isWalkable(false);
-        const bool isNotPathable = !tile->isPathable();
-        const float speed = tile->getGroundSpeed();
-        if ((isNotWalkable || isNotPathable) && tile->getPosition() != goal) {
-            visibleNodes->push_back(new Node{ .cost = speed, .totalCost = 0, .pos = tile->getPosition(), .prev = nullptr, .distance =
-                0,
-                .unseen = 0
-            });
-        } else {
-            visibleNodes->push_back(new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = tile->getPosition(), .prev =
-                nullptr, .distance = 0, .unseen = 0
-            });
-        }
-    }
+    // the worker keeps this version even if the tiles change meanwhile
+    const auto& snapshot = start.z <= g_gameConfig.getMapMaxZ() ? getWalkSnapshot(start.z) : nullptr;
 
     g_asyncDispatcher.detach_task([=] {
-        const auto ret = g_map.newFindPath(start, goal, visibleNodes);
+        const auto ret = g_map.newFindPath(start, goal, snapshot);
         g_dispatcher.addEvent(std::bind(callback, ret));
     });
 }
@@ -1538,4 +1512,95 @@ const TilePtr& TileBlock::getOrCreate(const Position& pos)
     if (!tile)
         tile = std::make_shared<Tile>(pos);
     return tile;
-}
\ No newline at end of file
+}
+
+uint32_t TileBlockTable::nextGeneration()
+{
+    static std::atomic_uint32_t generation{ 0 };
+    return ++generation;
+}
+
+TileBlockTable::TileBlockTable(TileBlockTable&& other) noexcept :
+    m_directory(std::move(other.m_directory)), m_blocks(std::move(other.m_blocks)), m_generation(other.m_generation)
+{
+    other.m_generation = nextGeneration();
+}
+
+TileBlockTable& TileBlockTable::operator=(TileBlockTable&& other) noexcept
+{
+    if (this != &other) {
+        m_directory = std::move(other.m_directory);
+        m_blocks = std::move(other.m_blocks);
+        m_generation = nextGeneration();
+        other.m_generation = nextGeneration();
+    }
+    return *this;
+}
+
+TileBlock* TileBlockTable::find(const Position& pos) const
+{
+    struct LastBlock
+    {
+        const TileBlockTable* table;
+        uint32_t generation;
+        uint32_t key;
+        TileBlock* block;
+    };
+
+    // map views look up tiles from several threads at once
+    thread_local LastBlock last{ nullptr, 0, 0, nullptr };
+
+    const uint32_t key = getBlockKey(pos);
+    if (last.table == this && last.key == key && last.generation == m_generation)
+        return last.block;
+
+    if (!m_directory)
+        return nullptr;
+
+    const auto& page = (*m_directory)[getPageIndex(key)];
+    if (!page)
+        return nullptr;
+
+    TileBlock* block = (*page)[getSlotIndex(key)];
+    if (block)
+        last = { this, m_generation, key, block };
+    return block;
+}
+
+TileBlock& TileBlockTable::getOrCreate(const Position& pos)
+{
+    const uint32_t key = getBlockKey(pos);
+
+    if (!m_directory)
+        m_directory = std::make_unique<Directory>();
+
+    auto& page = (*m_directory)[getPageIndex(key)];
+    if (!page) {
+        page = std::make_unique<Page>();
+        page->fill(nullptr);
+    }
+
+    auto& block = (*page)[getSlotIndex(key)];
+    if (!block)
+        block = m_blocks.emplace_back(key, std::make_unique<TileBlock>()).second.get();
+    return *block;
+}
+
+void TileBlockTable::erase(const size_t index)
+{
+    const uint32_t key = m_blocks[index].first;
+    (*(*m_directory)[getPageIndex(key)])[getSlotIndex(key)] = nullptr;
+
+    if (index != m_blocks.size() - 1)
+        m_blocks[index] = std::move(m_blocks.back());
+    m_blocks.pop_back();
+
+    m_generation = nextGeneration();
+}
+
+void TileBlockTable::clear()
+{
+    m_blocks.clear();
+    m_directory.reset();
+    m_generation = nextGeneration();
+}
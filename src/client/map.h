@@ -21,7 +21,9 @@
  */
 
 #pragma once
+#include "creatureindex.h"
 #include "declarations.h"
+#include "pathfinder.h"
 #include "staticdata.h"
 #include "framework/core/inputevent.h"
 #include "framework/ui/declarations.h"
@@ -44,6 +46,52 @@ private:
     std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE> m_tiles;
 };
 
+// Tile blocks of a floor, addressed through a two level page table: a fixed directory
+// covering the whole map points to pages of blocks, which are allocated on demand.
+// Each thread remembers the last block it found, so lookups of neighbouring tiles
+// don't walk the table at all.
+class TileBlockTable
+{
+public:
+    TileBlockTable() = default;
+    TileBlockTable(TileBlockTable&& other) noexcept;
+    TileBlockTable& operator=(TileBlockTable&& other) noexcept;
+
+    TileBlock* find(const Position& pos) const;
+    TileBlock& getOrCreate(const Position& pos);
+
+    // the last block takes the place of the erased one
+    void erase(size_t index);
+    void clear();
+
+    size_t size() const { return m_blocks.size(); }
+    bool empty() const { return m_blocks.empty(); }
+
+    // (key, block) pairs in creation order
+    auto& operator[](const size_t index) const { return m_blocks[index]; }
+    auto begin() const { return m_blocks.begin(); }
+    auto end() const { return m_blocks.end(); }
+
+private:
+    static constexpr uint32_t BLOCKS_PER_AXIS = 65536 / BLOCK_SIZE;
+    static constexpr uint32_t PAGE_SIZE = 16; // blocks per axis
+    static constexpr uint32_t DIRECTORY_SIZE = BLOCKS_PER_AXIS / PAGE_SIZE;
+
+    using Page = std::array<TileBlock*, PAGE_SIZE* PAGE_SIZE>;
+    using Directory = std::array<std::unique_ptr<Page>, DIRECTORY_SIZE* DIRECTORY_SIZE>;
+
+    static uint32_t getBlockKey(const Position& pos) { return (static_cast<uint32_t>(pos.y) / BLOCK_SIZE) * BLOCKS_PER_AXIS + static_cast<uint32_t>(pos.x) / BLOCK_SIZE; }
+    static uint32_t getPageIndex(const uint32_t key) { return (key / BLOCKS_PER_AXIS / PAGE_SIZE) * DIRECTORY_SIZE + (key % BLOCKS_PER_AXIS) / PAGE_SIZE; }
+    static uint32_t getSlotIndex(const uint32_t key) { return (key / BLOCKS_PER_AXIS % PAGE_SIZE) * PAGE_SIZE + key % PAGE_SIZE; }
+    static uint32_t nextGeneration();
+
+    std::unique_ptr<Directory> m_directory;
+    std::vector<std::pair<uint32_t, std::unique_ptr<TileBlock>>> m_blocks;
+
+    // changes whenever a block is released, invalidating the per thread caches
+    uint32_t m_generation{ nextGeneration() };
+};
+
 struct PathFindResult
 {
     Otc::PathFindResult status = Otc::PathFindResultNoWay;
@@ -217,9 +265,14 @@ public:
 
     std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findPath(const Position& start, const Position& goal,
                                                                           int maxComplexity, int flags = 0);
-    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>& visibleNodes);
+    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const WalkSnapshotConstPtr& snapshot);
     void findPathAsync(const Position& start, const Position& goal,
                        const std::function<void(PathFindResult_ptr)>& callback);
+    PathPlannerPtr createPathPlanner(const Position& start, const Position& goal, int flags = 0);
+    DistanceFieldPtr createDistanceField(int flags = 0);
+    PathFinder::Cell getPathCell(const Position& pos, bool ignoreCreatures);
+    // walkability of the aware area of the floor, built on demand and kept up to date with the tiles
+    WalkSnapshotConstPtr getWalkSnapshot(uint8_t z);
 
     void setFloatingEffect(const bool enable) { m_floatingEffect = enable; }
     bool isDrawingFloatingEffects() { return m_floatingEffect; }
@@ -236,12 +289,17 @@ private:
     struct FloorData
     {
         std::vector<MissilePtr> missiles;
-        std::unordered_map<uint32_t, TileBlock > tileBlocks;
+        TileBlockTable tileBlocks;
+
+        WalkSnapshotPtr walkSnapshot;
+        // set once the snapshot was handed out, the next change goes to a copy
+        bool walkSnapshotShared{ false };
     };
 
     void removeUnawareThings();
-
-    uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+    void notificatePathPlanners(const Position& pos);
+    void updateWalkSnapshot(const Position& pos);
+    void resetWalkSnapshots();
 
     std::vector<FloorData> m_floors;
 
@@ -251,6 +309,10 @@ private:
 
     std::unordered_map<uint32_t, CreaturePtr> m_knownCreatures;
 
+    CreatureIndex m_creatureIndex;
+    std::vector<Tile*> m_spectatorTiles;
+    stdext::set<uint32_t> m_spectatorIds;
+
     std::unordered_map<UIWidgetPtr, AttachableObjectPtr> m_attachedObjectWidgetMap;
 
 #ifdef FRAMEWORK_EDITOR
@@ -275,6 +337,11 @@ private:
 
     AwareRange m_awareRange;
 
+    PathFinder m_pathFinder;
+    std::vector<std::weak_ptr<PathPlanner>> m_pathPlanners;
+
+    uint32_t m_walkSnapshotVersion{ 0 };
+
     bool m_floatingEffect{ true };
 };
 
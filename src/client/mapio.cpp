@@ -306,7 +306,7 @@ void Map::saveOtbm(const std::string& fileName)
 
                 for (uint8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
                     for (const auto& it : m_floors[z].tileBlocks) {
-                        const TileBlock& block = it.second;
+                        const TileBlock& block = *it.second;
                         for (const TilePtr& tile : block.getTiles()) {
                             if (unlikely(!tile || tile->isEmpty()))
                                 continue;
@@ -509,7 +509,7 @@ void Map::saveOtcm(const std::string& fileName)
 
         for (uint8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
             for (const auto& it : m_floors[z].tileBlocks) {
-                const TileBlock& block = it.second;
+                const TileBlock& block = *it.second;
                 for (const TilePtr& tile : block.getTiles()) {
                     if (!tile || tile->isEmpty())
                         continue;
@@ -40,6 +40,22 @@
 #include "framework/graphics/texturemanager.h"
 #include <framework/platform/platformwindow.h>
 
+namespace
+{
+    // waits for every task, then logs the ones that threw; get() alone would stop waiting at the first failure
+    void waitTasks(BS::multi_future<void>& tasks, const std::string_view what)
+    {
+        tasks.wait();
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            try {
+                tasks[i].get();
+            } catch (const std::exception& e) {
+                g_logger.error("Failed to {} (task {}): {}", what, i, e.what());
+            }
+        }
+    }
+}
+
 MapView::MapView() : m_lightView(std::make_unique<LightView>(Size())), m_pool(g_drawPool.get(DrawPoolType::MAP))
 {
     m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
@@ -120,52 +136,33 @@ void MapView::preLoad() {
 
 void MapView::drawFloor()
 {
-    const auto& cameraPosition = m_posInfo.camera;
-
-    const uint32_t flags = Otc::DrawThings;
-
-    for (int_fast8_t z = m_floorMax; z >= m_floorMin; --z) {
-        const float fadeLevel = getFadeLevel(z);
-        if (fadeLevel == 0.f) break;
-        if (fadeLevel < .99f)
-            g_drawPool.setOpacity(fadeLevel);
-
-        Position _camera = cameraPosition;
-        const bool alwaysTransparent = m_floorViewMode == Otc::ALWAYS_WITH_TRANSPARENCY && z < m_cachedFirstVisibleFloor && _camera.coveredUp(cameraPosition.z - z);
-
-        const auto& map = m_floors[z].cachedVisibleTiles;
-
-        for (const auto& tile : map.tiles) {
-            uint32_t tileFlags = flags;
-
-            if (!m_drawViewportEdge && !tile->canRender(tileFlags, cameraPosition, m_viewport))
-                continue;
-
-            if (alwaysTransparent) {
-                const bool inRange = tile->getPosition().isInRange(_camera, g_gameConfig.getTileTransparentFloorViewRange(), g_gameConfig.getTileTransparentFloorViewRange(), true);
-                g_drawPool.setOpacity(inRange ? .16 : .7);
-            }
+    uint8_t floors = 0;
+    for (int_fast8_t z = m_floorMax; z >= m_floorMin; --z, ++floors) {
+        if (getFadeLevel(z) == 0.f) break;
+    }
 
-            tile->draw(transformPositionTo2D(tile->getPosition()), tileFlags);
+    // textures must be loaded asynchronously, a synchronous load is not safe from several threads
+    if (m_parallelFloorRecording && floors > 1 && g_app.isLoadingAsyncTexture()) {
+        g_drawPool.prepareRecorders(DrawPoolType::MAP, floors);
 
-            if (alwaysTransparent)
-                g_drawPool.resetOpacity();
+        BS::multi_future<void> tasks;
+        for (uint8_t i = 0; i < floors; ++i) {
+            const uint8_t z = m_floorMax - i;
+            tasks.emplace_back(g_asyncDispatcher.submit_task([this, i, z] {
+                g_drawPool.record(DrawPoolType::MAP, i, [this, z] {
+                    recordFloor(z, getFadeLevel(z));
+                });
+            }));
         }
+        // a floor that failed is left out of this frame
+        waitTasks(tasks, "record map floor");
 
-        for (const auto& missile : g_map.getFloorMissiles(z))
-            missile->draw(transformPositionTo2D(missile->getPosition()), true);
-
-        if (m_shadowFloorIntensity > 0 && z == cameraPosition.z + 1) {
-            g_drawPool.setOpacity(m_shadowFloorIntensity, true);
-            g_drawPool.setDrawOrder(DrawOrder::FIFTH);
-            g_drawPool.addFilledRect(m_rectDimension, Color::black);
-            g_drawPool.resetDrawOrder();
+        g_drawPool.spliceRecorders(DrawPoolType::MAP, floors);
+    } else {
+        for (uint8_t i = 0; i < floors; ++i) {
+            const uint8_t z = m_floorMax - i;
+            recordFloor(z, getFadeLevel(z));
         }
-
-        if (canFloorFade())
-            g_drawPool.resetOpacity();
-
-        g_drawPool.flush();
     }
 
     if (m_posInfo.rect.contains(g_window.getMousePosition() * g_window.getDisplayDensity())) {
@@ -180,6 +177,57 @@ void MapView::drawFloor()
     }
 }
 
+void MapView::recordFloor(const uint8_t z, const float fadeLevel)
+{
+    const stdext::timer timer;
+
+    const auto& cameraPosition = m_posInfo.camera;
+
+    const uint32_t flags = Otc::DrawThings;
+
+    if (fadeLevel < .99f)
+        g_drawPool.setOpacity(fadeLevel);
+
+    Position _camera = cameraPosition;
+    const bool alwaysTransparent = m_floorViewMode == Otc::ALWAYS_WITH_TRANSPARENCY && z < m_cachedFirstVisibleFloor && _camera.coveredUp(cameraPosition.z - z);
+
+    const auto& map = m_floors[z].cachedVisibleTiles;
+
+    for (const auto& tile : map.tiles) {
+        uint32_t tileFlags = flags;
+
+        if (!m_drawViewportEdge && !tile->canRender(tileFlags, cameraPosition, m_viewport))
+            continue;
+
+        if (alwaysTransparent) {
+            const bool inRange = tile->getPosition().isInRange(_camera, g_gameConfig.getTileTransparentFloorViewRange(), g_gameConfig.getTileTransparentFloorViewRange(), true);
+            g_drawPool.setOpacity(inRange ? .16 : .7);
+        }
+
+        tile->draw(transformPositionTo2D(tile->getPosition()), tileFlags);
+
+        if (alwaysTransparent)
+            g_drawPool.resetOpacity();
+    }
+
+    for (const auto& missile : g_map.getFloorMissiles(z))
+        missile->draw(transformPositionTo2D(missile->getPosition()), true);
+
+    if (m_shadowFloorIntensity > 0 && z == cameraPosition.z + 1) {
+        g_drawPool.setOpacity(m_shadowFloorIntensity, true);
+        g_drawPool.setDrawOrder(DrawOrder::FIFTH);
+        g_drawPool.addFilledRect(m_rectDimension, Color::black);
+        g_drawPool.resetDrawOrder();
+    }
+
+    if (canFloorFade())
+        g_drawPool.resetOpacity();
+
+    g_drawPool.flush();
+
+    m_floors[z].recordTime = static_cast<uint32_t>(timer.elapsed_micros());
+}
+
 void MapView::drawLights() {
     const auto& cameraPosition = m_posInfo.camera;
 
@@ -405,7 +453,7 @@ void MapView::updateVisibleTiles()
             }));
         }
 
-        tasks.wait();
+        waitTasks(tasks, "update visible tiles");
 
         for (int fi = 0, s = m_floors.size(); fi < s; ++fi) {
             auto& floor = m_floors[fi];
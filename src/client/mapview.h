@@ -127,6 +127,13 @@ public:
 
     void setFloorFading(const uint16_t value) { m_floorFading = value; }
 
+    // records each floor on a worker thread, they are spliced back in floor order
+    void setParallelFloorRecording(const bool enable) { m_parallelFloorRecording = enable; }
+    bool isParallelFloorRecording() const { return m_parallelFloorRecording; }
+
+    // microseconds spent recording the floor in the last frame
+    uint32_t getFloorRecordTime(const uint8_t z) const { return z < m_floors.size() ? m_floors[z].recordTime : 0; }
+
     PainterShaderProgramPtr getNextShader() { return m_nextShader; }
     bool isSwitchingShader() { return !m_shaderSwitchDone; }
 
@@ -163,6 +170,7 @@ private:
     {
         MapObject cachedVisibleTiles;
         Timer fadingTimers;
+        uint32_t recordTime{ 0 };
     };
 
     struct Crosshair
@@ -190,6 +198,7 @@ private:
     uint8_t calcLastVisibleFloor() const;
 
     void drawFloor();
+    void recordFloor(uint8_t z, float fadeLevel);
     void drawLights();
 
     bool canFloorFade() const { return m_floorViewMode == Otc::FADE && m_floorFading; }
@@ -267,6 +276,7 @@ private:
     bool m_drawHighlightTarget{ false };
     bool m_shiftPressed{ false };
     bool m_multithreading{ false };
+    bool m_parallelFloorRecording{ false };
     bool m_drawCoveredThings{ false };
 
     FadeType m_fadeType{ FadeType::NONE };
@@ -24,7 +24,10 @@
 
 #include "gameconfig.h"
 #include "tile.h"
+#include "framework/core/asyncdispatcher.h"
+#include "framework/core/eventdispatcher.h"
 #include "framework/core/filestream.h"
+#include "framework/core/mappedfile.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/graphics/drawpoolmanager.h"
 #include "framework/graphics/image.h"
@@ -33,6 +36,92 @@
 Minimap g_minimap;
 static MinimapTile nulltile;
 
+namespace
+{
+    constexpr uint32_t BLOCK_BYTES = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
+    // tiles plus the image used to build its texture
+    constexpr uint32_t BLOCK_MEMORY = sizeof(MinimapBlock) + MMBLOCK_SIZE * MMBLOCK_SIZE * 4;
+    // x, y, z, offset, length
+    constexpr uint32_t INDEX_ENTRY_SIZE = 2 + 2 + 1 + 4 + 2;
+}
+
+// Compressed blocks of an OTMM v2 file. The file is mapped when it lives on disk,
+// otherwise it is kept in memory, and blocks are only decompressed when touched.
+class MinimapStore
+{
+public:
+    struct Entry
+    {
+        uint32_t offset;
+        uint16_t length;
+    };
+
+    MinimapStore() : m_blocks(g_gameConfig.getMapMaxZ() + 1) {}
+
+    bool map(const std::string& path)
+    {
+        if (!m_file.open(path))
+            return false;
+
+        m_data = m_file.data();
+        m_size = m_file.size();
+        return true;
+    }
+
+    void setData(std::vector<uint8_t>&& buffer)
+    {
+        m_file.close();
+        m_buffer = std::move(buffer);
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    // same blocks, read from a copy of the data on disk
+    std::shared_ptr<MinimapStore> remap(const std::string& path) const
+    {
+        const auto& store = std::make_shared<MinimapStore>();
+        if (!store->map(path) || store->size() != m_size)
+            return nullptr;
+
+        store->m_blocks = m_blocks;
+        return store;
+    }
+
+    void addBlock(const Position& pos, const uint32_t index, const Entry& entry)
+    {
+        if (static_cast<size_t>(entry.offset) + entry.length > m_size)
+            throw Exception("invalid OTMM block index");
+        m_blocks[pos.z][index] = entry;
+    }
+
+    const Entry* findBlock(const uint8_t z, const uint32_t index) const
+    {
+        const auto it = m_blocks[z].find(index);
+        return it != m_blocks[z].end() ? &it->second : nullptr;
+    }
+
+    const stdext::map<uint32_t, Entry>& getBlocks(const uint8_t z) const { return m_blocks[z]; }
+
+    bool readBlock(const Entry& entry, MinimapBlock& block) const
+    {
+        unsigned long destLen = BLOCK_BYTES;
+        const int ret = uncompress(reinterpret_cast<uint8_t*>(&block.getTiles()), &destLen, m_data + entry.offset, entry.length);
+        return ret == Z_OK && destLen == BLOCK_BYTES;
+    }
+
+private:
+    MappedFile m_file;
+    std::vector<uint8_t> m_buffer;
+
+    const uint8_t* m_data{ nullptr };
+    size_t m_size{ 0 };
+
+    std::vector<stdext::map<uint32_t, Entry>> m_blocks;
+};
+
 void MinimapBlock::clean()
 {
     m_tiles.fill({});
@@ -72,10 +161,15 @@ void MinimapBlock::update()
 
 void MinimapBlock::updateTile(const int x, const int y, const MinimapTile& tile)
 {
-    if (m_tiles[getTileIndex(x, y)].color != tile.color)
+    auto& current = m_tiles[getTileIndex(x, y)];
+    if (current == tile)
+        return;
+
+    if (current.color != tile.color)
         m_mustUpdate = true;
 
-    m_tiles[getTileIndex(x, y)] = tile;
+    current = tile;
+    setStored(false);
 }
 
 void Minimap::init() {
@@ -86,9 +180,106 @@ void Minimap::terminate() { clean(); }
 
 void Minimap::clean()
 {
+    finishPendingSave();
+
     SpinLock::Guard lock(m_lock);
     for (uint_fast8_t i = 0; i <= g_gameConfig.getMapMaxZ(); ++i)
         m_tileBlocks[i].clear();
+
+    m_store.reset();
+    m_storedBlocks = 0;
+}
+
+bool Minimap::hasBlock(const Position& pos)
+{
+    const uint32_t index = getBlockIndex(pos);
+
+    SpinLock::Guard lock(m_lock);
+    return m_tileBlocks[pos.z].contains(index) || (m_store && m_store->findBlock(pos.z, index));
+}
+
+MinimapBlock_ptr Minimap::getBlockPtr(const Position& pos, const bool create)
+{
+    const uint32_t index = getBlockIndex(pos);
+
+    std::shared_ptr<MinimapStore> store;
+    MinimapStore::Entry entry;
+    {
+        SpinLock::Guard lock(m_lock);
+        auto& blocks = m_tileBlocks[pos.z];
+        if (const auto it = blocks.find(index); it != blocks.end())
+            return it->second;
+
+        const auto* stored = m_store ? m_store->findBlock(pos.z, index) : nullptr;
+        if (!stored)
+            return create ? blocks[index] = std::make_shared<MinimapBlock>() : nullptr;
+
+        store = m_store;
+        entry = *stored;
+    }
+
+    // decompressed outside the lock, the store is kept alive by the local reference
+    const auto block = std::make_shared<MinimapBlock>();
+    if (store->readBlock(entry, *block)) {
+        block->justSaw();
+        block->setStored(true);
+    } else
+        g_logger.error("failed to read OTMM minimap block at {}", pos.toString());
+
+    SpinLock::Guard lock(m_lock);
+    auto& ptr = m_tileBlocks[pos.z][index];
+    if (!ptr) {
+        block->setLastUse(m_frame);
+        ptr = block;
+        ++m_storedBlocks;
+    }
+    return ptr;
+}
+
+void Minimap::readStoredBlocks()
+{
+    std::shared_ptr<MinimapStore> store;
+    {
+        SpinLock::Guard lock(m_lock);
+        store = m_store;
+    }
+
+    if (!store)
+        return;
+
+    for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+        for (const auto& [index, entry] : store->getBlocks(z))
+            getBlockPtr(getIndexPosition(index, z), false)->setStored(false);
+    }
+}
+
+void Minimap::evictStoredBlocks()
+{
+    const uint32_t maxBlocks = std::max<uint32_t>(m_memoryLimit / BLOCK_MEMORY, 1);
+
+    SpinLock::Guard lock(m_lock);
+    if (m_storedBlocks <= maxBlocks)
+        return;
+
+    // only blocks that still match the file can be dropped, they are read again when needed
+    std::vector<std::tuple<uint32_t, uint8_t, uint32_t>> candidates;
+    for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+        for (const auto& [index, block] : m_tileBlocks[z]) {
+            if (block->isStored())
+                candidates.emplace_back(block->getLastUse(), z, index);
+        }
+    }
+
+    // going down to 3/4 of the limit, so it doesn't run again on the next frames
+    const size_t keep = maxBlocks * 3 / 4;
+    if (candidates.size() > keep) {
+        const auto evictEnd = candidates.begin() + (candidates.size() - keep);
+        std::ranges::nth_element(candidates, evictEnd);
+        for (auto it = candidates.begin(); it != evictEnd; ++it)
+            m_tileBlocks[std::get<1>(*it)].erase(std::get<2>(*it));
+    }
+
+    m_storedBlocks = std::min(candidates.size(), keep);
 }
 
 void Minimap::draw(const Rect& screenRect, const Position& mapCenter, const float scale, const Color& color)
@@ -102,6 +293,8 @@ void Minimap::draw(const Rect& screenRect, const Position& mapCenter, const floa
     const auto& mapRect = calcMapRect(screenRect, mapCenter, scale);
     g_drawPool.addFilledRect(screenRect, color);
 
+    ++m_frame;
+
     if (MMBLOCK_SIZE * scale > 1 && mapCenter.isMapPosition()) {
         const auto& blockOff = getBlockOffset(mapRect.topLeft());
         const auto& off = Point((mapRect.size() * scale).toPoint() - screenRect.size().toPoint()) / 2;
@@ -121,6 +314,7 @@ void Minimap::draw(const Rect& screenRect, const Position& mapCenter, const floa
                     continue;
 
                 auto& block = getBlock(pos);
+                block.setLastUse(m_frame);
                 block.update();
 
                 const auto& tex = block.getTexture();
@@ -134,6 +328,8 @@ void Minimap::draw(const Rect& screenRect, const Position& mapCenter, const floa
     }
 
     g_drawPool.setClipRect(oldClipRect);
+
+    evictStoredBlocks();
 }
 
 Point Minimap::getTilePoint(const Position& pos, const Rect& screenRect, const Position& mapCenter, const float scale)
@@ -203,23 +399,21 @@ void Minimap::updateTile(const Position& pos, const TilePtr& tile)
     }
 }
 
-const MinimapTile& Minimap::getTile(const Position& pos)
+MinimapTile Minimap::getTile(const Position& pos)
 {
-    if (pos.z <= g_gameConfig.getMapMaxZ() && hasBlock(pos)) {
-        MinimapBlock& block = getBlock(pos);
-        const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
-        return block.getTile(pos.x - offsetPos.x, pos.y - offsetPos.y);
+    if (pos.z <= g_gameConfig.getMapMaxZ()) {
+        if (const auto& block = getBlockPtr(pos, false)) {
+            const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
+            return block->getTile(pos.x - offsetPos.x, pos.y - offsetPos.y);
+        }
     }
     return nulltile;
 }
 
 std::pair<MinimapBlock_ptr, MinimapTile> Minimap::threadGetTile(const Position& pos)
 {
-    SpinLock::Guard lock(m_lock);
-
-    if (pos.z <= g_gameConfig.getMapMaxZ() && hasBlock(pos)) {
-        const auto& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
-        if (block) {
+    if (pos.z <= g_gameConfig.getMapMaxZ()) {
+        if (const auto& block = getBlockPtr(pos, false)) {
             const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
             return std::make_pair(block, block->getTile(pos.x - offsetPos.x, pos.y - offsetPos.y));
         }
@@ -293,6 +487,7 @@ bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, fl
                     tile.color = c;
                     tile.flags = flags;
                     block.mustUpdate();
+                    block.setStored(false);
                 }
             }
         }
@@ -310,13 +505,13 @@ void Minimap::saveImage(const std::string&, const Rect&)
 
 bool Minimap::loadOtmm(const std::string& fileName)
 {
+    finishPendingSave();
+
     try {
         const FileStreamPtr fin = g_resources.openFile(fileName);
         if (!fin)
             throw Exception("unable to open file");
 
-        fin->cache();
-
         const uint32_t signature = fin->getU32();
         if (signature != OTMM_SIGNATURE)
             throw Exception("invalid OTMM file");
@@ -325,48 +520,79 @@ bool Minimap::loadOtmm(const std::string& fileName)
         const uint16_t version = fin->getU16();
         fin->getU32(); // flags
 
+        uint32_t blockCount = 0;
         switch (version) {
             case 1:
             {
                 fin->getString(); // description
                 break;
             }
+            case 2:
+            {
+                fin->getString(); // description
+                blockCount = fin->getU32();
+                break;
+            }
             default:
                 throw Exception("OTMM version not supported");
         }
 
+        if (version == 1) {
+            loadOtmmBlocks(fin, start);
+            fin->close();
+            return true;
+        }
+
+        // version 2 starts with a block index, blocks are decompressed when first used
+        std::vector<uint8_t> index(static_cast<size_t>(blockCount) * INDEX_ENTRY_SIZE);
         fin->seek(start);
+        if (!index.empty() && fin->read(index.data(), index.size()) != static_cast<int>(index.size()))
+            throw Exception("invalid OTMM block index");
+
+        const auto store = std::make_shared<MinimapStore>();
+        const auto& realDir = g_resources.getRealDir(fileName);
+        if (realDir.empty() || !store->map(realDir + g_resources.resolvePath(fileName))) {
+            // inside a package, keep the compressed file in memory
+            fin->cache();
+            store->setData(std::move(fin->m_data));
+        }
+        fin->close();
 
-        constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
-        std::vector<uint8_t> compressBuffer(compressBound(blockSize));
-        std::vector<uint8_t> decompressBuffer(blockSize);
+        for (size_t i = 0; i < index.size(); i += INDEX_ENTRY_SIZE) {
+            const uint8_t* entry = index.data() + i;
+            const Position pos(stdext::readULE16(entry), stdext::readULE16(entry + 2), entry[4]);
+            if (!pos.isValid() || pos.z >= g_gameConfig.getMapMaxZ() + 1)
+                throw Exception("invalid OTMM block index");
 
-        while (true) {
-            Position pos;
-            pos.x = fin->getU16();
-            pos.y = fin->getU16();
-            pos.z = fin->getU8();
+            store->addBlock(pos, getBlockIndex(pos), { .offset = stdext::readULE32(entry + 5), .length = stdext::readULE16(entry + 9) });
+        }
 
-            // end of file or file is corrupted
-            if (!pos.isValid() || pos.z >= g_gameConfig.getMapMaxZ() + 1)
-                break;
+        // blocks of a previous file are kept in memory, the new one takes over the store
+        readStoredBlocks();
 
-            MinimapBlock& block = getBlock(pos);
-            const uint16_t len = fin->getU16();
-            fin->read(compressBuffer.data(), len);
+        std::vector<std::pair<MinimapBlock_ptr, MinimapStore::Entry>> loadedBlocks;
+        {
+            SpinLock::Guard lock(m_lock);
+            m_store = store;
 
-            unsigned long destLen = blockSize;
-            const int ret = uncompress(decompressBuffer.data(), &destLen, compressBuffer.data(), len);
+            for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+                for (const auto& [blockIndex, entry] : store->getBlocks(z)) {
+                    if (const auto it = m_tileBlocks[z].find(blockIndex); it != m_tileBlocks[z].end())
+                        loadedBlocks.emplace_back(it->second, entry);
+                }
+            }
+        }
 
-            if (ret != Z_OK || destLen != blockSize)
-                break;
+        // blocks already in memory take the file contents, like version 1 does
+        for (const auto& [block, entry] : loadedBlocks) {
+            if (!store->readBlock(entry, *block))
+                continue;
 
-            memcpy(&block.getTiles(), decompressBuffer.data(), blockSize);
-            block.mustUpdate();
-            block.justSaw();
+            block->mustUpdate();
+            block->justSaw();
+            block->setStored(true);
         }
 
-        fin->close();
         return true;
     } catch (const stdext::exception& e) {
         g_logger.error("failed to load OTMM minimap: {}", e.what());
@@ -374,10 +600,139 @@ bool Minimap::loadOtmm(const std::string& fileName)
     }
 }
 
+void Minimap::loadOtmmBlocks(const FileStreamPtr& fin, const uint32_t start)
+{
+    fin->cache();
+    fin->seek(start);
+
+    std::vector<uint8_t> compressBuffer(compressBound(BLOCK_BYTES));
+    std::vector<uint8_t> decompressBuffer(BLOCK_BYTES);
+
+    while (true) {
+        Position pos;
+        pos.x = fin->getU16();
+        pos.y = fin->getU16();
+        pos.z = fin->getU8();
+
+        // end of file or file is corrupted
+        if (!pos.isValid() || pos.z >= g_gameConfig.getMapMaxZ() + 1)
+            break;
+
+        MinimapBlock& block = getBlock(pos);
+        const uint16_t len = fin->getU16();
+        fin->read(compressBuffer.data(), len);
+
+        unsigned long destLen = BLOCK_BYTES;
+        const int ret = uncompress(decompressBuffer.data(), &destLen, compressBuffer.data(), len);
+
+        if (ret != Z_OK || destLen != BLOCK_BYTES)
+            break;
+
+        memcpy(&block.getTiles(), decompressBuffer.data(), BLOCK_BYTES);
+        block.mustUpdate();
+        block.justSaw();
+        block.setStored(false);
+    }
+}
+
+struct Minimap::OtmmSave
+{
+    struct Block
+    {
+        uint8_t z;
+        uint32_t index;
+        MinimapBlock_ptr block;
+        uint32_t revision;
+        // copy of the tiles of changed blocks, UINT32_MAX when the stored data is reused
+        uint32_t tiles;
+        MinimapStore::Entry stored;
+    };
+
+    std::string fileName;
+    std::string tempFileName;
+
+    std::vector<Block> blocks;
+    std::vector<std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE>> tiles;
+
+    std::shared_ptr<MinimapStore> oldStore;
+    std::shared_ptr<MinimapStore> newStore;
+
+    std::future<void> task;
+    std::string error;
+    bool finished{ false };
+};
+
 void Minimap::saveOtmm(const std::string& fileName)
+{
+    finishPendingSave();
+
+    const auto& save = prepareOtmmSave(fileName);
+    buildOtmmSave(*save);
+    finishOtmmSave(save);
+}
+
+void Minimap::saveOtmmAsync(const std::string& fileName)
+{
+    // saves are applied in order, blocks changed after the previous one are in the new snapshot
+    finishPendingSave();
+
+    const auto& save = prepareOtmmSave(fileName);
+    save->task = g_asyncDispatcher.submit_task([this, save] {
+        buildOtmmSave(*save);
+        g_dispatcher.addEvent([this, save] { finishOtmmSave(save); });
+    });
+
+    m_pendingSave = save;
+}
+
+void Minimap::finishPendingSave()
+{
+    if (const auto save = std::move(m_pendingSave))
+        finishOtmmSave(save);
+}
+
+std::shared_ptr<Minimap::OtmmSave> Minimap::prepareOtmmSave(const std::string& fileName)
+{
+    const auto& save = std::make_shared<OtmmSave>();
+    save->fileName = fileName;
+    save->tempFileName = fileName + ".tmp";
+
+    SpinLock::Guard lock(m_lock);
+    save->oldStore = m_store;
+
+    for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+        for (const auto& [index, block] : m_tileBlocks[z]) {
+            const auto* stored = m_store ? m_store->findBlock(z, index) : nullptr;
+            if (!block->wasSeen() && !stored)
+                continue;
+
+            // only changed blocks are compressed again, their tiles are copied as they may change while saving
+            if (stored && block->isStored())
+                save->blocks.emplace_back(z, index, block, block->getRevision(), UINT32_MAX, *stored);
+            else {
+                save->blocks.emplace_back(z, index, block, block->getRevision(), save->tiles.size(), MinimapStore::Entry{});
+                save->tiles.emplace_back(block->getTiles());
+            }
+        }
+
+        // blocks that were never touched are copied straight from the loaded file
+        if (m_store) {
+            for (const auto& [index, entry] : m_store->getBlocks(z)) {
+                if (!m_tileBlocks[z].contains(index))
+                    save->blocks.emplace_back(z, index, nullptr, 0, UINT32_MAX, entry);
+            }
+        }
+    }
+
+    std::ranges::sort(save->blocks, [](const OtmmSave::Block& a, const OtmmSave::Block& b) { return std::tie(a.z, a.index) < std::tie(b.z, b.index); });
+    return save;
+}
+
+void Minimap::buildOtmmSave(OtmmSave& save)
 {
     try {
-        const FileStreamPtr fin = g_resources.createFile(fileName);
+        // the file is built in memory, the loaded one may be mapped and is replaced by it
+        const auto fin = std::make_shared<FileStream>(save.fileName, nullptr, true);
         fin->cache();
 
         //TODO: compression flag with zlib
@@ -389,8 +744,9 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(OTMM_VERSION);
         fin->addU32(flags);
 
-        // version 1 header
-        fin->addString("OTMM 1.0"); // description
+        // version 2 header
+        fin->addString("OTMM 2.0"); // description
+        fin->addU32(save.blocks.size());
 
         // go back and rewrite where the map data starts
         const uint32_t start = fin->tell();
@@ -398,37 +754,106 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(start);
         fin->seek(start);
 
-        constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
+        // index is written once the block offsets are known
+        const std::vector<uint8_t> emptyIndex(save.blocks.size() * INDEX_ENTRY_SIZE);
+        fin->write(emptyIndex.data(), emptyIndex.size());
+
         constexpr uint32_t COMPRESS_LEVEL = 3;
-        std::vector<uint8_t> compressBuffer(compressBound(blockSize));
+        std::vector<uint8_t> compressBuffer(compressBound(BLOCK_BYTES));
+        std::vector<MinimapStore::Entry> entries;
+        entries.reserve(save.blocks.size());
+
+        for (const auto& block : save.blocks) {
+            MinimapStore::Entry entry{ .offset = fin->tell(), .length = 0 };
+            if (block.tiles == UINT32_MAX) {
+                entry.length = block.stored.length;
+                fin->write(save.oldStore->data() + block.stored.offset, entry.length);
+            } else {
+                unsigned long len = compressBuffer.size();
+                compress2(compressBuffer.data(), &len, (uint8_t*)&save.tiles[block.tiles], BLOCK_BYTES, COMPRESS_LEVEL);
+                entry.length = len;
+                fin->write(compressBuffer.data(), len);
+            }
+            entries.emplace_back(entry);
+        }
 
-        for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
-            for (const auto& [index, block] : m_tileBlocks[z]) {
-                if (!block->wasSeen())
-                    continue;
+        fin->seek(start);
+        for (size_t i = 0; i < save.blocks.size(); ++i) {
+            const auto& pos = getIndexPosition(save.blocks[i].index, save.blocks[i].z);
+            fin->addU16(pos.x);
+            fin->addU16(pos.y);
+            fin->addU8(pos.z);
+            fin->addU32(entries[i].offset);
+            fin->addU16(entries[i].length);
+        }
 
-                const auto& pos = getIndexPosition(index, z);
-                fin->addU16(pos.x);
-                fin->addU16(pos.y);
-                fin->addU8(pos.z);
+        // the written data becomes the new store, so saved blocks can be dropped again
+        save.newStore = std::make_shared<MinimapStore>();
+        save.newStore->setData(std::move(fin->m_data));
+        for (size_t i = 0; i < save.blocks.size(); ++i)
+            save.newStore->addBlock(getIndexPosition(save.blocks[i].index, save.blocks[i].z), save.blocks[i].index, entries[i]);
 
-                unsigned long len = blockSize;
-                compress2(compressBuffer.data(), &len, (uint8_t*)&block->getTiles(), blockSize, COMPRESS_LEVEL);
-                fin->addU16(len);
-                fin->write(compressBuffer.data(), len);
+        save.tiles.clear();
+        save.tiles.shrink_to_fit();
+
+        // written next to the old file, which is only replaced once the new one is complete
+        if (!g_resources.writeFileBuffer(save.tempFileName, save.newStore->data(), save.newStore->size()))
+            throw Exception("unable to write file");
+    } catch (const stdext::exception& e) {
+        save.error = e.what();
+        save.newStore.reset();
+    }
+}
+
+void Minimap::finishOtmmSave(const std::shared_ptr<OtmmSave>& save)
+{
+    if (save->finished)
+        return;
+
+    if (save->task.valid())
+        save->task.wait();
+    save->finished = true;
+
+    if (m_pendingSave == save)
+        m_pendingSave.reset();
+
+    if (!save->newStore) {
+        g_logger.error("failed to save OTMM minimap: {}", save->error);
+        g_resources.deleteFile(save->tempFileName);
+        return;
+    }
+
+    {
+        SpinLock::Guard lock(m_lock);
+        m_store = save->newStore;
+
+        // blocks changed while saving stay dirty
+        for (const auto& block : save->blocks) {
+            if (block.block && !block.block->isStored() && block.block->getRevision() == block.revision) {
+                block.block->setStored(true);
+                ++m_storedBlocks;
             }
         }
+    }
 
-        // end of file
-        constexpr Position invalidPos;
-        fin->addU16(invalidPos.x);
-        fin->addU16(invalidPos.y);
-        fin->addU8(invalidPos.z);
+    // the old file may be mapped by the old store
+    save->oldStore.reset();
 
-        fin->flush();
+    const auto& writeDir = std::filesystem::u8path(g_resources.getWriteDir());
+    const auto& filePath = writeDir / std::filesystem::u8path(save->fileName).relative_path();
+    const auto& tempPath = writeDir / std::filesystem::u8path(save->tempFileName).relative_path();
 
-        fin->close();
-    } catch (const stdext::exception& e) {
-        g_logger.error("failed to save OTMM minimap: {}", e.what());
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filePath, ec);
+    if (ec) {
+        g_logger.error("failed to save OTMM minimap: unable to replace '{}': {}", save->fileName, ec.message());
+        return;
     }
-}
\ No newline at end of file
+
+    // keep reading from the file on disk instead of the buffer it was written from
+    if (const auto& mapped = save->newStore->remap(filePath.string())) {
+        SpinLock::Guard lock(m_lock);
+        if (m_store == save->newStore)
+            m_store = mapped;
+    }
+}
@@ -23,11 +23,12 @@
 #pragma once
 
 #include "declarations.h"
+#include <framework/core/declarations.h>
 #include <framework/graphics/declarations.h>
 #include <framework/util/spinlock.h>
 
 constexpr uint8_t MMBLOCK_SIZE = 64;
-constexpr uint8_t OTMM_VERSION = 1;
+constexpr uint8_t OTMM_VERSION = 2;
 constexpr uint32_t OTMM_SIGNATURE = 0x4D4d544F;
 
 enum MinimapTileFlags
@@ -64,6 +65,20 @@ public:
     void mustUpdate() { m_mustUpdate = true; }
     void justSaw() { m_wasSeen = true; }
     bool wasSeen() const { return m_wasSeen; }
+
+    // tiles are the same as the copy in the loaded OTMM file, so the block can be dropped and read again
+    void setStored(const bool stored)
+    {
+        m_stored = stored;
+        if (!stored)
+            ++m_revision;
+    }
+    bool isStored() const { return m_stored; }
+    // changes every time the tiles stop matching the stored copy
+    uint32_t getRevision() const { return m_revision; }
+
+    void setLastUse(const uint32_t frame) { m_lastUse = frame; }
+    uint32_t getLastUse() const { return m_lastUse; }
 private:
     TexturePtr m_texture;
     ImagePtr m_image;
@@ -72,14 +87,20 @@ private:
 
     std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE> m_tiles;
 
+    uint32_t m_lastUse{ 0 };
+    uint32_t m_revision{ 0 };
+
     bool m_mustUpdate{ true };
     bool m_wasSeen{ false };
+    bool m_stored{ false };
 };
 
 #pragma pack(pop)
 
 using MinimapBlock_ptr = std::shared_ptr<MinimapBlock>;
 
+class MinimapStore;
+
 class Minimap
 {
 public:
@@ -94,25 +115,36 @@ public:
     Rect getTileRect(const Position& pos, const Rect& screenRect, const Position& mapCenter, float scale);
 
     void updateTile(const Position& pos, const TilePtr& tile);
-    const MinimapTile& getTile(const Position& pos);
+    MinimapTile getTile(const Position& pos);
     std::pair<MinimapBlock_ptr, MinimapTile> threadGetTile(const Position& pos);
 
     bool loadImage(const std::string& fileName, const Position& topLeft, float colorFactor);
     void saveImage(const std::string& fileName, const Rect& mapRect);
     bool loadOtmm(const std::string& fileName);
     void saveOtmm(const std::string& fileName);
+    // changed blocks are compressed and the file is replaced in the background
+    void saveOtmmAsync(const std::string& fileName);
+
+    // memory used by blocks read from an OTMM file, cold blocks are dropped above it
+    void setMemoryLimit(const uint32_t bytes) { m_memoryLimit = bytes; }
+    uint32_t getMemoryLimit() const { return m_memoryLimit; }
 
 private:
+    struct OtmmSave;
+
     Rect calcMapRect(const Rect& screenRect, const Position& mapCenter, float scale) const;
-    bool hasBlock(const Position& pos) { return m_tileBlocks[pos.z].contains(getBlockIndex(pos)); }
-    MinimapBlock& getBlock(const Position& pos)
-    {
-        SpinLock::Guard lock(m_lock);
-        auto& ptr = m_tileBlocks[pos.z][getBlockIndex(pos)];
-        if (!ptr)
-            ptr = std::make_shared<MinimapBlock>();
-        return *ptr;
-    }
+    bool hasBlock(const Position& pos);
+    MinimapBlock& getBlock(const Position& pos) { return *getBlockPtr(pos, true); }
+    MinimapBlock_ptr getBlockPtr(const Position& pos, bool create);
+    void loadOtmmBlocks(const FileStreamPtr& fin, uint32_t start);
+    void readStoredBlocks();
+    void evictStoredBlocks();
+
+    std::shared_ptr<OtmmSave> prepareOtmmSave(const std::string& fileName);
+    void buildOtmmSave(OtmmSave& save);
+    void finishOtmmSave(const std::shared_ptr<OtmmSave>& save);
+    void finishPendingSave();
+
     Point getBlockOffset(const Point& pos)
     {
         return {
@@ -129,7 +161,13 @@ private:
     }
     uint32_t getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
     std::vector<std::unordered_map<uint32_t, MinimapBlock_ptr>> m_tileBlocks;
+    std::shared_ptr<MinimapStore> m_store;
+    std::shared_ptr<OtmmSave> m_pendingSave;
     SpinLock m_lock;
+
+    uint32_t m_memoryLimit{ 64 * 1024 * 1024 };
+    uint32_t m_storedBlocks{ 0 };
+    std::atomic_uint32_t m_frame{ 0 };
 };
 
 extern Minimap g_minimap;
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pathfinder.h"
+
+namespace
+{
+    constexpr int32_t MIN_RADIUS = 32;
+    constexpr int32_t RADIUS_MARGIN = 32;
+
+    float heuristic(const int32_t x, const int32_t y, const Position& goal) { return PathFinder::octileDistance(goal.x - x, goal.y - y); }
+}
+
+float PathFinder::octileDistance(const int32_t dx, const int32_t dy)
+{
+    constexpr float diagonalStep = std::min<float>(DIAGONAL_FACTOR, 2 * STRAIGHT_FACTOR);
+
+    const int32_t ax = std::abs(dx);
+    const int32_t ay = std::abs(dy);
+    return (std::max(ax, ay) - std::min(ax, ay)) * STRAIGHT_FACTOR + std::min(ax, ay) * diagonalStep;
+}
+
+std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> PathFinder::find(const Position& start, const Position& goal,
+                                                                              const int maxComplexity, const int flags, const CellSampler& sampler)
+{
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
+    auto& [dirs, result] = ret;
+
+    result = Otc::PathFindResultNoWay;
+    m_reached = 0;
+
+    if (start == goal) {
+        result = Otc::PathFindResultSamePosition;
+        return ret;
+    }
+
+    if (start.z != goal.z) {
+        result = Otc::PathFindResultImpossible;
+        return ret;
+    }
+
+    // check the goal pos is walkable
+    if (sampler(goal).flags & CellNotWalkable)
+        return ret;
+
+    const int32_t goalDistance = std::max(std::abs(goal.x - start.x), std::abs(goal.y - start.y));
+    if (goalDistance > MAX_RADIUS) {
+        result = Otc::PathFindResultTooFar;
+        return ret;
+    }
+
+    // every step reaches at least one new node, so the search can't go further than the complexity allows
+    const int32_t complexityRadius = maxComplexity < MAX_RADIUS ? std::max(maxComplexity, 0) + 1 : MAX_RADIUS;
+    int32_t radius = std::clamp(std::min(goalDistance + RADIUS_MARGIN, complexityRadius), std::max(MIN_RADIUS, goalDistance), MAX_RADIUS);
+
+    // a window too small for the detour the search needs is grown until the result can't change anymore
+    bool clipped;
+    while (true) {
+        prepare(start, radius);
+        result = search(start, goal, maxComplexity, flags, sampler, clipped);
+        if (!clipped || radius >= complexityRadius)
+            break;
+        radius = std::min(radius * 2, complexityRadius);
+    }
+
+    if (result == Otc::PathFindResultOk) {
+        // walk back from the goal following the direction each node was reached from
+        Position pos = goal;
+        while (pos != start && dirs.size() < m_reached) {
+            const auto dir = static_cast<Otc::Direction>(getNode(pos.x, pos.y)->dir);
+            const auto& [dx, dy] = getStepOffset(dir);
+            dirs.push_back(dir);
+            pos.translate(-dx, -dy);
+        }
+        std::ranges::reverse(dirs);
+    }
+
+    return ret;
+}
+
+Otc::PathFindResult PathFinder::search(const Position& start, const Position& goal, const int maxComplexity, const int flags,
+                                       const CellSampler& sampler, bool& clipped)
+{
+    Node* startNode = getNode(start.x, start.y);
+    startNode->flags |= NodeReached | NodeSampled;
+    startNode->cost = 0;
+    startNode->totalCost = heuristic(start.x, start.y, goal);
+    ++m_reached;
+
+    const uint32_t goalIndex = getNodeIndex(getNode(goal.x, goal.y));
+
+    // lowest cost a path leaving the window could reach the goal with, ground speeds are never negative
+    float clippedBound = std::numeric_limits<float>::max();
+    uint32_t currentIndex = getNodeIndex(startNode);
+    while (true) {
+        if (m_reached > static_cast<uint32_t>(maxComplexity)) {
+            clipped = false;
+            return Otc::PathFindResultTooFar;
+        }
+
+        if (currentIndex == goalIndex) {
+            // only a path through the outside of the window could still be cheaper
+            clipped = clippedBound < m_nodes[goalIndex].cost;
+            return Otc::PathFindResultOk;
+        }
+
+        const Node& current = m_nodes[currentIndex];
+        const auto& currentPos = getNodePosition(currentIndex, start.z);
+
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                const int32_t x = currentPos.x + i;
+                const int32_t y = currentPos.y + j;
+                if (x < 0 || y < 0)
+                    continue;
+
+                Node* neighbor = getNode(x, y);
+                if (!neighbor) {
+                    clippedBound = std::min(clippedBound, current.cost + heuristic(x, y, goal));
+                    continue;
+                }
+
+                if (!(neighbor->flags & NodeSampled)) {
+                    const auto& cell = sampler(Position(x, y, start.z));
+                    neighbor->flags |= cell.flags | NodeSampled;
+                    neighbor->speed = cell.speed;
+                }
+
+                const bool wasSeen = neighbor->flags & CellWasSeen;
+                if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+                    continue;
+
+                if (wasSeen) {
+                    if (!(flags & Otc::PathFindAllowNonWalkable) && (neighbor->flags & CellNotWalkable))
+                        continue;
+
+                    if (getNodeIndex(neighbor) != goalIndex) {
+                        if (!(flags & Otc::PathFindAllowCreatures) && (neighbor->flags & CellHasCreature))
+                            continue;
+                        if (!(flags & Otc::PathFindAllowNonPathable) && (neighbor->flags & CellNotPathable))
+                            continue;
+                    }
+                }
+
+                const auto walkDir = PathFinder::getStepDirection(i, j);
+                const float walkFactor = PathFinder::getStepFactor(walkDir);
+                const float cost = current.cost + (neighbor->speed * walkFactor) / 100.0f;
+
+                if (neighbor->flags & NodeReached) {
+                    if (neighbor->cost <= cost)
+                        continue;
+                } else {
+                    neighbor->flags |= NodeReached;
+                    ++m_reached;
+                }
+
+                neighbor->cost = cost;
+                neighbor->totalCost = cost + heuristic(x, y, goal);
+                neighbor->dir = walkDir;
+
+                if (neighbor->heapIndex == NOT_IN_HEAP)
+                    heapPush(getNodeIndex(neighbor));
+                else
+                    heapUpdate(getNodeIndex(neighbor));
+            }
+        }
+
+        if (m_heap.empty()) {
+            // the search ran out of the window before exhausting the reachable area
+            clipped = clippedBound < std::numeric_limits<float>::max();
+            return clipped ? Otc::PathFindResultTooFar : Otc::PathFindResultNoWay;
+        }
+
+        currentIndex = heapPop();
+    }
+}
+
+void PathFinder::prepare(const Position& start, const int32_t radius)
+{
+    m_side = static_cast<uint32_t>(radius) * 2 + 1;
+    m_originX = start.x - radius;
+    m_originY = start.y - radius;
+
+    const size_t size = static_cast<size_t>(m_side) * m_side;
+    if (m_nodes.size() < size)
+        m_nodes.resize(size, Node{ .generation = 0 });
+
+    if (++m_generation == 0) {
+        for (auto& node : m_nodes)
+            node.generation = 0;
+        m_generation = 1;
+    }
+
+    m_heap.clear();
+    m_reached = 0;
+}
+
+PathFinder::Node* PathFinder::getNode(const int32_t x, const int32_t y)
+{
+    const auto localX = static_cast<uint32_t>(x - m_originX);
+    const auto localY = static_cast<uint32_t>(y - m_originY);
+    if (localX >= m_side || localY >= m_side)
+        return nullptr;
+
+    Node& node = m_nodes[localY * m_side + localX];
+    if (node.generation != m_generation) {
+        node.generation = m_generation;
+        node.heapIndex = NOT_IN_HEAP;
+        node.flags = 0;
+        node.speed = 100;
+        node.dir = Otc::InvalidDirection;
+    }
+    return &node;
+}
+
+void PathFinder::heapPush(const uint32_t index)
+{
+    m_nodes[index].heapIndex = static_cast<uint32_t>(m_heap.size());
+    m_heap.push_back(index);
+    heapSiftUp(m_nodes[index].heapIndex);
+}
+
+void PathFinder::heapUpdate(const uint32_t index)
+{
+    // costs only ever decrease while a node is queued
+    heapSiftUp(m_nodes[index].heapIndex);
+}
+
+uint32_t PathFinder::heapPop()
+{
+    const uint32_t top = m_heap.front();
+    m_nodes[top].heapIndex = NOT_IN_HEAP;
+
+    const uint32_t last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty()) {
+        m_heap[0] = last;
+        m_nodes[last].heapIndex = 0;
+        heapSiftDown(0);
+    }
+
+    return top;
+}
+
+void PathFinder::heapSiftUp(uint32_t pos)
+{
+    const uint32_t index = m_heap[pos];
+    const float totalCost = m_nodes[index].totalCost;
+
+    while (pos > 0) {
+        const uint32_t parentPos = (pos - 1) / 2;
+        const uint32_t parent = m_heap[parentPos];
+        if (m_nodes[parent].totalCost <= totalCost)
+            break;
+
+        m_heap[pos] = parent;
+        m_nodes[parent].heapIndex = pos;
+        pos = parentPos;
+    }
+
+    m_heap[pos] = index;
+    m_nodes[index].heapIndex = pos;
+}
+
+void PathFinder::heapSiftDown(uint32_t pos)
+{
+    const uint32_t index = m_heap[pos];
+    const float totalCost = m_nodes[index].totalCost;
+    const auto size = static_cast<uint32_t>(m_heap.size());
+
+    while (true) {
+        uint32_t childPos = pos * 2 + 1;
+        if (childPos >= size)
+            break;
+
+        if (childPos + 1 < size && m_nodes[m_heap[childPos + 1]].totalCost < m_nodes[m_heap[childPos]].totalCost)
+            ++childPos;
+
+        const uint32_t child = m_heap[childPos];
+        if (totalCost <= m_nodes[child].totalCost)
+            break;
+
+        m_heap[pos] = child;
+        m_nodes[child].heapIndex = pos;
+        pos = childPos;
+    }
+
+    m_heap[pos] = index;
+    m_nodes[index].heapIndex = pos;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+// A* search over a flat node window centered on the start position.
+// The window is reused between searches and invalidated by bumping a
+// generation stamp, so once it reached its working size a search does
+// not allocate anything besides the returned path. A search that needs
+// to leave the window runs again on a bigger one, up to MAX_RADIUS.
+class PathFinder
+{
+public:
+    enum CellFlags : uint8_t
+    {
+        CellWasSeen = 1 << 0,
+        CellHasCreature = 1 << 1,
+        CellNotWalkable = 1 << 2,
+        CellNotPathable = 1 << 3
+    };
+
+    struct Cell
+    {
+        uint8_t flags{ 0 };
+        uint16_t speed{ 100 };
+    };
+
+    // describes the tile at the given position, called at most once per position per window searched
+    using CellSampler = std::function<Cell(const Position&)>;
+
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> find(const Position& start, const Position& goal,
+                                                                      int maxComplexity, int flags, const CellSampler& sampler);
+
+    // amount of nodes reached by the last search
+    uint32_t getLastComplexity() const { return m_reached; }
+
+    // max distance (in tiles) from the start that a search can reach
+    static constexpr int32_t MAX_RADIUS = 512;
+
+    // a step costs the ground speed of the tile stepped into times the factor of its direction
+    static constexpr float STRAIGHT_FACTOR = 1.0f;
+    static constexpr float DIAGONAL_FACTOR = 3.0f;
+
+    // shared by PathFinder, PathPlanner and DistanceField
+    static constexpr Otc::Direction getStepDirection(const int dx, const int dy) { return NEIGHBOR_DIRECTIONS[dy + 1][dx + 1]; }
+    static constexpr std::pair<int8_t, int8_t> getStepOffset(const Otc::Direction dir) { return DIRECTION_OFFSETS[dir]; }
+    static constexpr float getStepFactor(const Otc::Direction dir) { return dir >= Otc::NorthEast ? DIAGONAL_FACTOR : STRAIGHT_FACTOR; }
+
+    // octile distance for a grid where a diagonal step costs DIAGONAL_FACTOR, which
+    // is never cheaper than two straight steps, so at least one tile of ground speed
+    // 100 is paid for every axis unit. Same unit scale as the euclidean estimate used before.
+    static float octileDistance(int32_t dx, int32_t dy);
+
+private:
+    // indexed by [dy + 1][dx + 1]
+    static constexpr Otc::Direction NEIGHBOR_DIRECTIONS[3][3] = {
+        { Otc::NorthWest, Otc::North, Otc::NorthEast },
+        { Otc::West, Otc::InvalidDirection, Otc::East },
+        { Otc::SouthWest, Otc::South, Otc::SouthEast }
+    };
+
+    // indexed by Otc::Direction
+    static constexpr std::array<std::pair<int8_t, int8_t>, 8> DIRECTION_OFFSETS = { {
+        { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 }, { 1, -1 }, { 1, 1 }, { -1, 1 }, { -1, -1 }
+    } };
+
+    static constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+
+    enum NodeState : uint8_t
+    {
+        NodeSampled = 1 << 6,
+        NodeReached = 1 << 7
+    };
+
+    struct Node
+    {
+        uint32_t generation;
+        float cost;
+        float totalCost;
+        uint32_t heapIndex;
+        uint16_t speed;
+        uint8_t flags; // CellFlags | NodeState
+        uint8_t dir;
+    };
+
+    void prepare(const Position& start, int32_t radius);
+    // searches the prepared window, clipped tells whether a bigger window could change the result
+    Otc::PathFindResult search(const Position& start, const Position& goal, int maxComplexity, int flags, const CellSampler& sampler, bool& clipped);
+    Node* getNode(int32_t x, int32_t y);
+    uint32_t getNodeIndex(const Node* node) const { return static_cast<uint32_t>(node - m_nodes.data()); }
+    Position getNodePosition(uint32_t index, uint8_t z) const
+    {
+        return { m_originX + static_cast<int32_t>(index % m_side), m_originY + static_cast<int32_t>(index / m_side), z };
+    }
+
+    void heapPush(uint32_t index);
+    void heapUpdate(uint32_t index);
+    uint32_t heapPop();
+    void heapSiftUp(uint32_t pos);
+    void heapSiftDown(uint32_t pos);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_heap;
+
+    uint32_t m_generation{ 0 };
+    uint32_t m_reached{ 0 };
+    uint32_t m_side{ 0 };
+
+    int32_t m_originX{ 0 };
+    int32_t m_originY{ 0 };
+};
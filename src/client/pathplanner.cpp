@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pathplanner.h"
+
+namespace
+{
+    constexpr int32_t MIN_RADIUS = 32;
+    constexpr int32_t RADIUS_MARGIN = 32;
+
+    constexpr float INF = std::numeric_limits<float>::infinity();
+
+    constexpr uint8_t CELL_FLAGS = PathFinder::CellWasSeen | PathFinder::CellHasCreature | PathFinder::CellNotWalkable | PathFinder::CellNotPathable;
+
+    int32_t distance(const Position& a, const Position& b)
+    {
+        return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+    }
+}
+
+PathPlanner::PathPlanner(const Position& start, const Position& goal, const int flags, PathFinder::CellSampler sampler) :
+    m_sampler(std::move(sampler)), m_start(start), m_goal(goal), m_flags(flags)
+{}
+
+void PathPlanner::setStart(const Position& start)
+{
+    if (start.z != m_start.z)
+        reset();
+
+    m_start = start;
+}
+
+void PathPlanner::setGoal(const Position& goal)
+{
+    if (goal == m_goal)
+        return;
+
+    m_goal = goal;
+    reset();
+}
+
+void PathPlanner::onTileUpdate(const Position& pos)
+{
+    if (m_window == 0 || pos.z != m_goal.z)
+        return;
+
+    const int32_t index = getNodeIndex(pos.x, pos.y);
+    if (index < 0)
+        return;
+
+    // positions that were never looked at don't take part in the search yet
+    auto& node = m_nodes[index];
+    if ((node.flags & NodeSampled) && !(node.flags & NodeChanged)) {
+        node.flags |= NodeChanged;
+        m_changed.push_back(index);
+    }
+}
+
+std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> PathPlanner::getPath()
+{
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
+    auto& [dirs, result] = ret;
+
+    result = Otc::PathFindResultNoWay;
+    m_expanded = 0;
+
+    if (m_start == m_goal) {
+        result = Otc::PathFindResultSamePosition;
+        return ret;
+    }
+
+    if (m_start.z != m_goal.z) {
+        result = Otc::PathFindResultImpossible;
+        return ret;
+    }
+
+    if (distance(m_start, m_goal) > MAX_DISTANCE) {
+        result = Otc::PathFindResultTooFar;
+        return ret;
+    }
+
+    if (m_window == 0 || getNodeIndex(m_start.x, m_start.y) < 0)
+        initialize();
+
+    // the keys already queued become lower bounds, as in the original D* Lite
+    if (m_start != m_lastStart) {
+        m_km += PathFinder::octileDistance(m_lastStart.x - m_start.x, m_lastStart.y - m_start.y);
+        m_lastStart = m_start;
+    }
+
+    for (const uint32_t index : m_changed) {
+        auto& node = m_nodes[index];
+        node.flags &= ~NodeChanged;
+
+        const uint8_t oldFlags = node.flags & CELL_FLAGS;
+        const uint16_t oldSpeed = node.speed;
+        sample(index);
+        if ((node.flags & CELL_FLAGS) == oldFlags && node.speed == oldSpeed)
+            continue;
+
+        // the cost of every edge leading into the changed node is different now
+        const auto& pos = getNodePosition(index);
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                if (const int32_t neighbor = getNodeIndex(pos.x + i, pos.y + j); neighbor >= 0)
+                    updateVertex(neighbor);
+            }
+        }
+    }
+    m_changed.clear();
+
+    const uint32_t goalIndex = getNodeIndex(m_goal.x, m_goal.y);
+    if (!(m_nodes[goalIndex].flags & NodeSampled))
+        sample(goalIndex);
+
+    // check the goal pos is walkable
+    if (m_nodes[goalIndex].flags & PathFinder::CellNotWalkable)
+        return ret;
+
+    // ran out of budget, the next call resumes from where this one stopped
+    if (!computeShortestPath()) {
+        result = Otc::PathFindResultTooFar;
+        return ret;
+    }
+
+    uint32_t current = getNodeIndex(m_start.x, m_start.y);
+    if (m_nodes[current].g == INF) {
+        // the search was cut by the window before exhausting the reachable area
+        if (m_clipped)
+            result = Otc::PathFindResultTooFar;
+        return ret;
+    }
+
+    while (current != goalIndex && dirs.size() < m_nodes.size()) {
+        const auto& pos = getNodePosition(current);
+
+        float bestCost = INF;
+        int32_t best = -1;
+        Otc::Direction bestDir = Otc::InvalidDirection;
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                const int32_t neighbor = getNodeIndex(pos.x + i, pos.y + j);
+                if (neighbor < 0)
+                    continue;
+
+                const float cost = getStepCost(current, neighbor) + m_nodes[neighbor].g;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = neighbor;
+                    bestDir = PathFinder::getStepDirection(i, j);
+                }
+            }
+        }
+
+        if (best < 0) {
+            dirs.clear();
+            return ret;
+        }
+
+        dirs.push_back(bestDir);
+        current = best;
+    }
+
+    result = current == goalIndex ? Otc::PathFindResultOk : Otc::PathFindResultNoWay;
+    if (result != Otc::PathFindResultOk)
+        dirs.clear();
+
+    return ret;
+}
+
+void PathPlanner::initialize()
+{
+    const int32_t radius = std::clamp(distance(m_start, m_goal) + RADIUS_MARGIN, MIN_RADIUS, MAX_DISTANCE + RADIUS_MARGIN);
+
+    m_window = static_cast<uint32_t>(radius);
+    m_side = m_window * 2 + 1;
+    m_originX = m_goal.x - radius;
+    m_originY = m_goal.y - radius;
+
+    m_nodes.assign(static_cast<size_t>(m_side) * m_side, Node{ .g = INF, .rhs = INF, .k1 = INF, .k2 = INF, .heapIndex = NOT_IN_HEAP, .speed = 100, .flags = 0 });
+    m_heap.clear();
+    m_changed.clear();
+
+    m_km = 0;
+    m_clipped = false;
+    m_lastStart = m_start;
+
+    const uint32_t goalIndex = getNodeIndex(m_goal.x, m_goal.y);
+    m_nodes[goalIndex].rhs = 0;
+    calculateKey(goalIndex);
+    heapPush(goalIndex);
+}
+
+bool PathPlanner::computeShortestPath()
+{
+    const uint32_t startIndex = getNodeIndex(m_start.x, m_start.y);
+
+    while (!m_heap.empty()) {
+        // the start may be queued, so its key is computed aside instead of touching the heap
+        const auto& start = m_nodes[startIndex];
+        const float startK2 = std::min(start.g, start.rhs);
+        const float startK1 = startK2 + m_km;
+
+        const uint32_t top = m_heap.front();
+        const auto& topNode = m_nodes[top];
+        const bool topIsLess = topNode.k1 < startK1 || (topNode.k1 == startK1 && topNode.k2 < startK2);
+        if (!topIsLess && start.rhs == start.g)
+            break;
+
+        if (m_expanded >= static_cast<uint32_t>(std::max(m_maxComplexity, 0)))
+            return false;
+
+        ++m_expanded;
+
+        auto& node = m_nodes[top];
+        const float oldK1 = node.k1;
+        const float oldK2 = node.k2;
+        calculateKey(top);
+        if (oldK1 < node.k1 || (oldK1 == node.k1 && oldK2 < node.k2)) {
+            heapSiftDown(node.heapIndex);
+            continue;
+        }
+
+        const bool overConsistent = node.g > node.rhs;
+        if (overConsistent) {
+            node.g = node.rhs;
+            heapRemove(top);
+        } else {
+            node.g = INF;
+            updateVertex(top);
+        }
+
+        const auto& pos = getNodePosition(top);
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                const int32_t x = pos.x + i;
+                const int32_t y = pos.y + j;
+                if (x < 0 || y < 0)
+                    continue;
+
+                const int32_t neighbor = getNodeIndex(x, y);
+                if (neighbor < 0) {
+                    m_clipped = true;
+                    continue;
+                }
+
+                updateVertex(neighbor);
+            }
+        }
+    }
+
+    return true;
+}
+
+void PathPlanner::calculateKey(const uint32_t index)
+{
+    auto& node = m_nodes[index];
+    node.k2 = std::min(node.g, node.rhs);
+    node.k1 = node.k2 + heuristic(index) + m_km;
+}
+
+void PathPlanner::updateVertex(const uint32_t index)
+{
+    auto& node = m_nodes[index];
+    if (index != static_cast<uint32_t>(getNodeIndex(m_goal.x, m_goal.y)))
+        node.rhs = getMinSuccessorCost(index);
+
+    if (node.g != node.rhs) {
+        calculateKey(index);
+        if (node.heapIndex == NOT_IN_HEAP)
+            heapPush(index);
+        else
+            heapUpdate(index);
+    } else if (node.heapIndex != NOT_IN_HEAP)
+        heapRemove(index);
+}
+
+float PathPlanner::getMinSuccessorCost(const uint32_t index)
+{
+    const auto& pos = getNodePosition(index);
+
+    float cost = INF;
+    for (int i = -1; i <= 1; ++i) {
+        for (int j = -1; j <= 1; ++j) {
+            if (i == 0 && j == 0)
+                continue;
+
+            const int32_t neighbor = getNodeIndex(pos.x + i, pos.y + j);
+            if (neighbor < 0 || m_nodes[neighbor].g == INF)
+                continue;
+
+            cost = std::min(cost, getStepCost(index, neighbor) + m_nodes[neighbor].g);
+        }
+    }
+    return cost;
+}
+
+float PathPlanner::getStepCost(const uint32_t from, const uint32_t to)
+{
+    if (!isPassable(to))
+        return INF;
+
+    const bool diagonal = (from % m_side) != (to % m_side) && (from / m_side) != (to / m_side);
+    return (m_nodes[to].speed * (diagonal ? PathFinder::DIAGONAL_FACTOR : PathFinder::STRAIGHT_FACTOR)) / 100.0f;
+}
+
+bool PathPlanner::isPassable(const uint32_t index)
+{
+    auto& node = m_nodes[index];
+    if (!(node.flags & NodeSampled))
+        sample(index);
+
+    // same rules as PathFinder::find
+    const bool wasSeen = node.flags & PathFinder::CellWasSeen;
+    if (!(m_flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+        return false;
+
+    if (wasSeen) {
+        if (!(m_flags & Otc::PathFindAllowNonWalkable) && (node.flags & PathFinder::CellNotWalkable))
+            return false;
+
+        if (index != static_cast<uint32_t>(getNodeIndex(m_goal.x, m_goal.y))) {
+            if (!(m_flags & Otc::PathFindAllowCreatures) && (node.flags & PathFinder::CellHasCreature))
+                return false;
+            if (!(m_flags & Otc::PathFindAllowNonPathable) && (node.flags & PathFinder::CellNotPathable))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void PathPlanner::sample(const uint32_t index)
+{
+    auto& node = m_nodes[index];
+    const auto& cell = m_sampler(getNodePosition(index));
+    node.flags = (node.flags & ~CELL_FLAGS) | (cell.flags & CELL_FLAGS) | NodeSampled;
+    node.speed = cell.speed;
+}
+
+int32_t PathPlanner::getNodeIndex(const int32_t x, const int32_t y) const
+{
+    const auto localX = static_cast<uint32_t>(x - m_originX);
+    const auto localY = static_cast<uint32_t>(y - m_originY);
+    if (localX >= m_side || localY >= m_side)
+        return -1;
+
+    return static_cast<int32_t>(localY * m_side + localX);
+}
+
+float PathPlanner::heuristic(const uint32_t index) const
+{
+    const auto& pos = getNodePosition(index);
+    return PathFinder::octileDistance(pos.x - m_start.x, pos.y - m_start.y);
+}
+
+void PathPlanner::heapPush(const uint32_t index)
+{
+    m_nodes[index].heapIndex = static_cast<uint32_t>(m_heap.size());
+    m_heap.push_back(index);
+    heapSiftUp(m_nodes[index].heapIndex);
+}
+
+void PathPlanner::heapRemove(const uint32_t index)
+{
+    const uint32_t pos = m_nodes[index].heapIndex;
+    m_nodes[index].heapIndex = NOT_IN_HEAP;
+
+    const uint32_t last = m_heap.back();
+    m_heap.pop_back();
+    if (last == index)
+        return;
+
+    m_heap[pos] = last;
+    m_nodes[last].heapIndex = pos;
+    heapSiftUp(pos);
+    heapSiftDown(m_nodes[last].heapIndex);
+}
+
+void PathPlanner::heapUpdate(const uint32_t index)
+{
+    // unlike PathFinder, keys can move in both directions here
+    heapSiftUp(m_nodes[index].heapIndex);
+    heapSiftDown(m_nodes[index].heapIndex);
+}
+
+bool PathPlanner::heapLess(const uint32_t a, const uint32_t b) const
+{
+    const auto& nodeA = m_nodes[a];
+    const auto& nodeB = m_nodes[b];
+    return nodeA.k1 < nodeB.k1 || (nodeA.k1 == nodeB.k1 && nodeA.k2 < nodeB.k2);
+}
+
+void PathPlanner::heapSiftUp(uint32_t pos)
+{
+    const uint32_t index = m_heap[pos];
+
+    while (pos > 0) {
+        const uint32_t parentPos = (pos - 1) / 2;
+        const uint32_t parent = m_heap[parentPos];
+        if (!heapLess(index, parent))
+            break;
+
+        m_heap[pos] = parent;
+        m_nodes[parent].heapIndex = pos;
+        pos = parentPos;
+    }
+
+    m_heap[pos] = index;
+    m_nodes[index].heapIndex = pos;
+}
+
+void PathPlanner::heapSiftDown(uint32_t pos)
+{
+    const uint32_t index = m_heap[pos];
+    const auto size = static_cast<uint32_t>(m_heap.size());
+
+    while (true) {
+        uint32_t childPos = pos * 2 + 1;
+        if (childPos >= size)
+            break;
+
+        if (childPos + 1 < size && heapLess(m_heap[childPos + 1], m_heap[childPos]))
+            ++childPos;
+
+        const uint32_t child = m_heap[childPos];
+        if (!heapLess(child, index))
+            break;
+
+        m_heap[pos] = child;
+        m_nodes[child].heapIndex = pos;
+        pos = childPos;
+    }
+
+    m_heap[pos] = index;
+    m_nodes[index].heapIndex = pos;
+}
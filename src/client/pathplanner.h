@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+#include "pathfinder.h"
+#include <framework/luaengine/luaobject.h>
+
+// D* Lite planner bound to a goal. The search runs backwards from the goal,
+// so moving the start or changing a few tiles only repairs the affected part
+// of the search instead of exploring the whole area again.
+// Tile changes are fed by Map::notificateTileUpdate.
+ // @bindclass
+class PathPlanner final : public LuaObject
+{
+public:
+    PathPlanner(const Position& start, const Position& goal, int flags, PathFinder::CellSampler sampler);
+
+    void setStart(const Position& start);
+    void setGoal(const Position& goal);
+    void setMaxComplexity(const int maxComplexity) { m_maxComplexity = maxComplexity; }
+
+    Position getStart() const { return m_start; }
+    Position getGoal() const { return m_goal; }
+    int getFlags() const { return m_flags; }
+    int getMaxComplexity() const { return m_maxComplexity; }
+
+    // amount of nodes expanded by the last getPath call
+    uint32_t getLastComplexity() const { return m_expanded; }
+
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> getPath();
+
+    // marks a position as changed, it will be sampled again in the next getPath call
+    void onTileUpdate(const Position& pos);
+
+    // drops the whole search, next getPath call starts from scratch
+    void reset() { m_window = 0; }
+
+    // max distance (in tiles) between the start and the goal
+    static constexpr int32_t MAX_DISTANCE = 128;
+
+private:
+    static constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+
+    enum NodeState : uint8_t
+    {
+        NodeSampled = 1 << 6,
+        NodeChanged = 1 << 7
+    };
+
+    struct Node
+    {
+        float g;
+        float rhs;
+        float k1;
+        float k2;
+        uint32_t heapIndex;
+        uint16_t speed;
+        uint8_t flags; // PathFinder::CellFlags | NodeState
+    };
+
+    void initialize();
+    bool computeShortestPath();
+    void calculateKey(uint32_t index);
+    void updateVertex(uint32_t index);
+    float getMinSuccessorCost(uint32_t index);
+    float getStepCost(uint32_t from, uint32_t to);
+    bool isPassable(uint32_t index);
+    void sample(uint32_t index);
+
+    int32_t getNodeIndex(int32_t x, int32_t y) const;
+    Position getNodePosition(uint32_t index) const
+    {
+        return { m_originX + static_cast<int32_t>(index % m_side), m_originY + static_cast<int32_t>(index / m_side), m_goal.z };
+    }
+    float heuristic(uint32_t index) const;
+
+    void heapPush(uint32_t index);
+    void heapRemove(uint32_t index);
+    void heapUpdate(uint32_t index);
+    void heapSiftUp(uint32_t pos);
+    void heapSiftDown(uint32_t pos);
+    bool heapLess(uint32_t a, uint32_t b) const;
+
+    PathFinder::CellSampler m_sampler;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_heap;
+    std::vector<uint32_t> m_changed;
+
+    Position m_start;
+    Position m_goal;
+    Position m_lastStart;
+
+    int m_flags{ 0 };
+    int m_maxComplexity{ 10000 };
+
+    float m_km{ 0 };
+    bool m_clipped{ false };
+
+    uint32_t m_window{ 0 };
+    uint32_t m_side{ 0 };
+    uint32_t m_expanded{ 0 };
+
+    int32_t m_originX{ 0 };
+    int32_t m_originY{ 0 };
+};
@@ -24,6 +24,10 @@
 #include "game.h"
 #include "protocolgame.h"
 
+std::bitset<256> ProtocolGame::m_luaOpcodes;
+uint64_t ProtocolGame::m_luaOpcodeCalls = 0;
+uint64_t ProtocolGame::m_avoidedLuaOpcodeCalls = 0;
+
 void ProtocolGame::login(const std::string_view accountName, const std::string_view accountPassword, const std::string_view host, uint16_t port,
                          const std::string_view characterName, const std::string_view authenticatorToken, const std::string_view sessionKey)
 {
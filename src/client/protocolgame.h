@@ -26,6 +26,8 @@
 #include "framework/net/protocol.h"
 #include "staticdata.h"
 
+class ProtocolParseStats;
+
 class ProtocolGame final : public Protocol
 {
 public:
@@ -164,6 +166,16 @@ public:
     // otclient only
     void sendChangeMapAwareRange(uint8_t xrange, uint8_t yrange);
 
+    // times every parsed opcode, nullptr disables it
+    void setParseStats(ProtocolParseStats* stats) { m_parseStats = stats; }
+
+    // opcodes handed to the Lua onOpcode callback, the others are parsed without entering Lua
+    static void setLuaOpcode(const uint8_t opcode, const bool enabled) { m_luaOpcodes.set(opcode, enabled); }
+    static bool isLuaOpcode(const uint8_t opcode) { return m_luaOpcodes.test(opcode); }
+    static uint64_t getLuaOpcodeCalls() { return m_luaOpcodeCalls; }
+    static uint64_t getAvoidedLuaOpcodeCalls() { return m_avoidedLuaOpcodeCalls; }
+    static void resetLuaOpcodeCounters() { m_luaOpcodeCalls = m_avoidedLuaOpcodeCalls = 0; }
+
 protected:
     void onConnect() override;
     void onRecv(const InputMessagePtr& inputMessage) override;
@@ -388,6 +400,12 @@ private:
 
     ticks_t m_lastPartyAnalyzerCall{ 0 };
 
+    ProtocolParseStats* m_parseStats{ nullptr };
+
+    static std::bitset<256> m_luaOpcodes;
+    static uint64_t m_luaOpcodeCalls;
+    static uint64_t m_avoidedLuaOpcodeCalls;
+
     std::string m_accountName;
     std::string m_accountPassword;
     std::string m_authenticatorToken;
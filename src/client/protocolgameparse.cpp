@@ -30,6 +30,7 @@
 #include "localplayer.h"
 #include "protocolgame.h"
 #include "protocolcodes.h"
+#include "protocolreplay.h"
 #include "luavaluecasts_client.h"
 #include "map.h"
 #include "mapview.h"
@@ -48,6 +49,9 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
         while (!msg->eof()) {
             opcode = msg->getU8();
 
+            if (m_parseStats)
+                m_parseStats->beginOpcode(opcode);
+
             // must be > so extended will be enabled before GameStart.
             if (!g_game.getFeature(Otc::GameLoginPending)) {
                 if (!m_gameInitialized && opcode > Proto::GameServerFirstGameOpcode) {
@@ -56,13 +60,24 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                 }
             }
 
-            // try to parse in lua first
-            const int readPos = msg->getReadPos();
-            if (callLuaField<bool>("onOpcode", opcode, msg)) {
-                continue;
+            // try to parse in lua first, only for the opcodes some module registered
+            if (m_luaOpcodes.test(opcode)) {
+                ++m_luaOpcodeCalls;
+
+                const int readPos = msg->getReadPos();
+                if (m_parseStats)
+                    m_parseStats->beginLua();
+                const bool parsedByLua = callLuaField<bool>("onOpcode", opcode, msg);
+                if (m_parseStats)
+                    m_parseStats->endLua(parsedByLua);
+                if (parsedByLua) {
+                    continue;
+                }
+                // restore read pos
+                msg->setReadPos(readPos);
+            } else {
+                ++m_avoidedLuaOpcodeCalls;
             }
-            msg->setReadPos(readPos);
-            // restore read pos
 
             switch (opcode) {
                 case Proto::GameServerLoginOrPendingState:
@@ -664,7 +679,13 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
             e.what(),
             hexDump.str()
         );
+
+        if (m_parseStats)
+            m_parseStats->addError();
     }
+
+    if (m_parseStats)
+        m_parseStats->endOpcode();
 }
 
 void ProtocolGame::parseLogin(const InputMessagePtr& msg) const
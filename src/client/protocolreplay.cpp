@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "protocolreplay.h"
+#include "protocolgame.h"
+
+#include <framework/core/clock.h>
+#include <framework/core/eventdispatcher.h>
+#include <framework/net/packet_record.h>
+
+#if ENABLE_ALLOCATION_COUNTER == 1
+namespace
+{
+    thread_local uint64_t t_allocations = 0;
+
+    void* countedAlloc(const size_t size)
+    {
+        ++t_allocations;
+        if (void* ptr = std::malloc(size ? size : 1))
+            return ptr;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(const size_t size) { return countedAlloc(size); }
+void* operator new[](const size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+#endif
+
+namespace
+{
+    uint64_t nowNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double toMillis(const uint64_t nanos) { return nanos / 1000000.0; }
+    double toMicros(const uint64_t nanos) { return nanos / 1000.0; }
+}
+
+uint64_t ProtocolParseStats::getAllocationCount()
+{
+#if ENABLE_ALLOCATION_COUNTER == 1
+    return t_allocations;
+#else
+    return 0;
+#endif
+}
+
+bool ProtocolParseStats::isCountingAllocations()
+{
+#if ENABLE_ALLOCATION_COUNTER == 1
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProtocolParseStats::beginOpcode(const uint8_t opcode)
+{
+    endOpcode();
+
+    m_current = opcode;
+    m_allocationsBegin = getAllocationCount();
+    m_begin = nowNanos();
+}
+
+void ProtocolParseStats::endOpcode()
+{
+    if (m_current < 0)
+        return;
+
+    const uint64_t nanos = nowNanos() - m_begin;
+
+    auto& opcode = m_opcodes[m_current];
+    ++opcode.count;
+    opcode.nanos += nanos;
+    opcode.maxNanos = std::max<uint64_t>(opcode.maxNanos, nanos);
+    opcode.allocations += getAllocationCount() - m_allocationsBegin;
+
+    const size_t bucket = std::max<size_t>(std::bit_width(nanos), 1) - 1;
+    ++opcode.histogram[std::min<size_t>(bucket, HISTOGRAM_BUCKETS - 1)];
+
+    m_current = -1;
+}
+
+void ProtocolParseStats::beginLua()
+{
+    m_luaBegin = nowNanos();
+}
+
+void ProtocolParseStats::endLua(const bool parsed)
+{
+    if (m_current < 0)
+        return;
+
+    auto& opcode = m_opcodes[m_current];
+    opcode.luaNanos += nowNanos() - m_luaBegin;
+    if (parsed)
+        ++opcode.luaParsed;
+}
+
+void ProtocolParseStats::reset()
+{
+    m_opcodes.fill({});
+    m_current = -1;
+    m_errors = 0;
+}
+
+uint64_t ProtocolParseStats::getPercentile(const Opcode& opcode, const double percentile)
+{
+    if (opcode.count == 0)
+        return 0;
+
+    const auto target = static_cast<uint64_t>(std::ceil(opcode.count * std::clamp(percentile, 0.0, 1.0)));
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS - 1; ++i) {
+        total += opcode.histogram[i];
+        if (total >= target)
+            return uint64_t{ 1 } << (i + 1);
+    }
+    return opcode.maxNanos;
+}
+
+bool ProtocolReplay::run(const ProtocolGamePtr& protocol, const std::string& file)
+{
+    PacketRecordReader reader;
+    if (!reader.open(file))
+        return false;
+
+    // read the whole record first, so disk and decompression are not measured
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> packets;
+    PacketRecordReader::Frame frame;
+    while (reader.next(frame)) {
+        if (frame.direction == PacketRecordInput)
+            packets.emplace_back(std::move(frame.data));
+    }
+
+    m_stats.reset();
+    m_messages = m_bytes = m_parseNanos = m_dispatchNanos = m_allocations = 0;
+
+    const uint64_t luaCalls = ProtocolGame::getLuaOpcodeCalls();
+    const uint64_t avoidedLuaCalls = ProtocolGame::getAvoidedLuaOpcodeCalls();
+
+    protocol->setParseStats(&m_stats);
+    for (const auto& packet : packets) {
+        const uint64_t allocations = ProtocolParseStats::getAllocationCount();
+        const uint64_t begin = nowNanos();
+
+        protocol->receivePacket(packet->data(), packet->size());
+
+        const uint64_t end = nowNanos();
+        m_parseNanos += end - begin;
+        m_allocations += ProtocolParseStats::getAllocationCount() - allocations;
+        m_bytes += packet->size();
+        ++m_messages;
+
+        // run what the parser scheduled, like the main loop does between packets
+        g_clock.update();
+        g_dispatcher.poll();
+        m_dispatchNanos += nowNanos() - end;
+    }
+    protocol->setParseStats(nullptr);
+
+    m_luaCalls = ProtocolGame::getLuaOpcodeCalls() - luaCalls;
+    m_avoidedLuaCalls = ProtocolGame::getAvoidedLuaOpcodeCalls() - avoidedLuaCalls;
+
+    return true;
+}
+
+std::string ProtocolReplay::getReport() const
+{
+    const double seconds = m_parseNanos / 1000000000.0;
+    const bool allocations = ProtocolParseStats::isCountingAllocations();
+
+    std::string report = fmt::format("Parsed {} messages ({} KB) in {:.2f} ms, {:.0f} messages/s, {:.2f} MB/s\n",
+                                     m_messages, m_bytes / 1024, toMillis(m_parseNanos),
+                                     seconds > 0 ? m_messages / seconds : 0.0,
+                                     seconds > 0 ? m_bytes / seconds / (1024 * 1024) : 0.0);
+    report += fmt::format("Dispatcher events: {:.2f} ms, parse errors: {}, allocations: {}\n",
+                          toMillis(m_dispatchNanos), m_stats.getErrors(),
+                          allocations ? std::to_string(m_allocations) : "not counted");
+
+    std::vector<uint8_t> opcodes;
+    uint64_t luaNanos = 0;
+    for (int i = 0; i < 256; ++i) {
+        const auto& opcode = m_stats.getOpcode(i);
+        if (opcode.count == 0)
+            continue;
+        opcodes.emplace_back(i);
+        luaNanos += opcode.luaNanos;
+    }
+    report += fmt::format("Lua onOpcode: {:.2f} ms ({:.1f}% of parse time), {} calls, {} avoided\n",
+                          toMillis(luaNanos), m_parseNanos > 0 ? luaNanos * 100.0 / m_parseNanos : 0.0,
+                          m_luaCalls, m_avoidedLuaCalls);
+
+    std::ranges::sort(opcodes, [this](const uint8_t a, const uint8_t b) {
+        return m_stats.getOpcode(a).nanos > m_stats.getOpcode(b).nanos;
+    });
+
+    report += fmt::format("{:>6} {:>9} {:>10} {:>9} {:>9} {:>9} {:>9} {:>10} {:>9} {:>9}\n",
+                          "opcode", "count", "total ms", "avg us", "p50 us", "p99 us", "max us", "lua ms", "lua hits", "allocs");
+    for (const auto id : opcodes) {
+        const auto& opcode = m_stats.getOpcode(id);
+        report += fmt::format("  0x{:02X} {:>9} {:>10.3f} {:>9.2f} {:>9.2f} {:>9.2f} {:>9.2f} {:>10.3f} {:>9} {:>9}\n",
+                              id, opcode.count, toMillis(opcode.nanos), toMicros(opcode.nanos) / opcode.count,
+                              toMicros(ProtocolParseStats::getPercentile(opcode, 0.5)),
+                              toMicros(ProtocolParseStats::getPercentile(opcode, 0.99)),
+                              toMicros(opcode.maxNanos), toMillis(opcode.luaNanos), opcode.luaParsed,
+                              allocations ? std::to_string(opcode.allocations) : "-");
+    }
+
+    return report;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "declarations.h"
+
+// Per opcode parse statistics of ProtocolGame::parseMessage.
+// Times include the Lua onOpcode call, which is also accounted on its own.
+class ProtocolParseStats
+{
+public:
+    // bucket i holds parse times in [2^i, 2^(i+1)) nanoseconds, the last one everything above
+    static constexpr size_t HISTOGRAM_BUCKETS = 28;
+
+    struct Opcode
+    {
+        uint64_t count{ 0 };
+        uint64_t nanos{ 0 };
+        uint64_t maxNanos{ 0 };
+        uint64_t luaNanos{ 0 };
+        uint64_t luaParsed{ 0 };
+        uint64_t allocations{ 0 };
+        std::array<uint32_t, HISTOGRAM_BUCKETS> histogram{};
+    };
+
+    void beginOpcode(uint8_t opcode);
+    void endOpcode();
+    void beginLua();
+    void endLua(bool parsed);
+    void addError() { ++m_errors; }
+
+    void reset();
+
+    const Opcode& getOpcode(const uint8_t opcode) const { return m_opcodes[opcode]; }
+    uint64_t getErrors() const { return m_errors; }
+
+    // upper bound of the bucket holding the given percentile (0..1), in nanoseconds
+    static uint64_t getPercentile(const Opcode& opcode, double percentile);
+
+    // heap allocations made by the current thread, always 0 unless built with ENABLE_ALLOCATION_COUNTER
+    static uint64_t getAllocationCount();
+    static bool isCountingAllocations();
+
+private:
+    std::array<Opcode, 256> m_opcodes;
+
+    int m_current{ -1 };
+    uint64_t m_begin{ 0 };
+    uint64_t m_luaBegin{ 0 };
+    uint64_t m_allocationsBegin{ 0 };
+    uint64_t m_errors{ 0 };
+};
+
+// Feeds the input packets of a record to ProtocolGame::parseMessage back to back,
+// ignoring the recorded time, so the parser can be measured on real traffic.
+class ProtocolReplay
+{
+public:
+    // the game must be ready to parse, like when playing a record
+    bool run(const ProtocolGamePtr& protocol, const std::string& file);
+
+    const ProtocolParseStats& getStats() const { return m_stats; }
+    std::string getReport() const;
+
+private:
+    ProtocolParseStats m_stats;
+
+    uint64_t m_messages{ 0 };
+    uint64_t m_bytes{ 0 };
+    uint64_t m_parseNanos{ 0 };
+    uint64_t m_dispatchNanos{ 0 };
+    uint64_t m_allocations{ 0 };
+    uint64_t m_luaCalls{ 0 };
+    uint64_t m_avoidedLuaCalls{ 0 };
+};
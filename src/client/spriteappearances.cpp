@@ -28,6 +28,7 @@
 #include "framework/core/filestream.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/graphics/image.h"
+#include "framework/graphics/pixelkernels.h"
 
  // warnings related to protobuf
     // https://android.googlesource.com/platform/external/protobuf/+/brillo-m9-dev/vsprojects/readme.txt
@@ -108,21 +109,74 @@ int SpriteSheet::getSpritesPerSheet() const
     return getColumns() * spritesPerColumn;
 }
 
-bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
+std::shared_ptr<uint8_t[]> SpriteAppearances::getSheetPixels(const SpriteSheetPtr& sheet)
 {
-    if (sheet->m_loadingState.load(std::memory_order_acquire) == SpriteLoadState::LOADING)
-        return false;
-
-    if (sheet->data)
-        return true;
+    {
+        std::scoped_lock l(m_cacheMutex);
+        if (sheet->data) {
+            ++m_cacheHits;
+            m_cachedSheets.splice(m_cachedSheets.begin(), m_cachedSheets, sheet->m_cacheIt);
+            return sheet->data;
+        }
+    }
 
     if (sheet->m_loadingState.exchange(SpriteLoadState::LOADING, std::memory_order_acq_rel) == SpriteLoadState::LOADING)
-        return false;
+        return nullptr;
+
+    auto pixels = decodeSpriteSheet(sheet);
+    if (!pixels) {
+        sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
+        return nullptr;
+    }
 
+    std::scoped_lock l(m_cacheMutex);
+    ++m_cacheMisses;
+
+    // another thread may have decoded it in the meantime
+    if (sheet->data) {
+        m_cachedSheets.splice(m_cachedSheets.begin(), m_cachedSheets, sheet->m_cacheIt);
+        pixels = sheet->data;
+    } else {
+        // pixels is still held here, so the new sheet itself is never evicted
+        sheet->data = pixels;
+        sheet->m_cacheIt = m_cachedSheets.emplace(m_cachedSheets.begin(), sheet.get());
+        m_cacheUsage += BYTES_IN_SPRITE_SHEET;
+        evictSheets();
+    }
+
+    sheet->m_loadingState.store(SpriteLoadState::LOADED, std::memory_order_release);
+    return pixels;
+}
+
+void SpriteAppearances::evictSheets()
+{
+    // sheets still referenced outside the cache are in use and skipped
+    for (auto it = m_cachedSheets.end(); m_cacheUsage > m_cacheLimit && it != m_cachedSheets.begin();) {
+        auto* sheet = *--it;
+        if (sheet->data.use_count() > 1)
+            continue;
+
+        sheet->data = nullptr;
+        sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
+        it = m_cachedSheets.erase(it);
+
+        m_cacheUsage -= BYTES_IN_SPRITE_SHEET;
+        ++m_cacheEvictions;
+    }
+}
+
+std::shared_ptr<uint8_t[]> SpriteAppearances::decodeSpriteSheet(const SpriteSheetPtr& sheet)
+{
     try {
-        const auto& path = fmt::format("{}{}", g_spriteAppearances.getPath(), sheet->file);
+        const auto& path = fmt::format("{}{}", m_path, sheet->file);
         if (!g_resources.fileExists(path))
-            return false;
+            return nullptr;
+
+        std::shared_ptr<uint8_t[]> pixels(new uint8_t[BYTES_IN_SPRITE_SHEET]);
+
+        const ticks_t sourceTime = g_resources.getFileTime(path);
+        if (m_diskCache.load(sheet->file, sourceTime, pixels.get()))
+            return pixels;
 
         const auto& fin = g_resources.openFile(path);
         fin->cache(true);
@@ -197,47 +251,71 @@ bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
 
         uint8_t* bufferStart = decompressBuffer.data() + bmpDataOffset;
 
-        // swap BGR ? RGB and fix magenta
-        for (int i = 0; i < BYTES_IN_SPRITE_SHEET; i += 4) {
-            std::swap(bufferStart[i], bufferStart[i + 2]); // B <-> R
-
-            const uint32_t rgb = bufferStart[i] | (bufferStart[i + 1] << 8) | (bufferStart[i + 2] << 16);
-            if (rgb == 0xFF00FF) {
-                bufferStart[i + 0] = 0x00;
-                bufferStart[i + 1] = 0x00;
-                bufferStart[i + 2] = 0x00;
-                bufferStart[i + 3] = 0x00;
-            }
-        }
-
-        // vertical flip
-        constexpr int halfHeight = SpriteSheet::SIZE / 2;
-        uint8_t tempLine[SPRITE_SHEET_WIDTH_BYTES];
-        for (int y = 0; y < halfHeight; ++y) {
-            uint8_t* top = bufferStart + y * SPRITE_SHEET_WIDTH_BYTES;
-            uint8_t* bottom = bufferStart + (SpriteSheet::SIZE - 1 - y) * SPRITE_SHEET_WIDTH_BYTES;
+        // swap BGR -> RGB, make magenta transparent and flip it vertically
+        Pixels::swizzleRedBlueClearColorKey(bufferStart, SpriteSheet::SIZE * SpriteSheet::SIZE, 0xFF00FF);
+        Pixels::flipRows(bufferStart, SPRITE_SHEET_WIDTH_BYTES, SpriteSheet::SIZE);
 
-            std::memcpy(tempLine, top, SPRITE_SHEET_WIDTH_BYTES);
-            std::memcpy(top, bottom, SPRITE_SHEET_WIDTH_BYTES);
-            std::memcpy(bottom, tempLine, SPRITE_SHEET_WIDTH_BYTES);
-        }
-
-        sheet->data = std::make_unique<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
-        std::memcpy(sheet->data.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
-
-        sheet->m_loadingState.store(SpriteLoadState::LOADED, std::memory_order_release);
-        return true;
+        std::memcpy(pixels.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
+        m_diskCache.store(sheet->file, sourceTime, pixels.get());
+        return pixels;
     } catch (const std::exception& e) {
-        sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
         g_logger.error("Failed to load single sprite sheet '{}': {}", sheet->file, e.what());
-        return false;
+        return nullptr;
     }
 }
 
 void SpriteAppearances::unload()
 {
+    std::scoped_lock l(m_cacheMutex);
     m_spritesCount = 0;
     m_sheets.clear();
+    m_cachedSheets.clear();
+    m_cacheUsage = 0;
+    m_diskCache.close();
+}
+
+void SpriteAppearances::addSpriteSheet(const SpriteSheetPtr& sheet)
+{
+    // the catalog is usually sorted, so this is an append
+    const auto it = std::ranges::upper_bound(m_sheets, sheet->firstId, {}, &SpriteSheet::firstId);
+    m_sheets.emplace(it, sheet);
+}
+
+void SpriteAppearances::setCacheLimit(const size_t bytes)
+{
+    std::scoped_lock l(m_cacheMutex);
+    m_cacheLimit = bytes;
+    evictSheets();
+}
+
+size_t SpriteAppearances::getCacheUsage() const
+{
+    std::scoped_lock l(m_cacheMutex);
+    return m_cacheUsage;
+}
+
+uint64_t SpriteAppearances::getCacheHits() const
+{
+    std::scoped_lock l(m_cacheMutex);
+    return m_cacheHits;
+}
+
+uint64_t SpriteAppearances::getCacheMisses() const
+{
+    std::scoped_lock l(m_cacheMutex);
+    return m_cacheMisses;
+}
+
+uint64_t SpriteAppearances::getCacheEvictions() const
+{
+    std::scoped_lock l(m_cacheMutex);
+    return m_cacheEvictions;
+}
+
+void SpriteAppearances::resetCacheStats()
+{
+    std::scoped_lock l(m_cacheMutex);
+    m_cacheHits = m_cacheMisses = m_cacheEvictions = 0;
 }
 
 SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, bool& isLoading, const bool load /* = true */)
@@ -246,15 +324,14 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, bool& isLoadi
         return nullptr;
     }
 
-    // find sheet
-    const auto sheetIt = std::ranges::find_if(m_sheets, [=](const SpriteSheetPtr& sheet) {
-        return id >= sheet->firstId && id <= sheet->lastId;
-    });
-
-    if (sheetIt == m_sheets.end())
+    // last sheet starting at or before id
+    const auto sheetIt = std::ranges::upper_bound(m_sheets, id, {}, &SpriteSheet::firstId);
+    if (sheetIt == m_sheets.begin())
         return nullptr;
 
-    const auto& sheet = *sheetIt;
+    const auto& sheet = *std::prev(sheetIt);
+    if (id > sheet->lastId)
+        return nullptr;
 
     if (load && !loadSpriteSheet(sheet)) {
         isLoading = sheet->m_loadingState == SpriteLoadState::LOADING;
@@ -267,11 +344,17 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, bool& isLoadi
 ImagePtr SpriteAppearances::getSpriteImage(const int id, bool& isLoading)
 {
     try {
-        const auto& sheet = getSheetBySpriteId(id, isLoading, true);
+        const auto& sheet = getSheetBySpriteId(id, isLoading, false);
         if (!sheet) {
             return nullptr;
         }
 
+        const auto& pixels = getSheetPixels(sheet);
+        if (!pixels) {
+            isLoading = sheet->m_loadingState == SpriteLoadState::LOADING;
+            return nullptr;
+        }
+
         const Size& size = sheet->getSpriteSize();
 
         const auto& image = std::make_shared<Image>(size);
@@ -291,20 +374,12 @@ ImagePtr SpriteAppearances::getSpriteImage(const int id, bool& isLoading)
         const int spriteWidthBytes = size.width() * 4;
 
         for (int height = size.height() * spriteRow, offset = 0; height < size.height() + (spriteRow * size.height()); height++, offset++) {
-            std::memcpy(&pixelData[offset * spriteWidthBytes], &sheet->data[(height * SPRITE_SHEET_WIDTH_BYTES) + (spriteColumn * spriteWidthBytes)], spriteWidthBytes);
+            std::memcpy(&pixelData[offset * spriteWidthBytes], &pixels[(height * SPRITE_SHEET_WIDTH_BYTES) + (spriteColumn * spriteWidthBytes)], spriteWidthBytes);
         }
 
-        if (!image->hasTransparentPixel()) {
-            // The image must be more than 4 pixels transparent to be considered transparent.
-            uint8_t cntTrans = 0;
-            const auto& buf = image->getPixels();
-            for (size_t i = 3, n = buf.size(); i < n; i += 4) {
-                if (buf[i] == 0x00 && ++cntTrans > 4) {
-                    image->setTransparentPixel(true);
-                    break;
-                }
-            }
-        }
+        // The image must be more than 4 pixels transparent to be considered transparent.
+        if (!image->hasTransparentPixel() && Pixels::hasTransparentPixels(pixelData, size.area(), 4))
+            image->setTransparentPixel(true);
 
         return image;
     } catch (const stdext::exception& e) {
@@ -322,14 +397,17 @@ void SpriteAppearances::saveSpriteToFile(const int id, const std::string& file)
 
 void SpriteAppearances::saveSheetToFileBySprite(const int id, const std::string& file)
 {
-    if (const auto& sheet = getSheetBySpriteId(id)) {
-        Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
-        image.savePNG(file);
+    if (const auto& sheet = getSheetBySpriteId(id, false)) {
+        saveSheetToFile(sheet, file);
     }
 }
 
 void SpriteAppearances::saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file)
 {
-    Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
+    const auto& pixels = getSheetPixels(sheet);
+    if (!pixels)
+        return;
+
+    Image image({ SpriteSheet::SIZE }, 4, pixels.get());
     image.savePNG(file);
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "spritesheetcache.h"
 #include <framework/graphics/declarations.h>
 #include <framework/luaengine/luaobject.h>
 
@@ -97,8 +98,12 @@ public:
 
     SpriteLayout spriteLayout = SpriteLayout::SIZE_32_32;
     std::atomic<SpriteLoadState> m_loadingState = SpriteLoadState::NONE;
-    std::unique_ptr<uint8_t[]> data;
+    // decoded pixels, owned by the sheet cache; use SpriteAppearances::getSheetPixels to read them
+    std::shared_ptr<uint8_t[]> data;
     std::string file;
+
+    // position in the cache LRU list, valid while data is set
+    std::list<SpriteSheet*>::iterator m_cacheIt;
 };
 
 //@bindsingleton g_spriteAppearances
@@ -116,7 +121,9 @@ public:
     void setPath(const std::string& path) { m_path = path; }
     std::string getPath() const { return m_path; }
 
-    bool loadSpriteSheet(const SpriteSheetPtr& sheet) const;
+    bool loadSpriteSheet(const SpriteSheetPtr& sheet) { return getSheetPixels(sheet) != nullptr; }
+    // decodes the sheet if needed, the pixels can't be evicted while the returned pointer is held
+    std::shared_ptr<uint8_t[]> getSheetPixels(const SpriteSheetPtr& sheet);
     void saveSheetToFileBySprite(int id, const std::string& file);
     void saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file);
     SpriteSheetPtr getSheetBySpriteId(int id, bool load = true) {
@@ -125,7 +132,24 @@ public:
     }
     SpriteSheetPtr getSheetBySpriteId(int id, bool& isLoading, bool load = true);
 
-    void addSpriteSheet(const SpriteSheetPtr& sheet) { m_sheets.emplace_back(sheet); }
+    void addSpriteSheet(const SpriteSheetPtr& sheet);
+
+    // decoded sheets are kept up to this amount of bytes, the least recently used ones are dropped first
+    void setCacheLimit(size_t bytes);
+    size_t getCacheLimit() const { return m_cacheLimit; }
+    size_t getCacheUsage() const;
+    uint64_t getCacheHits() const;
+    uint64_t getCacheMisses() const;
+    uint64_t getCacheEvictions() const;
+    void resetCacheStats();
+
+    // decoded sheets saved on disk, keyed by the catalog contents
+    void openDiskCache(const std::string& catalog) { m_diskCache.open(catalog); }
+    void setDiskCacheLimit(const size_t bytes) { m_diskCache.setLimit(bytes); }
+    size_t getDiskCacheLimit() const { return m_diskCache.getLimit(); }
+    size_t getDiskCacheUsage() const { return m_diskCache.getUsage(); }
+    uint64_t getDiskCacheHits() const { return m_diskCache.getHits(); }
+    uint64_t getDiskCacheMisses() const { return m_diskCache.getMisses(); }
 
     ImagePtr getSpriteImage(int id) {
         bool isLoading = false;
@@ -135,9 +159,24 @@ public:
     void saveSpriteToFile(int id, const std::string& file);
 
 private:
+    std::shared_ptr<uint8_t[]> decodeSpriteSheet(const SpriteSheetPtr& sheet);
+    void evictSheets();
+
     uint32_t m_spritesCount{ 0 };
+    // sorted by first sprite id, sheets don't overlap
     std::vector<SpriteSheetPtr> m_sheets;
     std::string m_path;
+
+    mutable std::mutex m_cacheMutex;
+    // most recently used first
+    std::list<SpriteSheet*> m_cachedSheets;
+    size_t m_cacheLimit{ 256 * 1024 * 1024 };
+    size_t m_cacheUsage{ 0 };
+    uint64_t m_cacheHits{ 0 };
+    uint64_t m_cacheMisses{ 0 };
+    uint64_t m_cacheEvictions{ 0 };
+
+    SpriteSheetDiskCache m_diskCache;
 };
 
 extern SpriteAppearances g_spriteAppearances;
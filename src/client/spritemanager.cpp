@@ -30,6 +30,7 @@
 #include "framework/core/graphicalapplication.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/graphics/image.h"
+#include "framework/graphics/pixelkernels.h"
 
 SpriteManager g_sprites;
 
@@ -292,7 +293,6 @@ ImagePtr SpriteManager::getSpriteImage(const int id, const FileStreamPtr& file)
         int transparentCount = 0;
 
         static constexpr int MAX_PIXEL_BLOCK = 4096;
-        static thread_local uint8_t tempBuffer[MAX_PIXEL_BLOCK * 4];
 
         while (offset + 4 <= pixelDataSize && writePos < maxWriteSize) {
             const uint16_t transparentPixels = readU16FromBuffer(spriteBuffer.data(), offset);
@@ -313,31 +313,18 @@ ImagePtr SpriteManager::getSpriteImage(const int id, const FileStreamPtr& file)
             if (offset + bytesToRead > pixelDataSize)
                 break;
 
-            std::memcpy(tempBuffer, spriteBuffer.data() + offset, bytesToRead);
+            const uint8_t* colors = spriteBuffer.data() + offset;
             offset += bytesToRead;
 
+            const int writePixels = std::min<int>(actualColoredPixels, (maxWriteSize - writePos) / 4);
             if (useAlpha) {
-                for (int i = 0, src = 0; i < actualColoredPixels && writePos + 4 <= maxWriteSize; ++i, src += 4) {
-                    pixels[writePos + 0] = tempBuffer[src + 0];
-                    pixels[writePos + 1] = tempBuffer[src + 1];
-                    pixels[writePos + 2] = tempBuffer[src + 2];
-                    const uint8_t alpha = tempBuffer[src + 3];
-                    pixels[writePos + 3] = alpha;
-
-                    if (alpha != 0xFF) hasAlpha = true;
-                    else if (transparentCount <= 4 && alpha == 0x00) ++transparentCount;
-
-                    writePos += 4;
-                }
+                std::memcpy(pixels + writePos, colors, writePixels * 4);
+                if (!hasAlpha)
+                    hasAlpha = Pixels::hasTranslucentPixel(pixels + writePos, writePixels);
             } else {
-                for (int i = 0, src = 0; i < actualColoredPixels && writePos + 4 <= maxWriteSize; ++i, src += 3) {
-                    pixels[writePos + 0] = tempBuffer[src + 0];
-                    pixels[writePos + 1] = tempBuffer[src + 1];
-                    pixels[writePos + 2] = tempBuffer[src + 2];
-                    pixels[writePos + 3] = 0xFF;
-                    writePos += 4;
-                }
+                Pixels::rgbToRgba(pixels + writePos, colors, writePixels);
             }
+            writePos += writePixels * 4;
         }
 
         if (writePos < maxWriteSize) {
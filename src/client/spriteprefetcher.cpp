@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "spriteprefetcher.h"
+
+#include "map.h"
+#include "thing.h"
+#include "thingtype.h"
+#include "tile.h"
+
+#include <framework/core/asyncdispatcher.h>
+#include <framework/core/graphicalapplication.h>
+
+SpritePrefetcher g_spritePrefetcher;
+
+namespace
+{
+    // rows/columns of the aware area, from its border, queued in the walking direction
+    constexpr int PREFETCH_DEPTH = 2;
+}
+
+void SpritePrefetcher::init()
+{
+    // leave room in the pool for the other background work
+    m_maxConcurrency = std::max<uint32_t>(1, g_asyncDispatcher.get_thread_count() / 2);
+}
+
+void SpritePrefetcher::terminate()
+{
+    std::scoped_lock l(m_mutex);
+    for (auto& queue : m_queues) {
+        for (const auto& thingType : queue) {
+            if (m_queued.erase(thingType.get())) {
+                thingType->m_loadingVisible = false;
+                thingType->m_loading = false;
+            }
+        }
+        queue.clear();
+    }
+}
+
+void SpritePrefetcher::request(ThingType* thingType, const Priority priority)
+{
+    // called for every draw of a thing waiting for its texture, possibly from the floor workers,
+    // so the lock is only taken to queue or promote
+    if (priority == PriorityVisible) {
+        if (thingType->m_loadingVisible.load(std::memory_order_acquire))
+            return;
+    } else if (!m_enabled || thingType->isNull() || thingType->hasTexture() || thingType->m_loading.load(std::memory_order_acquire))
+        return;
+
+    std::scoped_lock l(m_mutex);
+
+    // already queued or being loaded
+    if (thingType->m_loading.exchange(true, std::memory_order_acq_rel)) {
+        if (priority != PriorityVisible)
+            return;
+
+        const auto it = m_queued.find(thingType);
+        if (it == m_queued.end() || it->second == PriorityVisible) {
+            // being loaded, or another thread queued it meanwhile
+            thingType->m_loadingVisible.store(true, std::memory_order_release);
+            return;
+        }
+
+        // the prefetch didn't get to it in time, the entry left in the prefetch queue is skipped by pop
+        it->second = PriorityVisible;
+        thingType->m_loadingVisible.store(true, std::memory_order_release);
+        m_queues[PriorityVisible].emplace_back(thingType->static_self_cast<ThingType>());
+        ++m_visibleWaits;
+        ++m_prefetchPromotions;
+        schedule();
+        return;
+    }
+
+    m_queued.emplace(thingType, priority);
+    m_queues[priority].emplace_back(thingType->static_self_cast<ThingType>());
+    if (priority == PriorityVisible) {
+        thingType->m_loadingVisible.store(true, std::memory_order_release);
+        ++m_visibleWaits;
+    }
+
+    schedule();
+}
+
+void SpritePrefetcher::prefetch(const Position& centralPosition, const Otc::Direction direction)
+{
+    if (!m_enabled || direction == Otc::InvalidDirection || !g_app.isLoadingAsyncTexture())
+        return;
+
+    {
+        // the ring of the previous position is no longer ahead of the player
+        std::scoped_lock l(m_mutex);
+        for (const auto& thingType : m_queues[PriorityPrefetch]) {
+            const auto it = m_queued.find(thingType.get());
+            if (it != m_queued.end() && it->second == PriorityPrefetch) {
+                m_queued.erase(it);
+                thingType->m_loading = false;
+            }
+        }
+        m_queues[PriorityPrefetch].clear();
+    }
+
+    const auto& step = centralPosition.translatedToDirection(direction);
+    const int dx = step.x - centralPosition.x;
+    const int dy = step.y - centralPosition.y;
+
+    const auto& range = g_map.getAwareRange();
+
+    const auto& requestTile = [this](const int x, const int y, const int z) {
+        if (x < 0 || y < 0)
+            return;
+
+        const auto& tile = g_map.getTile(Position(x, y, z));
+        if (!tile)
+            return;
+
+        for (const auto& thing : tile->getThings()) {
+            if (auto* thingType = thing->getThingType())
+                request(thingType, PriorityPrefetch);
+        }
+    };
+
+    for (int z = g_map.getFirstAwareFloor(); z <= g_map.getLastAwareFloor(); ++z) {
+        // floors above are drawn shifted by one tile per floor
+        const int offset = centralPosition.z - z;
+        const int centerX = centralPosition.x + offset;
+        const int centerY = centralPosition.y + offset;
+
+        for (int i = 0; i < PREFETCH_DEPTH; ++i) {
+            if (dx != 0) {
+                const int x = dx > 0 ? centerX + range.right - i : centerX - range.left + i;
+                for (int y = centerY - range.top; y <= centerY + range.bottom; ++y)
+                    requestTile(x, y, z);
+            }
+
+            if (dy != 0) {
+                const int y = dy > 0 ? centerY + range.bottom - i : centerY - range.top + i;
+                for (int x = centerX - range.left; x <= centerX + range.right; ++x)
+                    requestTile(x, y, z);
+            }
+        }
+    }
+}
+
+void SpritePrefetcher::setMaxConcurrency(const uint32_t max)
+{
+    std::scoped_lock l(m_mutex);
+    m_maxConcurrency = std::max<uint32_t>(1, max);
+    schedule();
+}
+
+uint64_t SpritePrefetcher::getVisibleWaits() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_visibleWaits;
+}
+
+uint64_t SpritePrefetcher::getPrefetchPromotions() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_prefetchPromotions;
+}
+
+uint64_t SpritePrefetcher::getPrefetched() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_prefetched;
+}
+
+uint32_t SpritePrefetcher::getPending() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_queued.size();
+}
+
+void SpritePrefetcher::resetStats()
+{
+    std::scoped_lock l(m_mutex);
+    m_visibleWaits = 0;
+    m_prefetchPromotions = 0;
+    m_prefetched = 0;
+}
+
+// must be called with m_mutex locked
+void SpritePrefetcher::schedule()
+{
+    while (m_running < m_maxConcurrency) {
+        Priority priority;
+        auto thingType = pop(priority);
+        if (!thingType)
+            break;
+
+        ++m_running;
+        g_asyncDispatcher.detach_task([this, thingType = std::move(thingType), priority] {
+            for (int_fast8_t i = -1; ++i < thingType->m_animationPhases;)
+                thingType->loadTexture(i);
+
+            std::scoped_lock l(m_mutex);
+            // both cleared under the lock, so request never marks a finished load as visible
+            thingType->m_loadingVisible = false;
+            thingType->m_loading = false;
+            --m_running;
+            if (priority == PriorityPrefetch && thingType->hasTexture())
+                ++m_prefetched;
+            schedule();
+        });
+    }
+}
+
+ThingTypePtr SpritePrefetcher::pop(Priority& priority)
+{
+    for (const auto queuePriority : { PriorityVisible, PriorityPrefetch }) {
+        auto& queue = m_queues[queuePriority];
+        while (!queue.empty()) {
+            auto thingType = std::move(queue.front());
+            queue.pop_front();
+
+            // promoted entries are left behind in the prefetch queue
+            const auto it = m_queued.find(thingType.get());
+            if (it == m_queued.end() || it->second != queuePriority)
+                continue;
+
+            m_queued.erase(it);
+            priority = queuePriority;
+            return thingType;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "declarations.h"
+#include "position.h"
+
+// Schedules the texture loading of ThingTypes on g_asyncDispatcher.
+// Things being drawn are loaded first, then the ring of tiles just outside the
+// viewport in the walking direction, so most of them are ready when they scroll in.
+// Running loads are bounded so the prefetch ring never starves the visible things.
+//@bindsingleton g_spritePrefetcher
+class SpritePrefetcher
+{
+public:
+    enum Priority : uint8_t
+    {
+        PriorityVisible,
+        PriorityPrefetch
+    };
+
+    void init();
+    void terminate();
+
+    // queues the textures of every animation phase of the thing type,
+    // lock free when it is already queued at the same or a higher priority
+    void request(ThingType* thingType, Priority priority);
+    // queues the thing types of the aware tiles closest to the border the map is moving to
+    void prefetch(const Position& centralPosition, Otc::Direction direction);
+
+    void setEnabled(const bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    void setMaxConcurrency(uint32_t max);
+    uint32_t getMaxConcurrency() const { return m_maxConcurrency; }
+
+    // visible thing types that had to wait for their textures, and how many of them were already queued by the prefetch
+    uint64_t getVisibleWaits() const;
+    uint64_t getPrefetchPromotions() const;
+    // thing types loaded from the prefetch ring before being drawn
+    uint64_t getPrefetched() const;
+    uint32_t getPending() const;
+    void resetStats();
+
+private:
+    void schedule();
+    ThingTypePtr pop(Priority& priority);
+
+    mutable std::mutex m_mutex;
+
+    std::deque<ThingTypePtr> m_queues[2];
+    stdext::map<ThingType*, Priority> m_queued;
+
+    uint32_t m_maxConcurrency{ 2 };
+    uint32_t m_running{ 0 };
+
+    uint64_t m_visibleWaits{ 0 };
+    uint64_t m_prefetchPromotions{ 0 };
+    uint64_t m_prefetched{ 0 };
+
+    bool m_enabled{ true };
+};
+
+extern SpritePrefetcher g_spritePrefetcher;
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "spritesheetcache.h"
+
+#include <framework/core/graphicalapplication.h>
+#include <framework/core/resourcemanager.h>
+#include <zlib.h>
+
+namespace
+{
+    constexpr uint32_t SHEET_CACHE_SIGNATURE = 0x4353544F; // OTSC
+    constexpr uint16_t SHEET_CACHE_VERSION = 1;
+    // signature, version, reserved, source time, pixel bytes
+    constexpr uint32_t SHEET_CACHE_HEADER_SIZE = 4 + 2 + 2 + 8 + 4;
+    constexpr uint32_t SHEET_CACHE_FILE_SIZE = SHEET_CACHE_HEADER_SIZE + BYTES_IN_SPRITE_SHEET;
+
+    constexpr std::string_view SHEET_CACHE_EXTENSION = ".sheet";
+}
+
+SpriteSheetDiskCache::SpriteSheetDiskCache() : m_encrypted(g_app.isEncrypted()) {}
+
+void SpriteSheetDiskCache::open(const std::string& catalog)
+{
+    close();
+
+    const auto& root = std::filesystem::u8path(g_resources.getWriteDir()) / "sprite-cache";
+
+    std::error_code ec;
+
+    if (isEncrypted()) {
+        // sheets decoded by an unencrypted build sharing this write directory
+        std::filesystem::remove_all(root, ec);
+        return;
+    }
+
+    const uint32_t hash = ::crc32(::crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(catalog.data()), static_cast<uInt>(catalog.size()));
+    const auto& directory = root / fmt::format("{:08x}", hash);
+
+    // caches of other catalogs are stale
+    for (auto it = std::filesystem::directory_iterator(root, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (it->path() != directory) {
+            std::error_code removeError;
+            std::filesystem::remove_all(it->path(), removeError);
+        }
+    }
+
+    ec.clear();
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        g_logger.warning("Unable to create sprite sheet cache '{}': {}", directory.string(), ec.message());
+        return;
+    }
+
+    std::vector<std::tuple<std::filesystem::file_time_type, std::string, uint64_t>> files;
+    for (auto it = std::filesystem::directory_iterator(directory, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError))
+            continue;
+
+        // leftovers of an interrupted store
+        if (it->path().extension() != SHEET_CACHE_EXTENSION) {
+            std::filesystem::remove(it->path(), entryError);
+            continue;
+        }
+
+        files.emplace_back(it->last_write_time(entryError), it->path().filename().string(), it->file_size(entryError));
+    }
+
+    // the oldest files are the first ones evicted
+    std::ranges::sort(files, {}, [](const auto& file) { return std::get<0>(file); });
+
+    std::scoped_lock l(m_mutex);
+    m_directory = directory;
+    for (const auto& [time, name, size] : files) {
+        m_entries[name] = { .size = size, .lastUse = ++m_useCounter };
+        m_usage += size;
+    }
+    evict();
+}
+
+void SpriteSheetDiskCache::close()
+{
+    std::scoped_lock l(m_mutex);
+    m_directory.clear();
+    m_entries.clear();
+    m_usage = 0;
+}
+
+bool SpriteSheetDiskCache::isOpen() const
+{
+    std::scoped_lock l(m_mutex);
+    return !m_directory.empty();
+}
+
+void SpriteSheetDiskCache::setEncrypted(const bool encrypted)
+{
+    {
+        std::scoped_lock l(m_mutex);
+        m_encrypted = encrypted;
+    }
+
+    if (encrypted)
+        close();
+}
+
+bool SpriteSheetDiskCache::isEncrypted() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_encrypted;
+}
+
+void SpriteSheetDiskCache::setLimit(const size_t bytes)
+{
+    std::scoped_lock l(m_mutex);
+    m_limit = bytes;
+    evict();
+}
+
+size_t SpriteSheetDiskCache::getLimit() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_limit;
+}
+
+size_t SpriteSheetDiskCache::getUsage() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_usage;
+}
+
+uint64_t SpriteSheetDiskCache::getHits() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_hits;
+}
+
+uint64_t SpriteSheetDiskCache::getMisses() const
+{
+    std::scoped_lock l(m_mutex);
+    return m_misses;
+}
+
+std::filesystem::path SpriteSheetDiskCache::getPath(const std::string& file) const
+{
+    std::string name = file;
+    std::ranges::replace(name, '/', '_');
+    std::ranges::replace(name, '\\', '_');
+    return m_directory / std::filesystem::u8path(name + std::string(SHEET_CACHE_EXTENSION));
+}
+
+bool SpriteSheetDiskCache::load(const std::string& file, const ticks_t sourceTime, uint8_t* pixels)
+{
+    std::filesystem::path path;
+    {
+        std::scoped_lock l(m_mutex);
+        if (m_directory.empty() || m_limit == 0)
+            return false;
+
+        path = getPath(file);
+        const auto it = m_entries.find(path.filename().string());
+        if (it == m_entries.end()) {
+            ++m_misses;
+            return false;
+        }
+        it->second.lastUse = ++m_useCounter;
+    }
+
+    std::ifstream fin(path, std::ios::binary);
+
+    uint8_t header[SHEET_CACHE_HEADER_SIZE];
+    bool valid = fin.read(reinterpret_cast<char*>(header), SHEET_CACHE_HEADER_SIZE)
+        && stdext::readULE32(header) == SHEET_CACHE_SIGNATURE
+        && stdext::readULE16(header + 4) == SHEET_CACHE_VERSION
+        && stdext::readULE64(header + 8) == static_cast<uint64_t>(sourceTime)
+        && stdext::readULE32(header + 16) == BYTES_IN_SPRITE_SHEET;
+
+    valid = valid && fin.read(reinterpret_cast<char*>(pixels), BYTES_IN_SPRITE_SHEET);
+    fin.close();
+
+    std::scoped_lock l(m_mutex);
+    if (!valid) {
+        ++m_misses;
+        remove(path.filename().string());
+        return false;
+    }
+
+    ++m_hits;
+    return true;
+}
+
+void SpriteSheetDiskCache::store(const std::string& file, const ticks_t sourceTime, const uint8_t* pixels)
+{
+    std::filesystem::path path;
+    {
+        std::scoped_lock l(m_mutex);
+        if (m_directory.empty() || m_limit < SHEET_CACHE_FILE_SIZE)
+            return;
+        path = getPath(file);
+    }
+
+    uint8_t header[SHEET_CACHE_HEADER_SIZE] = {};
+    stdext::writeULE32(header, SHEET_CACHE_SIGNATURE);
+    stdext::writeULE16(header + 4, SHEET_CACHE_VERSION);
+    stdext::writeULE64(header + 8, static_cast<uint64_t>(sourceTime));
+    stdext::writeULE32(header + 16, BYTES_IN_SPRITE_SHEET);
+
+    // written aside and renamed, so a partial file is never read
+    auto tempPath = path;
+    tempPath += fmt::format(".{}.tmp", stdext::getThreadId());
+
+    {
+        std::ofstream fout(tempPath, std::ios::binary | std::ios::trunc);
+        fout.write(reinterpret_cast<const char*>(header), SHEET_CACHE_HEADER_SIZE);
+        fout.write(reinterpret_cast<const char*>(pixels), BYTES_IN_SPRITE_SHEET);
+        if (!fout.good()) {
+            fout.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    std::scoped_lock l(m_mutex);
+    // closed or reopened for another catalog meanwhile
+    if (path.parent_path() != m_directory) {
+        std::filesystem::remove(path, ec);
+        return;
+    }
+
+    auto& entry = m_entries[path.filename().string()];
+    m_usage += SHEET_CACHE_FILE_SIZE - entry.size;
+    entry = { .size = SHEET_CACHE_FILE_SIZE, .lastUse = ++m_useCounter };
+    evict();
+}
+
+void SpriteSheetDiskCache::remove(const std::string& name)
+{
+    const auto it = m_entries.find(name);
+    if (it == m_entries.end())
+        return;
+
+    // name may be the key being erased
+    const auto& path = m_directory / std::filesystem::u8path(name);
+
+    m_usage -= it->second.size;
+    m_entries.erase(it);
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+void SpriteSheetDiskCache::evict()
+{
+    while (m_usage > m_limit && !m_entries.empty()) {
+        const auto oldest = std::ranges::min_element(m_entries, {}, [](const auto& entry) { return entry.second.lastUse; });
+        remove(oldest->first);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <framework/global.h>
+
+// Decoded sprite sheets saved in the write directory, so later sessions read them back instead of decoding the lzma again.
+// Files are grouped in a folder named after the catalog hash and remember the modification time of their source sheet,
+// so a new catalog or a changed sheet file makes them stale. Past the size limit the least recently used files are deleted.
+// Encrypted clients never open it, decoded sheets would leave the protected assets readable in the write directory.
+class SpriteSheetDiskCache
+{
+public:
+    SpriteSheetDiskCache();
+
+    // contents of catalog-content.json
+    void open(const std::string& catalog);
+    void close();
+    bool isOpen() const;
+
+    // follows g_app.isEncrypted() by default, enabling it closes the cache
+    void setEncrypted(bool encrypted);
+    bool isEncrypted() const;
+
+    // 0 disables the cache
+    void setLimit(size_t bytes);
+    size_t getLimit() const;
+    size_t getUsage() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+
+    // reads BYTES_IN_SPRITE_SHEET bytes into pixels, false when missing or stale
+    bool load(const std::string& file, ticks_t sourceTime, uint8_t* pixels);
+    void store(const std::string& file, ticks_t sourceTime, const uint8_t* pixels);
+
+private:
+    struct Entry
+    {
+        uint64_t size{ 0 };
+        uint64_t lastUse{ 0 };
+    };
+
+    std::filesystem::path getPath(const std::string& file) const;
+    void remove(const std::string& name);
+    void evict();
+
+    mutable std::mutex m_mutex;
+
+    std::filesystem::path m_directory;
+    stdext::map<std::string, Entry> m_entries;
+
+    bool m_encrypted{ false };
+
+    size_t m_limit{ 512 * 1024 * 1024 };
+    size_t m_usage{ 0 };
+    uint64_t m_useCounter{ 0 };
+    uint64_t m_hits{ 0 };
+    uint64_t m_misses{ 0 };
+};
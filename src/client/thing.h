@@ -240,6 +240,7 @@ private:
     bool m_animate{ true };
 
     friend class Client;
+    friend class SpritePrefetcher;
     friend class Tile;
 };
 #pragma pack(pop)
\ No newline at end of file
@@ -28,10 +28,12 @@
 #include "lightview.h"
 #include "spriteappearances.h"
 #include "spritemanager.h"
-#include "framework/core/asyncdispatcher.h"
+#include "spriteprefetcher.h"
+#include "framework/core/clock.h"
 #include "framework/core/filestream.h"
 #include "framework/graphics/drawpoolmanager.h"
 #include "framework/graphics/image.h"
+#include "framework/graphics/rectpacker.h"
 #include "framework/otml/otmlnode.h"
 #include <framework/core/graphicalapplication.h>
 
@@ -48,6 +50,30 @@ std::string_view categoryName(const ThingCategory category)
         default: return "unknown";
     }
 }
+
+// smallest rect holding every visible pixel of the image, invalid when there is none
+Rect getVisibleRect(const ImagePtr& image)
+{
+    const uint8_t* pixels = image->getPixelData();
+    const int width = image->getWidth();
+    const int height = image->getHeight();
+
+    int left = width, top = height, right = -1, bottom = -1;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = pixels + static_cast<size_t>(y) * width * 4;
+        for (int x = 0; x < width; ++x) {
+            if (row[x * 4 + 3] == 0x00)
+                continue;
+
+            left = std::min<int>(left, x);
+            right = std::max<int>(right, x);
+            top = std::min<int>(top, y);
+            bottom = y;
+        }
+    }
+
+    return right < 0 ? Rect() : Rect(Point(left, top), Point(right, bottom));
+}
 }
 
 void ThingType::unserializeAppearance(const uint16_t clientId, const ThingCategory category, const appearances::Appearance& appearance)
@@ -356,6 +382,134 @@ void ThingType::applyAppearanceFlags(const appearances::AppearanceFlags& flags)
     }
 }
 
+void ThingType::unserializeSnapshot(const uint16_t clientId, const ThingCategory category, const FileStreamPtr& fin)
+{
+    m_null = false;
+    m_id = clientId;
+    m_category = category;
+    m_name = fin->getString();
+    m_description = fin->getString();
+
+    m_flags = fin->getU64();
+    // a type without a known sprite sheet keeps the invalid size
+    m_size = Size(fin->get16(), fin->get16());
+    m_displacement = Point(fin->get16(), fin->get16());
+    m_opaque = fin->get8();
+    m_animationPhases = fin->getU8();
+    m_realSize = fin->getU8();
+    m_numPatternX = fin->getU8();
+    m_numPatternY = fin->getU8();
+    m_numPatternZ = fin->getU8();
+    m_layers = fin->getU8();
+    m_exactHeight = fin->getU8();
+    m_minimapColor = fin->getU8();
+    m_clothSlot = fin->getU8();
+    m_lensHelp = fin->getU8();
+    m_elevation = fin->getU8();
+    m_defaultAction = static_cast<PLAYER_ACTION>(fin->getU8());
+    m_groundSpeed = fin->getU16();
+    m_maxTextLength = fin->getU16();
+    m_upgradeClassification = fin->getU16();
+    m_light.intensity = fin->getU8();
+    m_light.color = fin->getU8();
+
+    m_market.name = fin->getString();
+    m_market.category = static_cast<ITEM_CATEGORY>(fin->getU8());
+    m_market.requiredLevel = fin->getU16();
+    m_market.restrictVocation = fin->getU16();
+    m_market.showAs = fin->getU16();
+    m_market.tradeAs = fin->getU16();
+
+    m_npcData.resize(fin->getU16());
+    for (auto& data : m_npcData) {
+        data.name = fin->getString();
+        data.location = fin->getString();
+        data.salePrice = fin->getU32();
+        data.buyPrice = fin->getU32();
+        data.currencyObjectTypeId = fin->getU32();
+        data.currencyQuestFlagDisplayName = fin->getString();
+    }
+
+    const uint16_t spritesCount = fin->getU16();
+    if (spritesCount > 4096)
+        throw Exception("a thing type has more than 4096 sprites");
+
+    m_spritesIndex.resize(spritesCount);
+    for (auto& spriteId : m_spritesIndex)
+        spriteId = fin->getU32();
+
+    if (fin->getU8()) {
+        m_animator = new Animator;
+        m_animator->unserializeSnapshot(fin);
+    }
+
+    if (fin->getU8()) {
+        m_idleAnimator = new Animator;
+        m_idleAnimator->unserializeSnapshot(fin);
+    }
+
+    m_textureData.resize(m_animationPhases);
+}
+
+void ThingType::serializeSnapshot(const FileStreamPtr& fin) const
+{
+    fin->addString(m_name);
+    fin->addString(m_description);
+
+    fin->addU64(m_flags);
+    fin->add16(m_size.width());
+    fin->add16(m_size.height());
+    fin->add16(m_displacement.x);
+    fin->add16(m_displacement.y);
+    fin->add8(m_opaque);
+    fin->addU8(m_animationPhases);
+    fin->addU8(m_realSize);
+    fin->addU8(m_numPatternX);
+    fin->addU8(m_numPatternY);
+    fin->addU8(m_numPatternZ);
+    fin->addU8(m_layers);
+    fin->addU8(m_exactHeight);
+    fin->addU8(m_minimapColor);
+    fin->addU8(m_clothSlot);
+    fin->addU8(m_lensHelp);
+    fin->addU8(m_elevation);
+    fin->addU8(m_defaultAction);
+    fin->addU16(m_groundSpeed);
+    fin->addU16(m_maxTextLength);
+    fin->addU16(m_upgradeClassification);
+    fin->addU8(m_light.intensity);
+    fin->addU8(m_light.color);
+
+    fin->addString(m_market.name);
+    fin->addU8(m_market.category);
+    fin->addU16(m_market.requiredLevel);
+    fin->addU16(m_market.restrictVocation);
+    fin->addU16(m_market.showAs);
+    fin->addU16(m_market.tradeAs);
+
+    fin->addU16(m_npcData.size());
+    for (const auto& data : m_npcData) {
+        fin->addString(data.name);
+        fin->addString(data.location);
+        fin->addU32(data.salePrice);
+        fin->addU32(data.buyPrice);
+        fin->addU32(data.currencyObjectTypeId);
+        fin->addString(data.currencyQuestFlagDisplayName);
+    }
+
+    fin->addU16(m_spritesIndex.size());
+    for (const uint32_t spriteId : m_spritesIndex)
+        fin->addU32(spriteId);
+
+    fin->addU8(m_animator != nullptr);
+    if (m_animator)
+        m_animator->serializeSnapshot(fin);
+
+    fin->addU8(m_idleAnimator != nullptr);
+    if (m_idleAnimator)
+        m_idleAnimator->serializeSnapshot(fin);
+}
+
 void ThingType::unserialize(const uint16_t clientId, const ThingCategory category, const FileStreamPtr& fin)
 {
     m_null = false;
@@ -681,7 +835,9 @@ const TexturePtr& ThingType::getTexture(const int animationPhase)
 {
     if (m_null) return m_textureNull;
 
-    m_lastTimeUsage.restart();
+    // only written when it changes, several floor workers may draw the same thing type
+    if (const ticks_t now = g_clock.millis(); m_lastTimeUsage.load(std::memory_order_relaxed) != now)
+        m_lastTimeUsage.store(now, std::memory_order_relaxed);
 
     auto& textureData = m_textureData[animationPhase];
 
@@ -698,17 +854,7 @@ const TexturePtr& ThingType::getTexture(const int animationPhase)
         return textureData.source;
     }
 
-    if (!m_loading) {
-        m_loading = true;
-
-        auto action = [this] {
-            for (int_fast8_t i = -1; ++i < m_animationPhases;)
-                loadTexture(i);
-            m_loading = false;
-        };
-
-        g_asyncDispatcher.detach_task(std::move(action));
-    }
+    g_spritePrefetcher.request(this, SpritePrefetcher::PriorityVisible);
 
     return m_textureNull;
 }
@@ -719,6 +865,11 @@ void ThingType::loadTexture(const int animationPhase)
     if (textureData.source)
         return;
 
+    if (animationPhase == 0 && !m_customImage.empty()) {
+        loadCustomTexture();
+        return;
+    }
+
     // we don't need layers in common items, they will be pre-drawn
     int textureLayers = 1;
     int numLayers = m_layers;
@@ -728,15 +879,37 @@ void ThingType::loadTexture(const int animationPhase)
         numLayers = 5;
     }
 
-    const bool useCustomImage = animationPhase == 0 && !m_customImage.empty();
     const int indexSize = textureLayers * m_numPatternX * m_numPatternY * m_numPatternZ;
-    const auto& textureSize = getBestTextureDimension(m_size.width(), m_size.height(), indexSize);
-    const auto& fullImage = useCustomImage ? Image::load(m_customImage) : std::make_shared<Image>(textureSize * g_gameConfig.getSpriteSize());
+    const int spriteSize = g_gameConfig.getSpriteSize();
+    const Size frameSize = m_size * spriteSize;
     const bool protobufSupported = g_game.isUsingProtobuf();
 
     static Color maskColors[] = { Color::red, Color::green, Color::blue, Color::yellow };
 
-    textureData.pos.resize(indexSize);
+    struct FrameSprite
+    {
+        ImagePtr image;
+        // visible part of the image, in the frame
+        Rect rect;
+        Point offset;
+    };
+
+    // sprites are kept until every frame is measured, so only the visible part of each frame gets texture space
+    std::vector<std::vector<FrameSprite>> frameSprites(indexSize);
+    std::vector<Rect> frameBounds(indexSize);
+    bool transparentPixel = m_opacity < 1.0f;
+
+    const auto& addSprite = [&](const int frameIndex, const ImagePtr& spriteImage, const Point& spritePos) {
+        const auto& visibleRect = getVisibleRect(spriteImage);
+        if (!visibleRect.isValid())
+            return;
+
+        const auto& frameRect = visibleRect.translated(spritePos);
+        auto& bounds = frameBounds[frameIndex];
+        bounds = bounds.isValid() ? bounds.united(frameRect) : frameRect;
+        frameSprites[frameIndex].emplace_back(spriteImage, frameRect, visibleRect.topLeft());
+    };
+
     for (int z = 0; z < m_numPatternZ; ++z) {
         for (int y = 0; y < m_numPatternY; ++y) {
             for (int x = 0; x < m_numPatternX; ++x) {
@@ -744,93 +917,143 @@ void ThingType::loadTexture(const int animationPhase)
                     const bool spriteMask = m_category == ThingCategoryCreature && l > 0;
                     const int frameIndex = getTextureIndex(l % textureLayers, x, y, z);
 
-                    const auto& framePos = Point(frameIndex % (textureSize.width() / m_size.width()) * m_size.width(),
-                        frameIndex / (textureSize.width() / m_size.width()) * m_size.height()) * g_gameConfig.getSpriteSize();
+                    if (protobufSupported) {
+                        const uint32_t spriteIndex = getSpriteIndex(-1, -1, spriteMask ? 1 : l, x, y, z, animationPhase);
+                        auto spriteId = m_spritesIndex[spriteIndex];
+                        bool isLoading = false;
+                        const auto& spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
 
-                    if (!useCustomImage) {
-                        if (protobufSupported) {
-                            const uint32_t spriteIndex = getSpriteIndex(-1, -1, spriteMask ? 1 : l, x, y, z, animationPhase);
-                            auto spriteId = m_spritesIndex[spriteIndex];
-                            bool isLoading = false;
-                            const auto& spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
+                        if (isLoading)
+                            return;
 
-                            if (isLoading)
+                        if (!spriteImage) {
+                            if (spriteId != 0) {
+                                g_logger.error("Failed to fetch sprite id {} for thing {} ({}, {}), layer {}, pattern {}x{}x{}, frame {}", spriteId, m_name, m_id, categoryName(m_category), l, x, y, z, animationPhase);
                                 return;
-
-                            if (!spriteImage) {
-                                if (spriteId != 0) {
-                                    g_logger.error("Failed to fetch sprite id {} for thing {} ({}, {}), layer {}, pattern {}x{}x{}, frame {}", spriteId, m_name, m_id, categoryName(m_category), l, x, y, z, animationPhase);
-                                    return;
-                                }
-                            } else {
-                                // verifies that the first block in the lower right corner is transparent.
-                                if (spriteImage->hasTransparentPixel()) {
-                                    fullImage->setTransparentPixel(true);
-                                }
-
-                                if (spriteMask) {
-                                    spriteImage->overwriteMask(maskColors[(l - 1)]);
-                                }
-
-                                auto spriteSize = spriteImage->getSize() / g_gameConfig.getSpriteSize();
-
-                                const Point& spritePos = Point(m_size.width() - spriteSize.width(), m_size.height() - spriteSize.height()) * g_gameConfig.getSpriteSize();
-                                fullImage->blit(framePos + spritePos, spriteImage);
                             }
                         } else {
-                            for (int h = 0; h < m_size.height(); ++h) {
-                                for (int w = 0; w < m_size.width(); ++w) {
-                                    const uint32_t spriteIndex = getSpriteIndex(w, h, spriteMask ? 1 : l, x, y, z, animationPhase);
-                                    auto spriteId = m_spritesIndex[spriteIndex];
-                                    bool isLoading = false;
-                                    const auto& spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
+                            // verifies that the first block in the lower right corner is transparent.
+                            if (spriteImage->hasTransparentPixel()) {
+                                transparentPixel = true;
+                            }
+
+                            if (spriteMask) {
+                                spriteImage->overwriteMask(maskColors[(l - 1)]);
+                            }
 
-                                    if (isLoading)
+                            auto spriteImageSize = spriteImage->getSize() / spriteSize;
+                            addSprite(frameIndex, spriteImage, Point(m_size.width() - spriteImageSize.width(), m_size.height() - spriteImageSize.height()) * spriteSize);
+                        }
+                    } else {
+                        for (int h = 0; h < m_size.height(); ++h) {
+                            for (int w = 0; w < m_size.width(); ++w) {
+                                const uint32_t spriteIndex = getSpriteIndex(w, h, spriteMask ? 1 : l, x, y, z, animationPhase);
+                                auto spriteId = m_spritesIndex[spriteIndex];
+                                bool isLoading = false;
+                                const auto& spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
+
+                                if (isLoading)
+                                    return;
+
+                                if (!spriteImage) {
+                                    if (spriteId != 0) {
+                                        g_logger.error("Failed to fetch sprite id {} for thing {} ({}, {}), layer {}, pattern {}x{}x{}, frame {}, offset {}x{}", spriteId, m_name, m_id, categoryName(m_category), l, x, y, z, frameIndex, w, h);
                                         return;
+                                    }
+                                } else {
+                                    // verifies that the first block in the lower right corner is transparent.
+                                    if (h == 0 && w == 0 && spriteImage->hasTransparentPixel()) {
+                                        transparentPixel = true;
+                                    }
 
-                                    if (!spriteImage) {
-                                        if (spriteId != 0) {
-                                            g_logger.error("Failed to fetch sprite id {} for thing {} ({}, {}), layer {}, pattern {}x{}x{}, frame {}, offset {}x{}", spriteId, m_name, m_id, categoryName(m_category), l, x, y, z, framePos, w, h);
-                                            return;
-                                        }
-                                    } else {
-                                        // verifies that the first block in the lower right corner is transparent.
-                                        if (h == 0 && w == 0 && spriteImage->hasTransparentPixel()) {
-                                            fullImage->setTransparentPixel(true);
-                                        }
-
-                                        if (spriteMask) {
-                                            spriteImage->overwriteMask(maskColors[(l - 1)]);
-                                        }
-
-                                        const Point& spritePos = Point(m_size.width() - w - 1, m_size.height() - h - 1) * g_gameConfig.getSpriteSize();
-                                        fullImage->blit(framePos + spritePos, spriteImage);
+                                    if (spriteMask) {
+                                        spriteImage->overwriteMask(maskColors[(l - 1)]);
                                     }
+
+                                    addSprite(frameIndex, spriteImage, Point(m_size.width() - w - 1, m_size.height() - h - 1) * spriteSize);
                                 }
                             }
                         }
                     }
+                }
+            }
+        }
+    }
 
-                    auto& posData = textureData.pos[frameIndex];
-                    posData.rects = { framePos + Point(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize() - Point(1), framePos };
-                    for (int fx = framePos.x; fx < framePos.x + m_size.width() * g_gameConfig.getSpriteSize(); ++fx) {
-                        for (int fy = framePos.y; fy < framePos.y + m_size.height() * g_gameConfig.getSpriteSize(); ++fy) {
-                            const uint8_t* p = fullImage->getPixel(fx, fy);
-                            if (p[3] == 0x00)
-                                continue;
-
-                            posData.rects.setTop(std::min<int>(fy, posData.rects.top()));
-                            posData.rects.setLeft(std::min<int>(fx, posData.rects.left()));
-                            posData.rects.setBottom(std::max<int>(fy, posData.rects.bottom()));
-                            posData.rects.setRight(std::max<int>(fx, posData.rects.right()));
-                        }
-                    }
+    std::vector<Size> packedSizes(indexSize, Size(0));
+    for (int i = 0; i < indexSize; ++i) {
+        if (frameBounds[i].isValid())
+            packedSizes[i] = frameBounds[i].size();
+    }
 
-                    posData.originRects = Rect(framePos, Size(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize());
-                    posData.offsets = posData.rects.topLeft() - framePos;
-                }
+    std::vector<Point> packedPositions;
+    const auto& textureSize = RectPacker::packFrames(packedSizes, packedPositions);
+    const auto& image = std::make_shared<Image>(textureSize);
+    image->setTransparentPixel(transparentPixel);
+
+    textureData.pos.resize(indexSize);
+    for (int i = 0; i < indexSize; ++i) {
+        auto& posData = textureData.pos[i];
+        const auto& bounds = frameBounds[i];
+        if (!bounds.isValid()) {
+            // nothing to draw, same measures a fully transparent frame had in a frame grid
+            posData.rects = {};
+            posData.offsets = (frameSize - Size(1)).toPoint();
+            posData.originRects = Rect(Point(), frameSize);
+            continue;
+        }
+
+        // only the visible part of each sprite is copied, always inside the packed rect
+        for (const auto& [spriteImage, rect, offset] : frameSprites[i])
+            image->blit(packedPositions[i] + (rect.topLeft() - bounds.topLeft()), spriteImage, Rect(offset, rect.size()));
+
+        const Point& framePos = packedPositions[i] - bounds.topLeft();
+
+        posData.rects = Rect(packedPositions[i], bounds.size());
+        posData.originRects = Rect(framePos, frameSize);
+        posData.offsets = bounds.topLeft();
+    }
+
+    if (m_opaque == -1)
+        m_opaque = !image->hasTransparentPixel();
+
+    textureData.source = std::make_shared<Texture>(image, true, false);
+    textureData.source->allowAtlasCache();
+}
+
+void ThingType::loadCustomTexture()
+{
+    auto& textureData = m_textureData[0];
+
+    const int textureLayers = m_category == ThingCategoryCreature && m_layers >= 2 ? 5 : 1;
+    const int indexSize = textureLayers * m_numPatternX * m_numPatternY * m_numPatternZ;
+    const auto& textureSize = getBestTextureDimension(m_size.width(), m_size.height(), indexSize);
+    const auto& fullImage = Image::load(m_customImage);
+    const Size frameSize = m_size * g_gameConfig.getSpriteSize();
+
+    // the custom image is already laid out as a frame grid
+    textureData.pos.resize(indexSize);
+    for (int frameIndex = 0; frameIndex < indexSize; ++frameIndex) {
+        const auto& framePos = Point(frameIndex % (textureSize.width() / m_size.width()) * m_size.width(),
+            frameIndex / (textureSize.width() / m_size.width()) * m_size.height()) * g_gameConfig.getSpriteSize();
+
+        auto& posData = textureData.pos[frameIndex];
+        posData.rects = { framePos + frameSize.toPoint() - Point(1), framePos };
+        for (int fx = framePos.x; fx < framePos.x + frameSize.width(); ++fx) {
+            for (int fy = framePos.y; fy < framePos.y + frameSize.height(); ++fy) {
+                const uint8_t* p = fullImage->getPixel(fx, fy);
+                if (p[3] == 0x00)
+                    continue;
+
+                posData.rects.setTop(std::min<int>(fy, posData.rects.top()));
+                posData.rects.setLeft(std::min<int>(fx, posData.rects.left()));
+                posData.rects.setBottom(std::max<int>(fy, posData.rects.bottom()));
+                posData.rects.setRight(std::max<int>(fx, posData.rects.right()));
             }
         }
+
+        posData.originRects = Rect(framePos, frameSize);
+        posData.offsets = posData.rects.topLeft() - framePos;
     }
 
     if (m_opacity < 1.0f)
@@ -843,6 +1066,16 @@ void ThingType::loadTexture(const int animationPhase)
     textureData.source->allowAtlasCache();
 }
 
+size_t ThingType::getTextureMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto& data : m_textureData) {
+        if (data.source)
+            bytes += static_cast<size_t>(data.source->getWidth()) * data.source->getHeight() * 4;
+    }
+    return bytes;
+}
+
 Size ThingType::getBestTextureDimension(int w, int h, const int count)
 {
     int k = 1;
@@ -42,6 +42,14 @@ public:
     void unserializeOtml(const OTMLNodePtr& node);
     void applyAppearanceFlags(const appearances::AppearanceFlags& flags);
 
+    // everything unserializeAppearance reads, see ThingTypeManager::loadAppearances.
+    // The version must be bumped whenever a field written by serializeSnapshot or
+    // Animator::serializeSnapshot is added, removed or changes size, otherwise warm
+    // starts keep reading older snapshots as if they had the new layout.
+    static constexpr uint16_t SNAPSHOT_VERSION = 2;
+    void unserializeSnapshot(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin);
+    void serializeSnapshot(const FileStreamPtr& fin) const;
+
 #ifdef FRAMEWORK_EDITOR
     void serialize(const FileStreamPtr& fin);
     void exportImage(const std::string& fileName);
@@ -149,7 +157,10 @@ public:
     bool isCreature() const { return m_category == ThingCategoryCreature; }
 
     bool hasTexture() const { return !m_textureData.empty() && m_textureData[0].source != nullptr; }
-    const Timer getLastTimeUsage() const { return m_lastTimeUsage; }
+    // bytes of pixels held by the loaded animation phases
+    size_t getTextureMemoryUsage() const;
+    // g_clock.millis() of the last getTexture call
+    ticks_t getLastTimeUsage() const { return m_lastTimeUsage.load(std::memory_order_relaxed); }
 
     void unload() {
         for (auto& data : m_textureData) {
@@ -172,10 +183,13 @@ public:
     std::string getDescription() { return m_description; }
 
 private:
+    friend class SpritePrefetcher;
+
     static ThingFlagAttr thingAttrToThingFlagAttr(ThingAttr attr);
     static Size getBestTextureDimension(int w, int h, int count);
 
     void loadTexture(int animationPhase);
+    void loadCustomTexture();
 
     struct TextureData
     {
@@ -238,8 +252,11 @@ private:
     std::vector<TextureData> m_textureData;
 
     std::atomic_bool m_loading;
+    // queued or loading at visible priority, lets SpritePrefetcher::request skip its lock
+    std::atomic_bool m_loadingVisible;
 
-    Timer m_lastTimeUsage;
+    // atomic, floors may be recorded in parallel
+    std::atomic<ticks_t> m_lastTimeUsage{ 0 };
 
     std::string m_name;
     std::string m_description;
@@ -26,12 +26,16 @@
 #include <nlohmann/json_fwd.hpp>
 
 #include "game.h"
+#include "gameconfig.h"
 #include "spriteappearances.h"
 #include "thingtype.h"
+#include "framework/core/asyncdispatcher.h"
 #include "framework/core/filestream.h"
+#include "framework/core/graphicalapplication.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/otml/otmldocument.h"
 #include <staticdata.pb.h>
+#include <zlib.h>
 
 #ifdef FRAMEWORK_EDITOR
 #include "itemtype.h"
@@ -43,6 +47,33 @@ using json = nlohmann::json;
 
 ThingTypeManager g_things;
 
+namespace
+{
+    // smaller chunks cost more in scheduling than they save
+    constexpr size_t MIN_UNSERIALIZE_CHUNK = 512;
+
+    // calls fn(begin, end) over [0, count) split in chunks among the g_asyncDispatcher workers
+    void forEachChunk(const size_t count, const std::function<void(size_t, size_t)>& fn)
+    {
+        const size_t threads = g_asyncDispatcher.get_thread_count();
+        const size_t chunkSize = std::max(MIN_UNSERIALIZE_CHUNK, (count + threads - 1) / threads);
+        if (count <= chunkSize) {
+            fn(0, count);
+            return;
+        }
+
+        BS::multi_future<void> tasks;
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            const size_t end = std::min(count, begin + chunkSize);
+            tasks.emplace_back(g_asyncDispatcher.submit_task([&fn, begin, end] { fn(begin, end); }));
+        }
+
+        // every chunk must be done before an exception leaves this frame
+        tasks.wait();
+        tasks.get();
+    }
+}
+
 void ThingTypeManager::init()
 {
     m_nullThingType = std::make_shared<ThingType>();
@@ -76,9 +107,13 @@ bool ThingTypeManager::loadDat(std::string file)
     try {
         file = g_resources.guessFilePath(file, "dat");
 
+        stdext::timer timer;
         const auto& fin = g_resources.openFile(file);
         fin->cache(true);
 
+        const auto readMillis = timer.elapsed_millis();
+        timer.restart();
+
         m_datSignature = fin->getU32();
         m_contentRevision = static_cast<uint16_t>(m_datSignature);
 
@@ -88,6 +123,7 @@ bool ThingTypeManager::loadDat(std::string file)
             thingType.resize(count, m_nullThingType);
         }
 
+        // records have no fixed size, each one is only found by reading the previous, so this stays serial
         for (int category = -1; ++category < ThingLastCategory;) {
             const uint16_t firstId = category == ThingCategoryItem ? 100 : 1;
 
@@ -98,6 +134,8 @@ bool ThingTypeManager::loadDat(std::string file)
             }
         }
 
+        g_logger.info("Loaded dat '{}' in {} ms (read {} ms, unserialize {} ms)", file, readMillis + timer.elapsed_millis(), readMillis, timer.elapsed_millis());
+
         m_datLoaded = true;
         g_lua.callGlobalField("g_things", "onLoadDat", file);
         return true;
@@ -146,10 +184,12 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
 {
     try {
         if (!g_game.getFeature(Otc::GameLoadSprInsteadProtobuf)) {
+            stdext::timer timer;
             g_spriteAppearances.unload();
             int spritesCount = 0;
             std::string appearancesFile;
-            json document = json::parse(g_resources.readFileContents(g_resources.resolvePath(g_resources.guessFilePath(file + "catalog-content", "json"))));
+            const auto& catalog = g_resources.readFileContents(g_resources.resolvePath(g_resources.guessFilePath(file + "catalog-content", "json")));
+            json document = json::parse(catalog);
             for (const auto& obj : document) {
                 const auto& type = obj["type"];
                 if (type == "appearances") {
@@ -170,39 +210,48 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
             }
             g_spriteAppearances.setSpritesCount(spritesCount + 1);
             g_spriteAppearances.setPath(file);
+            g_spriteAppearances.openDiskCache(catalog);
+
+            const auto& appearancesPath = g_resources.resolvePath(fmt::format("{}{}", file, appearancesFile));
+            const AppearancesSource source{
+                .catalogHash = ::crc32(::crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(catalog.data()), static_cast<uInt>(catalog.size())),
+                .appearancesTime = g_resources.getFileTime(appearancesPath)
+            };
+            // encrypted clients don't keep a plain copy of the appearances in the write directory
+            const bool useSnapshot = !g_app.isEncrypted();
+            const auto& snapshotFile = getAppearancesSnapshotFile(file);
+            if (useSnapshot && loadAppearancesSnapshot(snapshotFile, source)) {
+                g_logger.info("Loaded appearances '{}' from snapshot in {} ms", file, timer.elapsed_millis());
+                m_datLoaded = true;
+                return true;
+            }
+
+            // left by an unencrypted build sharing the write directory
+            if (!useSnapshot && g_resources.fileExists(snapshotFile))
+                g_resources.deleteFile(snapshotFile);
+
+            const auto catalogMillis = timer.elapsed_millis();
+            timer.restart();
+
             // load appearances.dat
             std::stringstream fin;
-            g_resources.readFileStream(g_resources.resolvePath(fmt::format("{}{}", file, appearancesFile)), fin);
+            g_resources.readFileStream(appearancesPath, fin);
             auto appearancesLib = appearances::Appearances();
             if (!appearancesLib.ParseFromIstream(&fin)) {
                 throw stdext::exception("Couldn't parse appearances lib.");
             }
-            for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
-                const google::protobuf::RepeatedPtrField<appearances::Appearance>* appearances = nullptr;
-                switch (category) {
-                    case ThingCategoryItem: appearances = &appearancesLib.object(); break;
-                    case ThingCategoryCreature: appearances = &appearancesLib.outfit(); break;
-                    case ThingCategoryEffect: appearances = &appearancesLib.effect(); break;
-                    case ThingCategoryMissile: appearances = &appearancesLib.missile(); break;
-                    default: return false;
-                }
-                // fix for custom asserts, where ids are not sorted.
-                uint32_t lastAppearanceId = 0;
-                for (const auto& appearance : *appearances) {
-                    if (appearance.id() > lastAppearanceId)
-                        lastAppearanceId = appearance.id();
-                }
-                auto& things = m_thingTypes[category];
-                things.clear();
-                things.resize(lastAppearanceId + 1, m_nullThingType);
-                for (const auto& appearance : *appearances) {
-                    const auto& type = std::make_shared<ThingType>();
-                    const uint16_t id = appearance.id();
-                    type->unserializeAppearance(id, static_cast<ThingCategory>(category), appearance);
-                    m_thingTypes[category][id] = type;
-                }
-            }
+
+            const auto protobufMillis = timer.elapsed_millis();
+            timer.restart();
+
+            if (!unserializeAppearances(appearancesLib))
+                return false;
+
+            g_logger.info("Loaded appearances '{}' in {} ms (catalog {} ms, protobuf {} ms, unserialize {} ms)", file,
+                          catalogMillis + protobufMillis + timer.elapsed_millis(), catalogMillis, protobufMillis, timer.elapsed_millis());
             m_datLoaded = true;
+            if (useSnapshot)
+                saveAppearancesSnapshot(snapshotFile, source);
         } else {
             std::stringstream datFileStream;
             auto appearancesLib = appearances::Appearances();
@@ -224,6 +273,137 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
     }
 }
 
+bool ThingTypeManager::unserializeAppearances(const appearances::Appearances& appearancesLib)
+{
+    std::vector<std::pair<ThingCategory, const appearances::Appearance*>> entries;
+    for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+        const google::protobuf::RepeatedPtrField<appearances::Appearance>* appearances = nullptr;
+        switch (category) {
+            case ThingCategoryItem: appearances = &appearancesLib.object(); break;
+            case ThingCategoryCreature: appearances = &appearancesLib.outfit(); break;
+            case ThingCategoryEffect: appearances = &appearancesLib.effect(); break;
+            case ThingCategoryMissile: appearances = &appearancesLib.missile(); break;
+            default: return false;
+        }
+        // fix for custom asserts, where ids are not sorted.
+        uint32_t lastAppearanceId = 0;
+        for (const auto& appearance : *appearances) {
+            if (appearance.id() > lastAppearanceId)
+                lastAppearanceId = appearance.id();
+            entries.emplace_back(static_cast<ThingCategory>(category), &appearance);
+        }
+        auto& things = m_thingTypes[category];
+        things.clear();
+        things.resize(lastAppearanceId + 1, m_nullThingType);
+    }
+
+    // entries don't depend on each other, only placing them in the tables is kept in order
+    ThingTypeList types(entries.size());
+    forEachChunk(entries.size(), [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& [category, appearance] = entries[i];
+            types[i] = std::make_shared<ThingType>();
+            types[i]->unserializeAppearance(appearance->id(), category, *appearance);
+        }
+    });
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        m_thingTypes[entries[i].first][types[i]->getId()] = types[i];
+    return true;
+}
+
+namespace {
+    constexpr uint32_t APPEARANCES_SNAPSHOT_SIGNATURE = 0x534E5441; // ATNS
+}
+
+std::string ThingTypeManager::getAppearancesSnapshotFile(const std::string& file)
+{
+    // one snapshot per assets folder, the folder may be shared by clients of different versions
+    const uint32_t hash = ::crc32(::crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(file.data()), static_cast<uInt>(file.size()));
+    return fmt::format("/appearances-{:08x}.snapshot", hash);
+}
+
+bool ThingTypeManager::loadAppearancesSnapshot(const std::string& snapshotFile, const AppearancesSource& source)
+{
+    if (!g_resources.fileExists(snapshotFile))
+        return false;
+
+    try {
+        const auto& fin = g_resources.openFile(snapshotFile);
+        fin->cache();
+
+        if (fin->getU32() != APPEARANCES_SNAPSHOT_SIGNATURE || fin->getU16() != ThingType::SNAPSHOT_VERSION)
+            return false;
+
+        // the assets changed since the snapshot was made, it is replaced once they are parsed
+        if (fin->getU32() != source.catalogHash || fin->get64() != source.appearancesTime || fin->getU16() != g_gameConfig.getSpriteSize())
+            return false;
+
+        ThingTypeList thingTypes[ThingLastCategory];
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            auto& things = thingTypes[category];
+            things.resize(fin->getU32(), m_nullThingType);
+
+            for (uint32_t i = 0, count = fin->getU32(); i < count; ++i) {
+                const uint16_t id = fin->getU16();
+                if (id >= things.size())
+                    throw Exception("invalid thing id {}", id);
+
+                const auto& type = std::make_shared<ThingType>();
+                type->unserializeSnapshot(id, static_cast<ThingCategory>(category), fin);
+                things[id] = type;
+            }
+        }
+
+        // written last, a missing one means the snapshot was cut short
+        if (fin->getU32() != APPEARANCES_SNAPSHOT_SIGNATURE)
+            return false;
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category)
+            m_thingTypes[category] = std::move(thingTypes[category]);
+
+        return true;
+    } catch (const std::exception& e) {
+        g_logger.warning("Failed to load appearances snapshot '{}': {}", snapshotFile, e.what());
+        return false;
+    }
+}
+
+void ThingTypeManager::saveAppearancesSnapshot(const std::string& snapshotFile, const AppearancesSource& source)
+{
+    try {
+        const auto& fin = g_resources.createFile(snapshotFile);
+        fin->cache();
+
+        fin->addU32(APPEARANCES_SNAPSHOT_SIGNATURE);
+        fin->addU16(ThingType::SNAPSHOT_VERSION);
+        fin->addU32(source.catalogHash);
+        fin->add64(source.appearancesTime);
+        fin->addU16(g_gameConfig.getSpriteSize());
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            const auto& things = m_thingTypes[category];
+            fin->addU32(things.size());
+            fin->addU32(std::ranges::count_if(things, [](const ThingTypePtr& type) { return !type->isNull(); }));
+
+            for (const auto& type : things) {
+                if (type->isNull())
+                    continue;
+
+                fin->addU16(type->getId());
+                type->serializeSnapshot(fin);
+            }
+        }
+
+        fin->addU32(APPEARANCES_SNAPSHOT_SIGNATURE);
+
+        fin->flush();
+        fin->close();
+    } catch (const std::exception& e) {
+        g_logger.warning("Failed to save appearances snapshot '{}': {}", snapshotFile, e.what());
+    }
+}
+
 namespace {
     using RaceBank = google::protobuf::RepeatedPtrField<staticdata::Creature>;
 
@@ -334,6 +514,16 @@ ThingTypeList ThingTypeManager::findThingTypeByAttr(const ThingAttr attr, const
     return ret;
 }
 
+size_t ThingTypeManager::getTextureMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto& thingTypes : m_thingTypes) {
+        for (const auto& type : thingTypes)
+            bytes += type->getTextureMemoryUsage();
+    }
+    return bytes;
+}
+
 const RaceType& ThingTypeManager::getRaceData(uint32_t raceId)
 {
     for (const auto& raceData : m_monsterRaces) {
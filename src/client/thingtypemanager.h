@@ -24,6 +24,8 @@
 
 #include "staticdata.h"
 
+namespace otclient::protobuf::appearances { class Appearances; }
+
 using RaceList = std::vector<RaceType>;
 static const RaceType emptyRaceType{};
 
@@ -62,6 +64,9 @@ public:
 
     ThingTypeList findThingTypeByAttr(ThingAttr attr, ThingCategory category);
 
+    // bytes of pixels held by the loaded textures of every thing type
+    size_t getTextureMemoryUsage() const;
+
     const RaceType& getRaceData(uint32_t raceId);
     RaceList getRacesByName(const std::string& searchString);
 
@@ -79,6 +84,20 @@ public:
     bool isValidDatId(const uint16_t id, const ThingCategory category) const { return category < ThingLastCategory && id >= 1 && id < m_thingTypes[category].size(); }
 
 private:
+    // identifies the assets a snapshot of appearances was made from
+    struct AppearancesSource
+    {
+        uint32_t catalogHash{ 0 };
+        ticks_t appearancesTime{ 0 };
+    };
+
+    // fills the tables from the appearances, in parallel, keeping the protobuf order where ids repeat
+    bool unserializeAppearances(const otclient::protobuf::appearances::Appearances& appearancesLib);
+
+    static std::string getAppearancesSnapshotFile(const std::string& file);
+    bool loadAppearancesSnapshot(const std::string& snapshotFile, const AppearancesSource& source);
+    void saveAppearancesSnapshot(const std::string& snapshotFile, const AppearancesSource& source);
+
     ThingTypeList m_thingTypes[ThingLastCategory];
     RaceList m_monsterRaces;
 
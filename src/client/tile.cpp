@@ -23,6 +23,7 @@
 #include "tile.h"
 
 #include "client.h"
+#include "creatureindex.h"
 #include "localplayer.h"
 #include "effect.h"
 #include "game.h"
@@ -316,7 +317,9 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
 
     m_things.insert(m_things.begin() + stackPos, thing);
 
+    const bool hadCreatures = m_lastCreatureIndex != -1;
     updateCreatureRangeForInsert(static_cast<int16_t>(stackPos), thing);
+    updateCreatureIndex(hadCreatures);
 
     setThingFlag(thing);
 
@@ -361,7 +364,9 @@ bool Tile::removeThing(const ThingPtr thing)
     thing->m_stackPos = -1;
     thing->setMarked(Color::white);
 
+    const bool hadCreatures = m_lastCreatureIndex != -1;
     recalculateThingFlag();
+    updateCreatureIndex(hadCreatures);
     if (thing->hasElevation())
         --m_elevation;
 
@@ -432,6 +437,21 @@ void Tile::rebuildCreatureRange()
     }
 }
 
+void Tile::updateCreatureIndex(const bool hadCreatures)
+{
+    if (!m_creatureIndex)
+        return;
+
+    const bool hasCreatures = m_lastCreatureIndex != -1;
+    if (hasCreatures == hadCreatures)
+        return;
+
+    if (hasCreatures)
+        m_creatureIndex->add(asTile());
+    else
+        m_creatureIndex->remove(asTile());
+}
+
 void Tile::appendSpectators(std::vector<CreaturePtr>& out) const
 {
     if (!hasCreatures() || m_lastCreatureIndex == -1) {
@@ -96,6 +96,9 @@ public:
 
     void appendSpectators(std::vector<CreaturePtr>& out) const;
 
+    // the index is told whenever the tile starts or stops holding creatures
+    void setCreatureIndex(CreatureIndex* index) { m_creatureIndex = index; }
+
     bool hasTopItem() const { return m_thingTypeFlag & HAS_TOP_ITEM; }
     bool hasCommonItem() const { return m_thingTypeFlag & HAS_COMMON_ITEM; }
     bool hasBottomItem() const { return m_thingTypeFlag & HAS_BOTTOM_ITEM; }
@@ -165,6 +168,7 @@ private:
 
     void updateCreatureRangeForInsert(int16_t stackPos, const ThingPtr& thing);
     void rebuildCreatureRange();
+    void updateCreatureIndex(bool hadCreatures);
 
     void setThingFlag(const ThingPtr& thing);
 
@@ -209,6 +213,8 @@ private:
     int16_t m_firstCreatureIndex{ -1 };
     int16_t m_lastCreatureIndex{ -1 };
 
+    CreatureIndex* m_creatureIndex{ nullptr };
+
     int8_t m_highlightThingStackPos = -1;
 
     TileSelectType m_selectType{ TileSelectType::NONE };
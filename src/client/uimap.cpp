@@ -164,6 +164,9 @@ void UIMap::setDrawHighlightTarget(const bool enable) { m_mapView->setDrawHighli
 void UIMap::setAntiAliasingMode(const Otc::AntialiasingMode mode) { m_mapView->setAntiAliasingMode(mode); }
 
 void UIMap::setFloorFading(const uint16_t v) { m_mapView->setFloorFading(v); }
+void UIMap::setParallelFloorRecording(const bool enable) { m_mapView->setParallelFloorRecording(enable); }
+bool UIMap::isParallelFloorRecording() { return m_mapView->isParallelFloorRecording(); }
+uint32_t UIMap::getFloorRecordTime(const uint8_t z) { return m_mapView->getFloorRecordTime(z); }
 
 MapViewPtr UIMap::getMapView() const { return m_mapView; }
 
@@ -71,6 +71,9 @@ public:
     void setDrawHighlightTarget(bool enable);
     void setAntiAliasingMode(Otc::AntialiasingMode mode);
     void setFloorFading(uint16_t v);
+    void setParallelFloorRecording(bool enable);
+    bool isParallelFloorRecording();
+    uint32_t getFloorRecordTime(uint8_t z);
     MapViewPtr getMapView() const;
     void clearTiles();
 
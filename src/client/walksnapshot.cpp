@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "walksnapshot.h"
+
+WalkSnapshot::WalkSnapshot(const Position& origin, const uint16_t width, const uint16_t height) :
+    m_origin(origin), m_width(width), m_height(height)
+{
+    const size_t size = static_cast<size_t>(width) * height;
+    const size_t words = (size + 63) / 64;
+
+    m_hasTile.resize(words, 0);
+    m_notWalkable.resize(words, 0);
+    m_notPathable.resize(words, 0);
+    m_speeds.resize(size, 100);
+}
+
+bool WalkSnapshot::contains(const Position& pos) const
+{
+    return pos.z == m_origin.z
+        && static_cast<uint32_t>(pos.x - m_origin.x) < m_width
+        && static_cast<uint32_t>(pos.y - m_origin.y) < m_height;
+}
+
+void WalkSnapshot::setCell(const Position& pos, const Cell& cell)
+{
+    if (!contains(pos))
+        return;
+
+    const uint32_t index = getIndex(pos);
+    assign(m_hasTile, index, true);
+    assign(m_notWalkable, index, !cell.walkable);
+    assign(m_notPathable, index, !cell.pathable);
+    m_speeds[index] = cell.speed;
+}
+
+void WalkSnapshot::removeCell(const Position& pos)
+{
+    if (!contains(pos))
+        return;
+
+    const uint32_t index = getIndex(pos);
+    assign(m_hasTile, index, false);
+    assign(m_notWalkable, index, false);
+    assign(m_notPathable, index, false);
+    m_speeds[index] = 100;
+}
+
+void WalkSnapshot::assign(std::vector<uint64_t>& plane, const uint32_t index, const bool value)
+{
+    const uint64_t bit = uint64_t{ 1 } << (index & 63);
+    if (value)
+        plane[index >> 6] |= bit;
+    else
+        plane[index >> 6] &= ~bit;
+}
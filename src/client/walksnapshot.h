@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "declarations.h"
+
+// Walkability and ground speed of the aware area of one floor, in bitplanes.
+// Map keeps the latest version and updates it as tiles change, worker threads
+// searching a path hold the version they started with. A version is never
+// changed once Map handed it out, the next change goes to a copy, so launching
+// a search only shares a pointer.
+// Only the tiles are kept: positions without one, inside or outside the area,
+// are still read from the minimap by the search, the same way the visible
+// node list it replaces left them.
+class WalkSnapshot
+{
+public:
+    struct Cell
+    {
+        uint16_t speed{ 100 };
+        bool walkable{ false };
+        bool pathable{ false };
+    };
+
+    WalkSnapshot(const Position& origin, uint16_t width, uint16_t height);
+
+    bool contains(const Position& pos) const;
+
+    // false outside the snapshot or when there is no tile at the position
+    bool hasTile(const Position& pos) const { return contains(pos) && test(m_hasTile, getIndex(pos)); }
+    // only meaningful where hasTile is true
+    bool isWalkable(const Position& pos) const { return !test(m_notWalkable, getIndex(pos)); }
+    bool isPathable(const Position& pos) const { return !test(m_notPathable, getIndex(pos)); }
+    uint16_t getSpeed(const Position& pos) const { return m_speeds[getIndex(pos)]; }
+
+    void setCell(const Position& pos, const Cell& cell);
+    void removeCell(const Position& pos);
+
+    const Position& getOrigin() const { return m_origin; }
+    uint16_t getWidth() const { return m_width; }
+    uint16_t getHeight() const { return m_height; }
+
+    // bumped by Map every time the snapshot is built or changed
+    void setVersion(const uint32_t version) { m_version = version; }
+    uint32_t getVersion() const { return m_version; }
+
+private:
+    uint32_t getIndex(const Position& pos) const
+    {
+        return static_cast<uint32_t>(pos.y - m_origin.y) * m_width + static_cast<uint32_t>(pos.x - m_origin.x);
+    }
+
+    static bool test(const std::vector<uint64_t>& plane, const uint32_t index) { return plane[index >> 6] & (uint64_t{ 1 } << (index & 63)); }
+    static void assign(std::vector<uint64_t>& plane, uint32_t index, bool value);
+
+    std::vector<uint64_t> m_hasTile;
+    std::vector<uint64_t> m_notWalkable;
+    std::vector<uint64_t> m_notPathable;
+    std::vector<uint16_t> m_speeds;
+
+    Position m_origin;
+
+    uint16_t m_width;
+    uint16_t m_height;
+
+    uint32_t m_version{ 0 };
+};
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "walkticker.h"
+
+#include "creature.h"
+
+#include <framework/core/clock.h>
+#include <framework/core/eventdispatcher.h>
+
+WalkTicker g_walkTicker;
+
+void WalkTicker::terminate()
+{
+    if (m_tickEvent) {
+        m_tickEvent->cancel();
+        m_tickEvent = nullptr;
+    }
+
+    for (const auto& walker : m_walkers)
+        walker.creature->m_walkTickerIndex = UINT32_MAX;
+    m_walkers.clear();
+}
+
+void WalkTicker::add(const CreaturePtr& creature)
+{
+    const ticks_t nextUpdate = g_clock.millis() + creature->m_stepCache.walkDuration;
+
+    if (creature->m_walkTickerIndex != UINT32_MAX) {
+        m_walkers[creature->m_walkTickerIndex].nextUpdate = nextUpdate;
+        return;
+    }
+
+    creature->m_walkTickerIndex = static_cast<uint32_t>(m_walkers.size());
+    m_walkers.push_back({ creature, nextUpdate });
+    schedule();
+}
+
+void WalkTicker::remove(const CreaturePtr& creature)
+{
+    const uint32_t index = creature->m_walkTickerIndex;
+    if (index == UINT32_MAX)
+        return;
+
+    creature->m_walkTickerIndex = UINT32_MAX;
+
+    // swap with the last walker to keep the array compact
+    if (index != m_walkers.size() - 1) {
+        m_walkers[index] = std::move(m_walkers.back());
+        m_walkers[index].creature->m_walkTickerIndex = index;
+    }
+    m_walkers.pop_back();
+}
+
+void WalkTicker::resetStats()
+{
+    m_updates = 0;
+    m_lastTickTime = 0;
+    m_maxTickTime = 0;
+}
+
+void WalkTicker::schedule()
+{
+    if (m_tickEvent || m_walkers.empty())
+        return;
+
+    // runs in the next poll
+    m_tickEvent = g_dispatcher.addEvent([this] {
+        m_tickEvent = nullptr;
+        tick();
+        schedule();
+    });
+}
+
+void WalkTicker::tick()
+{
+    stdext::timer timer;
+
+    const ticks_t now = g_clock.millis();
+    const auto& isDue = [now](const Walker& walker) { return now >= walker.nextUpdate || walker.creature->isCameraFollowing(); };
+
+    // updates end walks and start new ones, moving walkers around the array, so the due ones are taken first
+    for (const auto& walker : m_walkers) {
+        if (isDue(walker))
+            m_dueWalkers.emplace_back(walker.creature);
+    }
+
+    for (const auto& creature : m_dueWalkers) {
+        // ended by an earlier update, or walking again with its next update ahead
+        const uint32_t index = creature->m_walkTickerIndex;
+        if (index == UINT32_MAX || !isDue(m_walkers[index]))
+            continue;
+
+        creature->nextWalkUpdate();
+        ++m_updates;
+    }
+    m_dueWalkers.clear();
+
+    m_lastTickTime = static_cast<uint32_t>(timer.elapsed_micros());
+    m_maxTickTime = std::max(m_maxTickTime, m_lastTickTime);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "declarations.h"
+#include <framework/core/declarations.h>
+
+// Advances the walk of every walking creature from a single dispatcher event
+// per poll, instead of one scheduled event per creature and step update.
+// Each walker is still updated at its own pace (the step duration split by the
+// sprite size), creatures followed by the camera are updated every poll.
+//@bindsingleton g_walkTicker
+class WalkTicker
+{
+public:
+    void terminate();
+
+    // starts or keeps updating the walk of the creature, the next update is one walk duration from now
+    void add(const CreaturePtr& creature);
+    void remove(const CreaturePtr& creature);
+
+    uint32_t getActiveWalkers() const { return static_cast<uint32_t>(m_walkers.size()); }
+    // walk updates done by the ticker
+    uint64_t getUpdates() const { return m_updates; }
+    // in microseconds
+    uint32_t getLastTickTime() const { return m_lastTickTime; }
+    uint32_t getMaxTickTime() const { return m_maxTickTime; }
+    void resetStats();
+
+private:
+    void schedule();
+    void tick();
+
+    struct Walker
+    {
+        CreaturePtr creature;
+        ticks_t nextUpdate;
+    };
+
+    std::vector<Walker> m_walkers;
+    // creatures updated by the running tick
+    std::vector<CreaturePtr> m_dueWalkers;
+
+    EventPtr m_tickEvent;
+
+    uint64_t m_updates{ 0 };
+    uint32_t m_lastTickTime{ 0 };
+    uint32_t m_maxTickTime{ 0 };
+};
+
+extern WalkTicker g_walkTicker;
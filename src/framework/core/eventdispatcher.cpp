@@ -21,6 +21,7 @@
  */
 
 #include "asyncdispatcher.h"
+#include "clock.h"
 #include "eventdispatcher.h"
 #include "framework/stdext/stdext.h"
 
@@ -43,7 +44,8 @@ void EventDispatcher::shutdown()
         mergeEvents();
     } while (!m_eventList.empty());
 
-    m_scheduledEventList.clear();
+    m_scheduledEvents.clear();
+    m_canceledEventList.clear();
     m_deferEventList.clear();
     m_threads.clear();
 
@@ -65,9 +67,13 @@ ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& ca
 
     assert(delay >= 0);
 
-    return pushThreadTask<ScheduledEventPtr>([&](const std::unique_ptr<ThreadTask>& thread) {
-        return thread->scheduledEventList.emplace_back(std::make_shared<ScheduledEvent>(callback, delay, 1));
+    const auto event = std::make_shared<ScheduledEvent>(callback, delay, 1);
+    event->m_dispatcher = this;
+
+    pushThreadTask([&](const std::unique_ptr<ThreadTask>& thread) {
+        thread->scheduledEventList.emplace(event);
     });
+    return event;
 }
 
 ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callback, int delay)
@@ -77,9 +83,13 @@ ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callb
 
     assert(delay > 0);
 
-    return pushThreadTask<ScheduledEventPtr>([&](const std::unique_ptr<ThreadTask>& thread) {
-        return thread->scheduledEventList.emplace_back(std::make_shared<ScheduledEvent>(callback, delay, 0));
+    const auto event = std::make_shared<ScheduledEvent>(callback, delay, 0);
+    event->m_dispatcher = this;
+
+    pushThreadTask([&](const std::unique_ptr<ThreadTask>& thread) {
+        thread->scheduledEventList.emplace(event);
     });
+    return event;
 }
 
 EventPtr EventDispatcher::addEvent(const std::function<void()>& callback)
@@ -92,9 +102,11 @@ EventPtr EventDispatcher::addEvent(const std::function<void()>& callback)
         return std::make_shared<Event>(nullptr);
     }
 
-    return pushThreadTask<EventPtr>([&](const std::unique_ptr<ThreadTask>& thread) {
-        return thread->events.emplace_back(std::make_shared<Event>(callback));
+    const auto event = std::make_shared<Event>(callback);
+    pushThreadTask([&](const std::unique_ptr<ThreadTask>& thread) {
+        thread->events.emplace(event);
     });
+    return event;
 }
 
 void EventDispatcher::deferEvent(const std::function<void()>& callback) {
@@ -102,7 +114,16 @@ void EventDispatcher::deferEvent(const std::function<void()>& callback) {
         return;
 
     pushThreadTask([&](const std::unique_ptr<ThreadTask>& thread) {
-        thread->deferEvents.emplace_back(callback);
+        thread->deferEvents.emplace(callback);
+    });
+}
+
+void EventDispatcher::cancelScheduledEvent(const ScheduledEventPtr& event) {
+    if (m_disabled)
+        return;
+
+    pushThreadTask([&](const std::unique_ptr<ThreadTask>& thread) {
+        thread->canceledEventList.emplace(event);
     });
 }
 
@@ -143,15 +164,8 @@ void EventDispatcher::executeDeferEvents() {
         // Events are added directly without thread queues since we're single-threaded
         if (isGDisp && !logged) g_logger.info("g_disp deferEvents: skipping thread merge on Android");
 #else
-        for (const auto& thread : m_threads) {
-            SpinLock::Guard guard(thread->lock);
-            if (m_deferEventList.size() < thread->deferEvents.size())
-                m_deferEventList.swap(thread->deferEvents);
-            if (!thread->deferEvents.empty()) {
-                m_deferEventList.insert(m_deferEventList.end(), make_move_iterator(thread->deferEvents.begin()), make_move_iterator(thread->deferEvents.end()));
-                thread->deferEvents.clear();
-            }
-        }
+        for (const auto& thread : m_threads)
+            thread->deferEvents.drain([this](Event&& event) { m_deferEventList.emplace_back(std::move(event)); });
 #endif
         if (isGDisp && !logged) g_logger.info("g_disp executeDeferEvents after merge, deferList=" + std::to_string(m_deferEventList.size()));
     } while (!m_deferEventList.empty());
@@ -164,28 +178,17 @@ void EventDispatcher::executeDeferEvents() {
 }
 
 void EventDispatcher::executeScheduledEvents() {
-    auto& threadScheduledTasks = getThreadTask()->scheduledEventList;
-
-    auto it = m_scheduledEventList.begin();
-    while (it != m_scheduledEventList.end()) {
-        const auto& scheduledEvent = *it;
-        if (scheduledEvent->remainingTicks() > 0)
-            break;
+    const auto& thread = getThreadTask();
 
+    m_scheduledEvents.advance(g_clock.millis(), [&](const ScheduledEventPtr& scheduledEvent) {
         dispacherContext.type = scheduledEvent->maxCycles() > 0 ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
         dispacherContext.group = TaskGroup::Serial;
 
         scheduledEvent->execute();
 
         if (scheduledEvent->nextCycle())
-            threadScheduledTasks.emplace_back(scheduledEvent);
-
-        ++it;
-    }
-
-    if (it != m_scheduledEventList.begin()) {
-        m_scheduledEventList.erase(m_scheduledEventList.begin(), it);
-    }
+            thread->scheduledEventList.emplace(scheduledEvent);
+    });
 
     dispacherContext.reset();
 }
@@ -193,25 +196,60 @@ void EventDispatcher::executeScheduledEvents() {
 void EventDispatcher::mergeEvents() {
     // Merge events from all thread task queues into the main event list
     for (const auto& thread : m_threads) {
-        SpinLock::Guard guard(thread->lock);
-        if (!thread->events.empty()) {
-            if (m_eventList.size() < thread->events.size())
-                m_eventList.swap(thread->events);
-
-            if (!thread->events.empty()) {
-                m_eventList.insert(m_eventList.end(), make_move_iterator(thread->events.begin()), make_move_iterator(thread->events.end()));
-                thread->events.clear();
-            }
-        }
-
-        if (!thread->scheduledEventList.empty()) {
-            m_scheduledEventList.insert(make_move_iterator(thread->scheduledEventList.begin()), make_move_iterator(thread->scheduledEventList.end()));
-            thread->scheduledEventList.clear();
-        }
-
-        if (!thread->deferEvents.empty()) {
-            m_deferEventList.insert(m_deferEventList.end(), make_move_iterator(thread->deferEvents.begin()), make_move_iterator(thread->deferEvents.end()));
-            thread->deferEvents.clear();
-        }
+        thread->events.drain([this](EventPtr&& event) { m_eventList.emplace_back(std::move(event)); });
+
+        thread->scheduledEventList.drain([this](ScheduledEventPtr&& scheduledEvent) {
+            scheduledEvent->m_timerHandle = m_scheduledEvents.insert(scheduledEvent, scheduledEvent->ticks());
+        });
+
+        thread->canceledEventList.drain([this](ScheduledEventPtr&& event) { m_canceledEventList.emplace_back(std::move(event)); });
+        thread->deferEvents.drain([this](Event&& event) { m_deferEventList.emplace_back(std::move(event)); });
+    }
+
+    // after every queue was merged, an event may be canceled by a thread other than the one that scheduled it
+    for (const auto& event : m_canceledEventList)
+        m_scheduledEvents.cancel(event->m_timerHandle);
+    m_canceledEventList.clear();
+}
+
+uint64_t EventDispatcher::getQueuedTasks() const
+{
+    uint64_t count = 0;
+    for (const auto& thread : m_threads)
+        count += thread->sum([](const auto& queue) { return queue.getPushes(); });
+    return count;
+}
+
+uint64_t EventDispatcher::getContendedPushes() const
+{
+    uint64_t count = 0;
+    for (const auto& thread : m_threads)
+        count += thread->sum([](const auto& queue) { return queue.getContendedPushes(); });
+    return count;
+}
+
+uint64_t EventDispatcher::getOverflowPushes() const
+{
+    uint64_t count = 0;
+    for (const auto& thread : m_threads)
+        count += thread->sum([](const auto& queue) { return queue.getOverflowPushes(); });
+    return count;
+}
+
+size_t EventDispatcher::getMaxQueueDepth() const
+{
+    size_t depth = 0;
+    for (const auto& thread : m_threads)
+        depth = std::max({ depth, thread->events.getMaxDepth(), thread->deferEvents.getMaxDepth(), thread->scheduledEventList.getMaxDepth(), thread->canceledEventList.getMaxDepth() });
+    return depth;
+}
+
+void EventDispatcher::resetQueueStats()
+{
+    for (const auto& thread : m_threads) {
+        thread->events.resetStats();
+        thread->deferEvents.resetStats();
+        thread->scheduledEventList.resetStats();
+        thread->canceledEventList.resetStats();
     }
 }
\ No newline at end of file
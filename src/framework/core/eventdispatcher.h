@@ -23,7 +23,8 @@
 #pragma once
 
 #include "scheduledevent.h"
-#include <framework/util/spinlock.h>
+#include "timerwheel.h"
+#include <framework/util/mpscqueue.h>
 
 enum class TaskGroup : int8_t
 {
@@ -92,6 +93,13 @@ public:
         return dispacherContext;
     }
 
+    // summed over every thread queue
+    uint64_t getQueuedTasks() const;
+    uint64_t getContendedPushes() const;
+    uint64_t getOverflowPushes() const;
+    size_t getMaxQueueDepth() const;
+    void resetQueueStats();
+
 private:
     thread_local static DispatcherContext dispacherContext;
 
@@ -103,18 +111,18 @@ private:
         MERGED,
     };
 
-    // Thread Events
+    // Thread Events, pushed by any thread that maps to the slot and drained by the dispatcher
     struct ThreadTask
     {
-        ThreadTask() {
-            events.reserve(2000);
-            scheduledEventList.reserve(2000);
+        MpscQueue<EventPtr> events;
+        MpscQueue<Event> deferEvents;
+        MpscQueue<ScheduledEventPtr> scheduledEventList;
+        MpscQueue<ScheduledEventPtr> canceledEventList;
+
+        template<typename Getter>
+        auto sum(Getter getter) const {
+            return getter(events) + getter(deferEvents) + getter(scheduledEventList) + getter(canceledEventList);
         }
-
-        std::vector<EventPtr> events;
-        std::vector<Event> deferEvents;
-        std::vector<ScheduledEventPtr> scheduledEventList;
-        SpinLock lock;
     };
 
     inline void mergeEvents();
@@ -122,20 +130,15 @@ private:
     inline void executeDeferEvents();
     inline void executeScheduledEvents();
 
+    void cancelScheduledEvent(const ScheduledEventPtr& event);
+
     const std::unique_ptr<ThreadTask>& getThreadTask() const {
         return m_threads[stdext::getThreadId() % m_threads.size()];
     }
 
-    template<typename Result = void, typename Inserter>
-    Result pushThreadTask(Inserter inserter) {
-        const auto& thread = getThreadTask();
-        SpinLock::Guard guard(thread->lock);
-        if constexpr (std::is_void_v<Result>) {
-            inserter(thread);
-        } else {
-            Result result = inserter(thread);
-            return result;
-        }
+    template<typename Inserter>
+    void pushThreadTask(Inserter inserter) {
+        inserter(getThreadTask());
     }
 
     size_t m_pollEventsSize{};
@@ -146,7 +149,10 @@ private:
     // Main Events
     std::vector<EventPtr> m_eventList;
     std::vector<Event> m_deferEventList;
-    phmap::btree_multiset<ScheduledEventPtr, ScheduledEvent::Compare> m_scheduledEventList;
+    std::vector<ScheduledEventPtr> m_canceledEventList;
+    TimerWheel<ScheduledEventPtr> m_scheduledEvents;
+
+    friend class ScheduledEvent;
 };
 
 extern EventDispatcher g_dispatcher, g_textDispatcher, g_mainDispatcher;
@@ -21,6 +21,7 @@
  */
 
 #include "garbagecollection.h"
+#include "clock.h"
 
 #include "client/const.h"
 #include "client/thingtype.h"
@@ -35,8 +36,37 @@ constexpr uint32_t LUA_TIME = 15 * 60 * 1000; // 15min
 constexpr uint32_t TEXTURE_TIME = 30 * 60 * 1000; // 30min
 constexpr uint32_t THINGTYPE_TIME = 2 * 1000; // 2seg
 
+// incremental lua collection
+constexpr uint32_t LUA_CYCLE_TIME = 60 * 1000; // 1min, longest wait between cycles
+constexpr uint32_t LUA_CYCLE_GROWTH = 50; // percent the heap may grow before a cycle starts early
+constexpr uint32_t LUA_MIN_STEP = 1; // kbytes
+constexpr uint32_t LUA_MAX_STEP = 1024; // kbytes
+
 Timer lua_timer, texture_timer, drawpool_timer, thingtype_timer;
 
+namespace
+{
+    struct LuaCollector
+    {
+        bool incremental{ true };
+        bool collecting{ false };
+
+        uint32_t budget{ 1000 };
+        uint32_t stepSize{ 16 };
+
+        // heap size when the current cycle started, the last frame and when the last cycle ended
+        uint32_t cycleHeap{ 0 };
+        uint32_t frameHeap{ 0 };
+        uint32_t idleHeap{ 0 };
+
+        uint32_t lastPause{ 0 };
+        uint32_t maxPause{ 0 };
+        uint64_t totalPause{ 0 };
+        uint32_t cycles{ 0 };
+        uint32_t lastFreed{ 0 };
+    } luaCollector;
+}
+
 void GarbageCollection::poll() {
     if (canCheck(thingtype_timer, THINGTYPE_TIME))
         thingType();
@@ -44,7 +74,9 @@ void GarbageCollection::poll() {
     if (canCheck(texture_timer, TEXTURE_TIME))
         texture();
 
-    if (canCheck(lua_timer, LUA_TIME))
+    if (luaCollector.incremental)
+        luaStep();
+    else if (canCheck(lua_timer, LUA_TIME))
         lua();
 }
 
@@ -52,6 +84,79 @@ void GarbageCollection::lua() {
     g_lua.collectGarbage();
 }
 
+void GarbageCollection::luaStep() {
+    auto& gc = luaCollector;
+
+    const uint32_t heap = g_lua.getGarbageSize();
+    if (!gc.collecting) {
+        gc.lastPause = 0;
+        if (!canCheck(lua_timer, LUA_CYCLE_TIME) && heap < gc.idleHeap + gc.idleHeap * LUA_CYCLE_GROWTH / 100)
+            return;
+
+        lua_timer.restart();
+        gc.collecting = true;
+        gc.cycleHeap = heap;
+    } else if (heap > gc.frameHeap) {
+        // lua allocates faster than the cycle collects, take bigger steps
+        gc.stepSize = std::min<uint32_t>(gc.stepSize * 2, LUA_MAX_STEP);
+    }
+
+    stdext::timer timer;
+    uint32_t longestStep = 0;
+    while (gc.collecting) {
+        const auto stepStart = timer.elapsed_micros();
+        if (g_lua.stepGarbage(gc.stepSize)) {
+            gc.collecting = false;
+            ++gc.cycles;
+        }
+        longestStep = std::max<uint32_t>(longestStep, timer.elapsed_micros() - stepStart);
+
+        // stop when another step of the same length would overrun the budget
+        if (timer.elapsed_micros() + longestStep > gc.budget)
+            break;
+    }
+
+    // a single step took most of the budget, take smaller ones
+    if (longestStep > gc.budget / 2)
+        gc.stepSize = std::max<uint32_t>(gc.stepSize / 2, LUA_MIN_STEP);
+
+    gc.lastPause = static_cast<uint32_t>(timer.elapsed_micros());
+    gc.maxPause = std::max(gc.maxPause, gc.lastPause);
+    gc.totalPause += gc.lastPause;
+    gc.frameHeap = g_lua.getGarbageSize();
+
+    if (!gc.collecting) {
+        gc.idleHeap = gc.frameHeap;
+        gc.lastFreed = gc.cycleHeap > gc.idleHeap ? gc.cycleHeap - gc.idleHeap : 0;
+    }
+}
+
+void GarbageCollection::setLuaIncremental(const bool enabled) {
+    luaCollector.incremental = enabled;
+    luaCollector.collecting = false;
+    lua_timer.restart();
+}
+
+bool GarbageCollection::isLuaIncremental() { return luaCollector.incremental; }
+void GarbageCollection::setLuaStepBudget(const uint32_t budget) { luaCollector.budget = std::max<uint32_t>(budget, 1); }
+uint32_t GarbageCollection::getLuaStepBudget() { return luaCollector.budget; }
+
+uint32_t GarbageCollection::getLuaHeapSize() { return g_lua.getGarbageSize(); }
+uint32_t GarbageCollection::getLuaStepSize() { return luaCollector.stepSize; }
+uint32_t GarbageCollection::getLuaLastPause() { return luaCollector.lastPause; }
+uint32_t GarbageCollection::getLuaMaxPause() { return luaCollector.maxPause; }
+uint64_t GarbageCollection::getLuaTotalPause() { return luaCollector.totalPause; }
+uint32_t GarbageCollection::getLuaCycles() { return luaCollector.cycles; }
+uint32_t GarbageCollection::getLuaLastFreed() { return luaCollector.lastFreed; }
+
+void GarbageCollection::resetLuaStats() {
+    luaCollector.lastPause = 0;
+    luaCollector.maxPause = 0;
+    luaCollector.totalPause = 0;
+    luaCollector.cycles = 0;
+    luaCollector.lastFreed = 0;
+}
+
 void GarbageCollection::texture() {
     static constexpr uint32_t IDLE_TIME = 25 * 60 * 1000; // 25min
 
@@ -81,7 +186,7 @@ void GarbageCollection::thingType() {
 
     while (index < limit) {
         auto& thing = thingTypes[index];
-        if (thing->hasTexture() && thing->getLastTimeUsage().ticksElapsed() > IDLE_TIME) {
+        if (thing->hasTexture() && g_clock.millis() - thing->getLastTimeUsage() > IDLE_TIME) {
             thing->unload();
         }
         ++index;
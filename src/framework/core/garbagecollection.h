@@ -33,7 +33,26 @@ public:
     static void texture();
     static void thingType();
 
+    // collects lua garbage a little every frame instead of freezing on periodic full collects
+    static void setLuaIncremental(bool enabled);
+    static bool isLuaIncremental();
+    // time (in micros) each frame may spend collecting lua garbage
+    static void setLuaStepBudget(uint32_t budget);
+    static uint32_t getLuaStepBudget();
+
+    // sizes in kbytes, times in micros
+    static uint32_t getLuaHeapSize();
+    static uint32_t getLuaStepSize();
+    static uint32_t getLuaLastPause();
+    static uint32_t getLuaMaxPause();
+    static uint64_t getLuaTotalPause();
+    static uint32_t getLuaCycles();
+    static uint32_t getLuaLastFreed();
+    static void resetLuaStats();
+
 private:
+    static void luaStep();
+
     static bool canCheck(Timer& timer, const uint32_t delay) {
         if (timer.ticksElapsed() < delay)
             return false;
@@ -23,6 +23,7 @@
 #include "scheduledevent.h"
 
 #include "clock.h"
+#include "eventdispatcher.h"
 
 ScheduledEvent::ScheduledEvent(const std::function<void()>& callback, const int delay, const int maxCycles) : Event(callback),
 m_ticks(g_clock.millis() + delay), m_delay(delay), m_maxCycles(maxCycles) {}
@@ -41,6 +42,18 @@ void ScheduledEvent::execute()
     ++m_cyclesExecuted;
 }
 
+void ScheduledEvent::cancel()
+{
+    // the callback is dropped once the last cycle ran
+    const bool pending = !m_canceled && m_callback;
+
+    Event::cancel();
+
+    // removes it from the timer wheel instead of waiting for it to expire
+    if (pending && m_dispatcher)
+        m_dispatcher->cancelScheduledEvent(static_self_cast<ScheduledEvent>());
+}
+
 void ScheduledEvent::postpone() { m_ticks = g_clock.millis() + m_delay; }
 int ScheduledEvent::remainingTicks() { return m_ticks - g_clock.millis(); }
 bool ScheduledEvent::nextCycle()
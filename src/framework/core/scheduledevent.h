@@ -24,6 +24,9 @@
 
 #include "declarations.h"
 #include "event.h"
+#include "timerwheel.h"
+
+class EventDispatcher;
 
  // @bindclass
 class ScheduledEvent final : public Event
@@ -31,6 +34,7 @@ class ScheduledEvent final : public Event
 public:
     ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles = 0);
     void execute() override;
+    void cancel() override;
     void postpone();
     bool nextCycle();
 
@@ -53,4 +57,10 @@ private:
     int m_delay;
     int m_maxCycles;
     int m_cyclesExecuted{ 0 };
+
+    // set by the dispatcher that owns the event, the handle is only touched by its thread
+    EventDispatcher* m_dispatcher{ nullptr };
+    TimerHandle m_timerHandle;
+
+    friend class EventDispatcher;
 };
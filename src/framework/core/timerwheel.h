@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <framework/stdext/types.h>
+
+// Reference to an entry of a TimerWheel. The generation is bumped every time
+// an entry is released, so a handle kept after its entry fired can't touch a reused one.
+struct TimerHandle
+{
+    uint32_t index{ UINT32_MAX };
+    uint32_t generation{ 0 };
+};
+
+// Hierarchical timer wheel with 1ms resolution. Inserting, canceling and expiring
+// an entry is O(1), far timers are moved to the finer levels as the wheel turns.
+// Entries live in a slab that is recycled through a free list.
+// Entries expiring in the same advance call fire in (ticks, insertion) order.
+template<typename T>
+class TimerWheel
+{
+public:
+    using Handle = TimerHandle;
+
+    explicit TimerWheel(const ticks_t time = 0) : m_time(time) { m_buckets.fill(NONE); }
+
+    Handle insert(T value, const ticks_t ticks)
+    {
+        uint32_t index;
+        if (m_free != NONE) {
+            index = m_free;
+            m_free = m_nodes[index].next;
+        } else {
+            index = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        auto& node = m_nodes[index];
+        node.value = std::move(value);
+        node.ticks = ticks;
+        node.sequence = m_sequence++;
+
+        link(index);
+        ++m_size;
+
+        return { index, node.generation };
+    }
+
+    // false when the entry already fired or was canceled
+    bool cancel(const Handle& handle)
+    {
+        if (handle.index >= m_nodes.size())
+            return false;
+
+        const auto& node = m_nodes[handle.index];
+        if (node.generation != handle.generation || node.bucket == FREE)
+            return false;
+
+        // expiring entries are already out of their bucket
+        if (node.bucket != EXPIRING)
+            unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    // fires every entry with ticks <= now
+    template<typename Callback>
+    void advance(const ticks_t now, Callback&& callback)
+    {
+        while (m_time <= now) {
+            if (m_size == 0) {
+                m_time = now + 1;
+                break;
+            }
+
+            const auto slot = static_cast<uint32_t>(m_time & LEVEL0_MASK);
+            if (slot == 0) {
+                for (uint32_t level = 1; level < LEVELS; ++level) {
+                    const auto levelSlot = getLevelSlot(m_time, level);
+                    cascade(getBucket(level, levelSlot));
+                    if (levelSlot != 0)
+                        break;
+                }
+            }
+
+            // the wheel moves before firing, so entries inserted by the callback are never lost in the current slot
+            ++m_time;
+
+            auto index = m_buckets[slot];
+            if (index == NONE)
+                continue;
+
+            m_buckets[slot] = NONE;
+            m_expired.clear();
+            for (; index != NONE; index = m_nodes[index].next) {
+                auto& node = m_nodes[index];
+                node.bucket = EXPIRING;
+                m_expired.push_back({ index, node.generation });
+            }
+
+            // overdue entries share the slot of the current tick
+            if (m_expired.size() > 1) {
+                std::ranges::sort(m_expired, [this](const Handle& a, const Handle& b) {
+                    const auto& nodeA = m_nodes[a.index];
+                    const auto& nodeB = m_nodes[b.index];
+                    return nodeA.ticks != nodeB.ticks ? nodeA.ticks < nodeB.ticks : nodeA.sequence < nodeB.sequence;
+                });
+            }
+
+            for (const auto& expired : m_expired) {
+                // canceled by an earlier callback
+                if (m_nodes[expired.index].generation != expired.generation)
+                    continue;
+
+                T value = std::move(m_nodes[expired.index].value);
+                release(expired.index);
+                callback(value);
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_nodes.clear();
+        m_expired.clear();
+        m_buckets.fill(NONE);
+        m_free = NONE;
+        m_size = 0;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // next tick to be processed
+    ticks_t getTime() const { return m_time; }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr uint16_t FREE = UINT16_MAX;
+    static constexpr uint16_t EXPIRING = UINT16_MAX - 1;
+
+    static constexpr uint32_t LEVEL0_BITS = 8;
+    static constexpr uint32_t LEVEL_BITS = 6;
+    static constexpr uint32_t LEVELS = 5;
+    static constexpr uint32_t LEVEL0_SIZE = 1 << LEVEL0_BITS;
+    static constexpr uint32_t LEVEL_SIZE = 1 << LEVEL_BITS;
+    static constexpr ticks_t LEVEL0_MASK = LEVEL0_SIZE - 1;
+    static constexpr ticks_t LEVEL_MASK = LEVEL_SIZE - 1;
+    static constexpr ticks_t MAX_RANGE = (ticks_t{ 1 } << (LEVEL0_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+
+    struct Node
+    {
+        T value{};
+        ticks_t ticks{ 0 };
+        uint64_t sequence{ 0 };
+        uint32_t prev{ NONE };
+        uint32_t next{ NONE };
+        uint32_t generation{ 0 };
+        uint16_t bucket{ FREE };
+    };
+
+    static uint32_t getShift(const uint32_t level) { return LEVEL0_BITS + (level - 1) * LEVEL_BITS; }
+    static uint32_t getLevelSlot(const ticks_t ticks, const uint32_t level) { return static_cast<uint32_t>((ticks >> getShift(level)) & LEVEL_MASK); }
+    static uint16_t getBucket(const uint32_t level, const uint32_t slot)
+    {
+        return static_cast<uint16_t>(level == 0 ? slot : LEVEL0_SIZE + (level - 1) * LEVEL_SIZE + slot);
+    }
+
+    void link(const uint32_t index)
+    {
+        auto& node = m_nodes[index];
+
+        // overdue entries go to the slot of the current tick
+        const ticks_t expires = m_time + std::clamp<ticks_t>(node.ticks - m_time, 0, MAX_RANGE);
+        const ticks_t delta = expires - m_time;
+
+        uint16_t bucket;
+        if (delta < LEVEL0_SIZE)
+            bucket = getBucket(0, static_cast<uint32_t>(expires & LEVEL0_MASK));
+        else {
+            uint32_t level = 1;
+            while (level < LEVELS - 1 && delta >= (ticks_t{ 1 } << getShift(level + 1)))
+                ++level;
+            bucket = getBucket(level, getLevelSlot(expires, level));
+        }
+
+        node.bucket = bucket;
+        node.prev = NONE;
+        node.next = m_buckets[bucket];
+        if (node.next != NONE)
+            m_nodes[node.next].prev = index;
+        m_buckets[bucket] = index;
+    }
+
+    void unlink(const uint32_t index)
+    {
+        const auto& node = m_nodes[index];
+        if (node.prev != NONE)
+            m_nodes[node.prev].next = node.next;
+        else
+            m_buckets[node.bucket] = node.next;
+
+        if (node.next != NONE)
+            m_nodes[node.next].prev = node.prev;
+    }
+
+    void release(const uint32_t index)
+    {
+        auto& node = m_nodes[index];
+        node.value = T{};
+        node.bucket = FREE;
+        ++node.generation;
+        node.next = m_free;
+        m_free = index;
+        --m_size;
+    }
+
+    // moves the entries of a coarse slot to the levels below
+    void cascade(const uint16_t bucket)
+    {
+        auto index = m_buckets[bucket];
+        m_buckets[bucket] = NONE;
+        while (index != NONE) {
+            const auto next = m_nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<Handle> m_expired;
+    std::array<uint32_t, LEVEL0_SIZE + (LEVELS - 1) * LEVEL_SIZE> m_buckets;
+
+    ticks_t m_time;
+    uint64_t m_sequence{ 0 };
+    uint32_t m_free{ NONE };
+    size_t m_size{ 0 };
+};
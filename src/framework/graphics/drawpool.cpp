@@ -25,6 +25,47 @@
 #include "painter.h"
 #include "textureatlas.h"
 
+namespace
+{
+    // batches further back are not looked at, keeps batching linear
+    constexpr size_t MAX_BATCH_LOOKBACK = 32;
+
+    struct DrawBounds
+    {
+        float left{ std::numeric_limits<float>::max() };
+        float top{ std::numeric_limits<float>::max() };
+        float right{ std::numeric_limits<float>::lowest() };
+        float bottom{ std::numeric_limits<float>::lowest() };
+
+        void add(const DrawBounds& other)
+        {
+            left = std::min(left, other.left);
+            top = std::min(top, other.top);
+            right = std::max(right, other.right);
+            bottom = std::max(bottom, other.bottom);
+        }
+
+        // rects end one past their last pixel, touching draws don't overlap
+        bool intersects(const DrawBounds& other) const
+        {
+            return left < other.right && other.left < right && top < other.bottom && other.top < bottom;
+        }
+    };
+
+    DrawBounds getBounds(const CoordsBuffer& coords)
+    {
+        DrawBounds bounds;
+        const float* vertices = coords.getVertexArray();
+        for (int i = 0, s = coords.getVertexCount() * 2; i < s; i += 2) {
+            bounds.left = std::min(bounds.left, vertices[i]);
+            bounds.right = std::max(bounds.right, vertices[i]);
+            bounds.top = std::min(bounds.top, vertices[i + 1]);
+            bounds.bottom = std::max(bounds.bottom, vertices[i + 1]);
+        }
+        return bounds;
+    }
+}
+
 DrawPool* DrawPool::create(const DrawPoolType type)
 {
     auto pool = new DrawPool;
@@ -140,7 +181,7 @@ bool DrawPool::updateHash(const DrawMethod& method, const Texture* texture, cons
             stdext::hash_union(state.hash, texture->hash());
     }
 
-    if (hasFrameBuffer()) { // Pool Hash
+    if (hasFrameBuffer() || m_owner) { // Pool Hash
         size_t hash = state.hash;
 
         if (method.type == DrawMethodType::TRIANGLE) {
@@ -312,30 +353,155 @@ void DrawPool::release() {
             objs.clear();
         }
     }
+
+    batchObjects(m_objectsDraw[0]);
+}
+
+void DrawPool::batchObjects(std::vector<DrawObject>& objects)
+{
+    thread_local std::vector<DrawBounds> bounds;
+    bounds.resize(objects.size());
+
+    size_t count = 0; // objects kept
+    size_t barrier = 0; // first object a draw can be merged into
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        auto& obj = objects[i];
+
+        if (obj.action || !obj.coords) {
+            if (count != i)
+                objects[count] = std::move(obj);
+            barrier = ++count;
+            continue;
+        }
+
+        // positions are compared before being transformed, a transformed draw overlaps everything
+        DrawBounds objBounds = obj.state.transformMatrix == DEFAULT_MATRIX3 ? getBounds(*obj.coords) : DrawBounds{
+            .left = std::numeric_limits<float>::lowest(), .top = std::numeric_limits<float>::lowest(),
+            .right = std::numeric_limits<float>::max(), .bottom = std::numeric_limits<float>::max()
+        };
+
+        bool merged = false;
+        for (size_t j = count; j > barrier && count - j < MAX_BATCH_LOOKBACK; --j) {
+            auto& batch = objects[j - 1];
+            if (batch.state == obj.state) {
+                batch.coords->append(obj.coords.get());
+                bounds[j - 1].add(objBounds);
+                merged = true;
+                break;
+            }
+
+            if (bounds[j - 1].intersects(objBounds))
+                break;
+        }
+
+        if (merged)
+            continue;
+
+        if (count != i)
+            objects[count] = std::move(obj);
+        bounds[count++] = objBounds;
+    }
+
+    objects.erase(objects.begin() + count, objects.end());
+}
+
+void DrawPool::submit(const std::vector<DrawObject>& objects, const bool rebuildStream)
+{
+    const bool rebuild = rebuildStream || m_streamRanges.size() != objects.size();
+    if (rebuild) {
+        m_stream.clear();
+        m_streamRanges.clear();
+
+        for (const auto& obj : objects)
+            m_streamRanges.emplace_back(!obj.action && obj.coords ? m_stream.append(*obj.coords) : VertexStream::Range{});
+    }
+
+    // an unchanged stream is drawn from the buffer it was uploaded to, as long as the painter still holds it
+    if (rebuild || !g_painter->useStream(m_stream))
+        g_painter->uploadStream(m_stream);
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const auto& obj = objects[i];
+        if (obj.action) {
+            obj.action();
+        } else if (obj.coords) {
+            obj.state.execute(this);
+            g_painter->drawStream(m_streamRanges[i]);
+        }
+    }
 }
 
 void DrawPool::flush()
 {
     m_coords.clear();
 
-    for (auto& objs : m_objects) {
-        bool addFirst = true;
-        if (!objs.empty() && !m_objectsFlushed.empty()) {
-            auto& last = m_objectsFlushed.back();
-            auto& first = objs.front();
+    for (auto& objs : m_objects)
+        appendFlushed(objs);
+}
 
-            if (last.state == first.state && last.coords && first.coords) {
-                last.coords->append(first.coords.get());
-                addFirst = false;
-            }
+void DrawPool::appendFlushed(std::vector<DrawObject>& objs)
+{
+    bool addFirst = true;
+    if (!objs.empty() && !m_objectsFlushed.empty()) {
+        auto& last = m_objectsFlushed.back();
+        auto& first = objs.front();
+
+        if (last.state == first.state && last.coords && first.coords) {
+            last.coords->append(first.coords.get());
+            addFirst = false;
         }
+    }
+
+    m_objectsFlushed.insert(
+        m_objectsFlushed.end(),
+        std::make_move_iterator(objs.begin() + (addFirst ? 0 : 1)),
+        std::make_move_iterator(objs.end())
+    );
+    objs.clear();
+}
+
+void DrawPool::prepareRecorders(const size_t count)
+{
+    while (m_recorders.size() < count)
+        m_recorders.emplace_back(std::make_unique<DrawPool>());
+
+    for (size_t i = 0; i < count; ++i) {
+        auto& recorder = *m_recorders[i];
+
+        // starts from the state this pool is currently in
+        recorder.m_owner = this;
+        recorder.m_type = m_type;
+        recorder.m_atlas = m_atlas;
+        recorder.m_alwaysGroupDrawings = m_alwaysGroupDrawings;
+        recorder.m_scaleFactor = m_scaleFactor;
+        recorder.m_scale = m_scale;
+        recorder.m_bindedFramebuffers = m_bindedFramebuffers;
+        recorder.m_lastFramebufferId = m_lastFramebufferId;
+        recorder.m_currentDrawOrder = m_currentDrawOrder;
+        recorder.m_onlyOnceStateFlag = m_onlyOnceStateFlag;
+        recorder.m_shaderRefreshDelay = 0;
+        recorder.m_lastStateIndex = 0;
+        recorder.m_states[0] = getCurrentState();
+        recorder.m_coords.clear();
+        recorder.m_hashCtrl.reset();
+    }
+}
+
+void DrawPool::spliceRecorders(const size_t count)
+{
+    flush();
+
+    for (size_t i = 0; i < count; ++i) {
+        auto& recorder = *m_recorders[i];
+        recorder.flush();
+
+        appendFlushed(recorder.m_objectsFlushed);
+        m_hashCtrl.merge(recorder.m_hashCtrl);
 
-        m_objectsFlushed.insert(
-            m_objectsFlushed.end(),
-            std::make_move_iterator(objs.begin() + (addFirst ? 0 : 1)),
-            std::make_move_iterator(objs.end())
-        );
-        objs.clear();
+        m_lastFramebufferId = std::max(m_lastFramebufferId, recorder.m_lastFramebufferId);
+        if (recorder.m_shaderRefreshDelay > 0)
+            m_shaderRefreshDelay = recorder.m_shaderRefreshDelay;
     }
 }
 
@@ -467,7 +633,7 @@ void DrawPool::releaseFrameBuffer(const Rect& dest)
         frame->draw(dest);
     });
 
-    if (hasFrameBuffer() && !dest.isNull()) m_hashCtrl.put(dest.hash());
+    if ((hasFrameBuffer() || m_owner) && !dest.isNull()) m_hashCtrl.put(dest.hash());
     --m_bindedFramebuffers;
 }
 
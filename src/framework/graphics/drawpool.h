@@ -24,6 +24,7 @@
 
 #include "declarations.h"
 #include "framebuffer.h"
+#include "vertexstream.h"
 #include "framework/core/timer.h"
 #include <framework/util/spinlock.h>
 
@@ -55,6 +56,12 @@ struct DrawHashController
         return m_currentHash != m_lastHash;
     }
 
+    // continues the hash with what another controller recorded
+    void merge(const DrawHashController& other) {
+        stdext::hash_union(m_currentHash, other.m_currentHash);
+        m_lastObjectHash = other.m_lastObjectHash;
+    }
+
     void reset() {
         m_hashs.clear();
         m_lastHash = m_currentHash;
@@ -183,6 +190,14 @@ protected:
         std::function<void()> action{ nullptr };
     };
 
+    // Merges the draws sharing a state, keeping the result the same as drawing them in order:
+    // a draw only joins an earlier one when it doesn't overlap anything drawn in between.
+    // Actions are never crossed.
+    static void batchObjects(std::vector<DrawObject>& objects);
+
+    // uploads the coords of every object as a single stream, then draws it by ranges
+    void submit(const std::vector<DrawObject>& objects, bool rebuildStream = true);
+
 private:
 
     static DrawPool* create(DrawPoolType type);
@@ -263,6 +278,13 @@ private:
     }
 
     void flush();
+    void appendFlushed(std::vector<DrawObject>& objs);
+
+    // Recorders are detached pools owned by this one, they can be filled on worker threads
+    // and are appended back to this pool, in index order, once every recording has finished.
+    DrawPool* getRecorder(size_t index) { return m_recorders[index].get(); }
+    void prepareRecorders(size_t count);
+    void spliceRecorders(size_t count);
 
     void resetOnlyOnceParameters() {
         if (m_onlyOnceStateFlag > 0) { // Only Once State
@@ -317,11 +339,19 @@ private:
     std::vector<Matrix3> m_transformMatrixStack;
     std::vector<FrameBufferPtr> m_temporaryFramebuffers;
 
+    // declared before the objects, they may hold coords owned by a recorder
+    std::vector<std::unique_ptr<DrawPool>> m_recorders;
+    const DrawPool* m_owner{ nullptr };
+
     std::vector<DrawObject> m_objects[static_cast<uint8_t>(LAST)];
     std::vector<DrawObject> m_objectsFlushed;
     std::array<std::vector<DrawObject>, 2> m_objectsDraw;
     std::vector<CoordsBuffer*> m_coordsCache;
 
+    // used by the thread drawing the pool
+    VertexStream m_stream;
+    std::vector<VertexStream::Range> m_streamRanges;
+
     stdext::map<size_t, CoordsBuffer*> m_coords;
     stdext::map<std::string_view, std::any> m_parameters;
 
@@ -27,6 +27,7 @@
 #include "textureatlas.h"
 
 thread_local static uint8_t CURRENT_POOL = static_cast<uint8_t>(DrawPoolType::LAST);
+thread_local static DrawPool* CURRENT_RECORDER = nullptr;
 
 void resetSelectedPool() {
     CURRENT_POOL = static_cast<uint8_t>(DrawPoolType::LAST);
@@ -72,7 +73,7 @@ void DrawPoolManager::terminate() const
 
 DrawPoolType DrawPoolManager::getCurrentType() const { return static_cast<DrawPoolType>(CURRENT_POOL); }
 bool DrawPoolManager::isValid() const { return CURRENT_POOL < static_cast<uint8_t>(DrawPoolType::LAST); }
-DrawPool* DrawPoolManager::getCurrentPool() const { return m_pools[CURRENT_POOL]; }
+DrawPool* DrawPoolManager::getCurrentPool() const { return CURRENT_RECORDER ? CURRENT_RECORDER : m_pools[CURRENT_POOL]; }
 void DrawPoolManager::select(DrawPoolType type) { CURRENT_POOL = static_cast<uint8_t>(type); }
 bool DrawPoolManager::isPreDrawing() const { return CURRENT_POOL != static_cast<uint8_t>(DrawPoolType::LAST); }
 bool DrawPoolManager::shaderNeedFramebuffer() const { return getCurrentPool()->getCurrentState().shaderProgram && getCurrentPool()->getCurrentState().shaderProgram->useFramebuffer(); }
@@ -90,16 +91,6 @@ void DrawPoolManager::draw()
     }
 }
 
-void DrawPoolManager::drawObject(DrawPool* pool, const DrawPool::DrawObject& obj)
-{
-    if (obj.action) {
-        obj.action();
-    } else if (obj.coords) {
-        obj.state.execute(pool);
-        g_painter->drawCoords(*obj.coords, DrawMode::TRIANGLES);
-    }
-}
-
 void DrawPoolManager::addTexturedCoordsBuffer(const TexturePtr& texture, const CoordsBufferPtr& coords, const Color& color) const
 {
     getCurrentPool()->add(color, texture, DrawPool::DrawMethod{}, coords);
@@ -209,6 +200,25 @@ void DrawPoolManager::preDraw(const DrawPoolType type, const std::function<void(
     resetSelectedPool();
 }
 
+void DrawPoolManager::record(const DrawPoolType type, const size_t index, const std::function<void()>& f)
+{
+    // the worker goes on running unrelated tasks, even if the recording throws
+    struct Unbind
+    {
+        ~Unbind()
+        {
+            CURRENT_RECORDER = nullptr;
+            resetSelectedPool();
+        }
+    };
+
+    select(type);
+    CURRENT_RECORDER = get(type)->getRecorder(index);
+
+    const Unbind unbind;
+    f();
+}
+
 void DrawPoolManager::drawObjects(DrawPool* pool) {
     const auto hasFramebuffer = pool->hasFrameBuffer() && pool->m_framebuffer->isValid();
 
@@ -225,9 +235,7 @@ void DrawPoolManager::drawObjects(DrawPool* pool) {
         pool->m_shouldRepaint.store(false, std::memory_order_release);
     }
 
-    for (auto& obj : pool->m_objectsDraw[1]) {
-        drawObject(pool, obj);
-    }
+    pool->submit(pool->m_objectsDraw[1], shouldRepaint);
 
     if (hasFramebuffer) {
         pool->m_framebuffer->release();
@@ -114,13 +114,18 @@ public:
 
     void removeTextureFromAtlas(uint32_t id, bool smooth);
 
+    // Parallel recording: prepare and splice run on the thread drawing the pool,
+    // record can run on any thread, each index being recorded by one thread at a time.
+    void prepareRecorders(const DrawPoolType type, const size_t count) const { get(type)->prepareRecorders(count); }
+    void record(DrawPoolType type, size_t index, const std::function<void()>& f);
+    void spliceRecorders(const DrawPoolType type, const size_t count) const { get(type)->spliceRecorders(count); }
+
 private:
     DrawPool* getCurrentPool() const;
 
     void draw();
     void init(uint16_t spriteSize);
     void terminate() const;
-    void drawObject(DrawPool* pool, const DrawPool::DrawObject& obj);
     void drawPool(DrawPoolType type);
     void drawObjects(DrawPool* pool);
 
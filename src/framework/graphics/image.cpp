@@ -155,6 +155,26 @@ void Image::blit(const Point& dest, const ImagePtr& other)
     }
 }
 
+void Image::blit(const Point& dest, const ImagePtr& other, const Rect& source)
+{
+    assert(m_bpp == 4);
+
+    if (!other || !source.isValid())
+        return;
+
+    assert(Rect(Point(), other->getSize()).contains(source));
+    assert(Rect(Point(), m_size).contains(Rect(dest, source.size())));
+
+    for (int y = 0; y < source.height(); ++y) {
+        const uint8_t* otherRow = other->getPixel(source.left(), source.top() + y);
+        uint8_t* row = getPixel(dest.x, dest.y + y);
+        for (int x = 0; x < source.width(); ++x) {
+            if (otherRow[x * 4 + 3] != 0)
+                std::memcpy(row + x * 4, otherRow + x * 4, 4);
+        }
+    }
+}
+
 void Image::paste(const ImagePtr& other)
 {
     assert(m_bpp == 4);
@@ -39,6 +39,8 @@ public:
     void overwriteMask(const Color& maskedColor, const Color& insideColor = Color::white, const Color& outsideColor = Color::alpha);
     void overwrite(const Color& color);
     void blit(const Point& dest, const ImagePtr& other);
+    // blits only the source rect of other, it must be inside both images
+    void blit(const Point& dest, const ImagePtr& other, const Rect& source);
     void paste(const ImagePtr& other);
     void resize(const Size& size) {
         if (m_size == size)
@@ -22,6 +22,7 @@
 
 #include "painter.h"
 
+#include "framework/graphics/graphics.h"
 #include "framework/graphics/texture.h"
 #include "framework/graphics/texturemanager.h"
 #include "shader/shadersources.h"
@@ -62,17 +63,19 @@ Painter::Painter()
     PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
 }
 
-void Painter::drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode)
+Painter::~Painter()
 {
-    const int vertexCount = coordsBuffer.getVertexCount();
-    if (vertexCount == 0)
-        return;
-
-    if (coordsBuffer.getTextureCoordCount() > 0 && m_glTextureId == 0)
+    if (!g_graphics.ok())
         return;
 
-    const bool textured = coordsBuffer.getTextureCoordCount() > 0 && m_glTextureId > 0;
+    for (const auto buffer : m_streamBuffers) {
+        if (buffer != 0)
+            glDeleteBuffers(1, &buffer);
+    }
+}
 
+void Painter::bindDrawProgram(const bool textured)
+{
     m_drawProgram = m_shaderProgram ? m_shaderProgram : textured ? m_drawTexturedProgram.get() : m_drawSolidColorProgram.get();
 
     // update shader with the current painter state
@@ -84,13 +87,40 @@ void Painter::drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode)
     m_drawProgram->setResolution(m_resolution);
     m_drawProgram->updateTime();
 
-    // only set texture coords arrays when needed
     if (textured) {
         m_drawProgram->setTextureMatrix(m_textureMatrix);
         m_drawProgram->bindMultiTextures();
-        m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, coordsBuffer.getTextureCoordArray(), 2);
     } else
         PainterShaderProgram::disableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
+}
+
+void Painter::bindStreamBuffer(const bool bind)
+{
+    if (m_streamBound == bind)
+        return;
+
+    // client side arrays can only be used while no buffer is bound
+    glBindBuffer(GL_ARRAY_BUFFER, bind ? m_streamBuffers[m_streamIndex] : 0);
+    m_streamBound = bind;
+}
+
+void Painter::drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode)
+{
+    const int vertexCount = coordsBuffer.getVertexCount();
+    if (vertexCount == 0)
+        return;
+
+    if (coordsBuffer.getTextureCoordCount() > 0 && m_glTextureId == 0)
+        return;
+
+    const bool textured = coordsBuffer.getTextureCoordCount() > 0 && m_glTextureId > 0;
+
+    bindStreamBuffer(false);
+    bindDrawProgram(textured);
+
+    // only set texture coords arrays when needed
+    if (textured)
+        m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, coordsBuffer.getTextureCoordArray(), 2);
 
     // set vertex array
     m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR, coordsBuffer.getVertexArray(), 2);
@@ -102,8 +132,97 @@ void Painter::drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode)
         PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
 }
 
-void Painter::drawLine(const std::vector<float>& vertex, const int size, const int width) const
+int Painter::findStreamSlot(const VertexStream& stream) const
 {
+    for (uint8_t i = 0; i < STREAM_BUFFERS; ++i) {
+        const auto& slot = m_streamSlots[i];
+        if (slot.stream == &stream && slot.version == stream.getVersion())
+            return i;
+    }
+
+    return -1;
+}
+
+uint8_t Painter::claimStreamSlot(const VertexStream& stream)
+{
+    m_streamIndex = (m_streamIndex + 1) % STREAM_BUFFERS;
+    m_streamSlots[m_streamIndex] = { .stream = &stream, .version = stream.getVersion() };
+    return m_streamIndex;
+}
+
+bool Painter::useStream(const VertexStream& stream)
+{
+    const int slot = findStreamSlot(stream);
+    if (slot < 0)
+        return false;
+
+    if (slot != m_streamIndex) {
+        bindStreamBuffer(false);
+        m_streamIndex = slot;
+    }
+
+    bindStreamBuffer(true);
+    return true;
+}
+
+void Painter::uploadStream(const VertexStream& stream)
+{
+    if (stream.isEmpty())
+        return;
+
+    bindStreamBuffer(false);
+    const auto index = claimStreamSlot(stream);
+
+    auto& buffer = m_streamBuffers[index];
+    if (buffer == 0)
+        glGenBuffers(1, &buffer);
+
+    bindStreamBuffer(true);
+
+    // vertices first, then the texture coords
+    const size_t verticesSize = static_cast<size_t>(stream.getVertexCount()) * 2 * sizeof(float);
+
+    // orphan the storage before writing, the driver hands out a fresh one while
+    // draws queued from the old contents keep reading theirs
+    auto& capacity = m_streamBufferSizes[index];
+    capacity = std::max(capacity, std::bit_ceil(stream.getDataSize()));
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+
+    glBufferSubData(GL_ARRAY_BUFFER, 0, verticesSize, stream.getVertexArray());
+    glBufferSubData(GL_ARRAY_BUFFER, verticesSize, verticesSize, stream.getTextureCoordArray());
+
+    m_streamSlots[index].textureCoordOffset = verticesSize;
+}
+
+void Painter::drawStream(const VertexStream::Range& range, const DrawMode drawMode)
+{
+    if (range.count == 0)
+        return;
+
+    if (range.textured && m_glTextureId == 0)
+        return;
+
+    const bool textured = range.textured;
+
+    bindStreamBuffer(true);
+    bindDrawProgram(textured);
+
+    // with a buffer bound, the arrays are offsets inside of it
+    if (textured)
+        m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, reinterpret_cast<const float*>(m_streamSlots[m_streamIndex].textureCoordOffset), 2);
+
+    m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR, nullptr, 2);
+
+    glDrawArrays(static_cast<GLenum>(drawMode), range.first, range.count);
+
+    if (!textured)
+        PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
+}
+
+void Painter::drawLine(const std::vector<float>& vertex, const int size, const int width)
+{
+    bindStreamBuffer(false);
+
     m_drawLineProgram->bind();
     m_drawLineProgram->setTransformMatrix(m_transformMatrix);
     m_drawLineProgram->setProjectionMatrix(m_projectionMatrix);
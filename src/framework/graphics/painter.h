@@ -24,18 +24,25 @@
 
 #include <framework/graphics/declarations.h>
 #include <framework/graphics/paintershaderprogram.h>
-#include "coordsbuffer.h"
+#include "vertexstream.h"
 
 class Painter
 {
 public:
     Painter();
+    virtual ~Painter();
 
-    void clear(const Color& color);
-    void clearRect(const Color& color, const Rect& rect);
+    virtual void clear(const Color& color);
+    virtual void clearRect(const Color& color, const Rect& rect);
 
-    void drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode = DrawMode::TRIANGLES);
-    void drawLine(const std::vector<float>& vertex, int size, int width) const;
+    virtual void drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode = DrawMode::TRIANGLES);
+    virtual void drawLine(const std::vector<float>& vertex, int size, int width);
+
+    // the stream stays bound until the next upload, ranges of it can be drawn in between
+    virtual void uploadStream(const VertexStream& stream);
+    // binds the buffer still holding the last upload of this stream, false when it has to be uploaded again
+    virtual bool useStream(const VertexStream& stream);
+    virtual void drawStream(const VertexStream::Range& range, DrawMode drawMode = DrawMode::TRIANGLES);
 
     float getOpacity() const { return m_opacity; }
     bool getAlphaWriting() const { return m_alphaWriting; }
@@ -83,13 +90,16 @@ public:
     bool isReplaceColorShader(const PainterShaderProgram* shader) const { return m_drawReplaceColorProgram.get() == shader; }
 
 protected:
+    // painter that doesn't talk to the graphics driver, for backends overriding every gl call
+    explicit Painter(const Size& resolution) : m_resolution(resolution) {}
+
     void refreshState() const;
-    void updateGlTexture() const;
-    void updateGlCompositionMode() const;
-    void updateGlBlendEquation() const;
-    void updateGlClipRect() const;
-    void updateGlAlphaWriting() const;
-    void updateGlViewport() const;
+    virtual void updateGlTexture() const;
+    virtual void updateGlCompositionMode() const;
+    virtual void updateGlBlendEquation() const;
+    virtual void updateGlClipRect() const;
+    virtual void updateGlAlphaWriting() const;
+    virtual void updateGlViewport() const;
 
     Matrix3 m_transformMatrix;
     Matrix3 m_projectionMatrix;
@@ -111,11 +121,36 @@ protected:
     friend class DrawPoolManager;
     friend class DrawPool;
 
+    // bookkeeping of which stream each buffer of the ring holds
+    int findStreamSlot(const VertexStream& stream) const;
+    uint8_t claimStreamSlot(const VertexStream& stream);
+
     PainterShaderProgram* m_drawProgram{ nullptr };
     PainterShaderProgramPtr m_drawTexturedProgram;
     PainterShaderProgramPtr m_drawSolidColorProgram;
     PainterShaderProgramPtr m_drawReplaceColorProgram;
     PainterShaderProgramPtr m_drawLineProgram;
+
+private:
+    static constexpr uint8_t STREAM_BUFFERS = 4;
+
+    void bindDrawProgram(bool textured);
+    void bindStreamBuffer(bool bind);
+
+    struct StreamSlot
+    {
+        const VertexStream* stream{ nullptr };
+        uint32_t version{ 0 };
+        size_t textureCoordOffset{ 0 };
+    };
+
+    // ring of buffers, every upload orphans the storage of the buffer it writes,
+    // so a draw still reading the previous contents is never waited on or overwritten
+    std::array<uint32_t, STREAM_BUFFERS> m_streamBuffers{};
+    std::array<size_t, STREAM_BUFFERS> m_streamBufferSizes{};
+    std::array<StreamSlot, STREAM_BUFFERS> m_streamSlots{};
+    uint8_t m_streamIndex{ 0 };
+    bool m_streamBound{ false };
 };
 
 extern std::unique_ptr<Painter> g_painter;
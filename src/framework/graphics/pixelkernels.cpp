@@ -0,0 +1,594 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "pixelkernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PIXELS_TARGET_AVX2
+#else
+#define PIXELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PIXELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    struct Kernels
+    {
+        void (*swizzleRedBlue)(uint8_t*, size_t);
+        void (*clearColorKey)(uint8_t*, size_t, uint32_t);
+        void (*swizzleRedBlueClearColorKey)(uint8_t*, size_t, uint32_t);
+        void (*flipRows)(uint8_t*, size_t, size_t);
+        void (*rgbToRgba)(uint8_t*, const uint8_t*, size_t);
+        bool (*hasTransparentPixels)(const uint8_t*, size_t, size_t);
+        bool (*hasTranslucentPixel)(const uint8_t*, size_t);
+        void (*maxPixels)(uint8_t*, const uint8_t*, size_t);
+    };
+
+    namespace scalar
+    {
+        void swizzleRedBlue(uint8_t* pixels, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i, pixels += 4)
+                std::swap(pixels[0], pixels[2]);
+        }
+
+        void clearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            for (size_t i = 0; i < count; ++i, pixels += 4) {
+                if (static_cast<uint32_t>(pixels[0] | (pixels[1] << 8) | (pixels[2] << 16)) == rgb)
+                    std::memset(pixels, 0, 4);
+            }
+        }
+
+        void swizzleRedBlueClearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            for (size_t i = 0; i < count; ++i, pixels += 4) {
+                std::swap(pixels[0], pixels[2]);
+                if (static_cast<uint32_t>(pixels[0] | (pixels[1] << 8) | (pixels[2] << 16)) == rgb)
+                    std::memset(pixels, 0, 4);
+            }
+        }
+
+        void swapBytes(uint8_t* a, uint8_t* b, const size_t size)
+        {
+            std::swap_ranges(a, a + size, b);
+        }
+
+        void flipRows(uint8_t* data, const size_t rowBytes, const size_t rows)
+        {
+            for (size_t y = 0; y < rows / 2; ++y)
+                swapBytes(data + y * rowBytes, data + (rows - 1 - y) * rowBytes, rowBytes);
+        }
+
+        void rgbToRgba(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i, dst += 4, src += 3) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = 0xFF;
+            }
+        }
+
+        size_t countTransparentPixels(const uint8_t* pixels, const size_t count)
+        {
+            size_t transparent = 0;
+            for (size_t i = 0; i < count; ++i)
+                transparent += pixels[i * 4 + 3] == 0x00;
+            return transparent;
+        }
+
+        bool hasTransparentPixels(const uint8_t* pixels, const size_t count, const size_t minCount)
+        {
+            size_t transparent = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (pixels[i * 4 + 3] == 0x00 && ++transparent > minCount)
+                    return true;
+            }
+            return false;
+        }
+
+        bool hasTranslucentPixel(const uint8_t* pixels, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                if (pixels[i * 4 + 3] != 0xFF)
+                    return true;
+            }
+            return false;
+        }
+
+        void maxPixels(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            for (size_t i = 0; i < count * 4; ++i)
+                dst[i] = std::max(dst[i], src[i]);
+        }
+
+        constexpr Kernels kernels{ swizzleRedBlue, clearColorKey, swizzleRedBlueClearColorKey, flipRows, rgbToRgba, hasTransparentPixels, hasTranslucentPixel, maxPixels };
+    }
+
+#ifdef PIXELS_X86
+    namespace sse2
+    {
+        inline __m128i swizzle(const __m128i p)
+        {
+            const __m128i alphaGreen = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+            const __m128i low = _mm_set1_epi32(0x000000FF);
+            return _mm_or_si128(_mm_and_si128(p, alphaGreen),
+                                _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, low), 16), _mm_and_si128(_mm_srli_epi32(p, 16), low)));
+        }
+
+        inline __m128i clearKey(const __m128i p, const __m128i key)
+        {
+            const __m128i color = _mm_and_si128(p, _mm_set1_epi32(0x00FFFFFF));
+            return _mm_andnot_si128(_mm_cmpeq_epi32(color, key), p);
+        }
+
+        void swizzleRedBlue(uint8_t* pixels, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto* ptr = reinterpret_cast<__m128i*>(pixels + i * 4);
+                _mm_storeu_si128(ptr, swizzle(_mm_loadu_si128(ptr)));
+            }
+            scalar::swizzleRedBlue(pixels + i * 4, count - i);
+        }
+
+        void clearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            const __m128i key = _mm_set1_epi32(static_cast<int>(rgb));
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto* ptr = reinterpret_cast<__m128i*>(pixels + i * 4);
+                _mm_storeu_si128(ptr, clearKey(_mm_loadu_si128(ptr), key));
+            }
+            scalar::clearColorKey(pixels + i * 4, count - i, rgb);
+        }
+
+        void swizzleRedBlueClearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            const __m128i key = _mm_set1_epi32(static_cast<int>(rgb));
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto* ptr = reinterpret_cast<__m128i*>(pixels + i * 4);
+                _mm_storeu_si128(ptr, clearKey(swizzle(_mm_loadu_si128(ptr)), key));
+            }
+            scalar::swizzleRedBlueClearColorKey(pixels + i * 4, count - i, rgb);
+        }
+
+        void flipRows(uint8_t* data, const size_t rowBytes, const size_t rows)
+        {
+            for (size_t y = 0; y < rows / 2; ++y) {
+                uint8_t* top = data + y * rowBytes;
+                uint8_t* bottom = data + (rows - 1 - y) * rowBytes;
+
+                size_t x = 0;
+                for (; x + 16 <= rowBytes; x += 16) {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + x));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + x));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(top + x), b);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(bottom + x), a);
+                }
+                scalar::swapBytes(top + x, bottom + x, rowBytes - x);
+            }
+        }
+
+        bool hasTransparentPixels(const uint8_t* pixels, const size_t count, const size_t minCount)
+        {
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t transparent = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+                const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(p, alpha), zero)));
+                transparent += std::popcount(static_cast<uint32_t>(mask));
+                if (transparent > minCount)
+                    return true;
+            }
+            return transparent + scalar::countTransparentPixels(pixels + i * 4, count - i) > minCount;
+        }
+
+        bool hasTranslucentPixel(const uint8_t* pixels, const size_t count)
+        {
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+                if (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(p, alpha), alpha))) != 0xF)
+                    return true;
+            }
+            return scalar::hasTranslucentPixel(pixels + i * 4, count - i);
+        }
+
+        void maxPixels(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto* ptr = reinterpret_cast<__m128i*>(dst + i * 4);
+                _mm_storeu_si128(ptr, _mm_max_epu8(_mm_loadu_si128(ptr), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4))));
+            }
+            scalar::maxPixels(dst + i * 4, src + i * 4, count - i);
+        }
+
+        // no byte shuffle in sse2, rgb expansion stays scalar
+        constexpr Kernels kernels{ swizzleRedBlue, clearColorKey, swizzleRedBlueClearColorKey, flipRows, scalar::rgbToRgba, hasTransparentPixels, hasTranslucentPixel, maxPixels };
+    }
+
+    namespace avx2
+    {
+        PIXELS_TARGET_AVX2 inline __m256i swizzle(const __m256i p)
+        {
+            const __m256i alphaGreen = _mm256_set1_epi32(static_cast<int>(0xFF00FF00));
+            const __m256i low = _mm256_set1_epi32(0x000000FF);
+            return _mm256_or_si256(_mm256_and_si256(p, alphaGreen),
+                                   _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, low), 16), _mm256_and_si256(_mm256_srli_epi32(p, 16), low)));
+        }
+
+        PIXELS_TARGET_AVX2 inline __m256i clearKey(const __m256i p, const __m256i key)
+        {
+            const __m256i color = _mm256_and_si256(p, _mm256_set1_epi32(0x00FFFFFF));
+            return _mm256_andnot_si256(_mm256_cmpeq_epi32(color, key), p);
+        }
+
+        PIXELS_TARGET_AVX2 void swizzleRedBlue(uint8_t* pixels, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                auto* ptr = reinterpret_cast<__m256i*>(pixels + i * 4);
+                _mm256_storeu_si256(ptr, swizzle(_mm256_loadu_si256(ptr)));
+            }
+            sse2::swizzleRedBlue(pixels + i * 4, count - i);
+        }
+
+        PIXELS_TARGET_AVX2 void clearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            const __m256i key = _mm256_set1_epi32(static_cast<int>(rgb));
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                auto* ptr = reinterpret_cast<__m256i*>(pixels + i * 4);
+                _mm256_storeu_si256(ptr, clearKey(_mm256_loadu_si256(ptr), key));
+            }
+            sse2::clearColorKey(pixels + i * 4, count - i, rgb);
+        }
+
+        PIXELS_TARGET_AVX2 void swizzleRedBlueClearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            const __m256i key = _mm256_set1_epi32(static_cast<int>(rgb));
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                auto* ptr = reinterpret_cast<__m256i*>(pixels + i * 4);
+                _mm256_storeu_si256(ptr, clearKey(swizzle(_mm256_loadu_si256(ptr)), key));
+            }
+            sse2::swizzleRedBlueClearColorKey(pixels + i * 4, count - i, rgb);
+        }
+
+        PIXELS_TARGET_AVX2 void flipRows(uint8_t* data, const size_t rowBytes, const size_t rows)
+        {
+            for (size_t y = 0; y < rows / 2; ++y) {
+                uint8_t* top = data + y * rowBytes;
+                uint8_t* bottom = data + (rows - 1 - y) * rowBytes;
+
+                size_t x = 0;
+                for (; x + 32 <= rowBytes; x += 32) {
+                    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + x));
+                    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + x));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(top + x), b);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bottom + x), a);
+                }
+                scalar::swapBytes(top + x, bottom + x, rowBytes - x);
+            }
+        }
+
+        PIXELS_TARGET_AVX2 void rgbToRgba(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            // 4 pixels per shuffle, the 16 byte load reads 4 bytes past them
+            const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+            size_t i = 0;
+            for (; i + 6 <= count; i += 4) {
+                const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+            }
+            scalar::rgbToRgba(dst + i * 4, src + i * 3, count - i);
+        }
+
+        PIXELS_TARGET_AVX2 bool hasTransparentPixels(const uint8_t* pixels, const size_t count, const size_t minCount)
+        {
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t transparent = 0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i * 4));
+                const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(p, alpha), zero)));
+                transparent += std::popcount(static_cast<uint32_t>(mask));
+                if (transparent > minCount)
+                    return true;
+            }
+            return transparent + scalar::countTransparentPixels(pixels + i * 4, count - i) > minCount;
+        }
+
+        PIXELS_TARGET_AVX2 bool hasTranslucentPixel(const uint8_t* pixels, const size_t count)
+        {
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i * 4));
+                if (_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(p, alpha), alpha))) != 0xFF)
+                    return true;
+            }
+            return sse2::hasTranslucentPixel(pixels + i * 4, count - i);
+        }
+
+        PIXELS_TARGET_AVX2 void maxPixels(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                auto* ptr = reinterpret_cast<__m256i*>(dst + i * 4);
+                _mm256_storeu_si256(ptr, _mm256_max_epu8(_mm256_loadu_si256(ptr), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4))));
+            }
+            sse2::maxPixels(dst + i * 4, src + i * 4, count - i);
+        }
+
+        constexpr Kernels kernels{ swizzleRedBlue, clearColorKey, swizzleRedBlueClearColorKey, flipRows, rgbToRgba, hasTransparentPixels, hasTranslucentPixel, maxPixels };
+    }
+
+    bool cpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // the os must save the ymm registers too
+        __cpuid(info, 1);
+        if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+#ifdef PIXELS_NEON
+    namespace neon
+    {
+        inline void swizzle(uint8x16x4_t& p)
+        {
+            std::swap(p.val[0], p.val[2]);
+        }
+
+        inline void clearKey(uint8x16x4_t& p, const uint32_t rgb)
+        {
+            const uint8x16_t match = vandq_u8(vandq_u8(vceqq_u8(p.val[0], vdupq_n_u8(rgb & 0xFF)),
+                                                       vceqq_u8(p.val[1], vdupq_n_u8((rgb >> 8) & 0xFF))),
+                                              vceqq_u8(p.val[2], vdupq_n_u8((rgb >> 16) & 0xFF)));
+            for (auto& channel : p.val)
+                channel = vbicq_u8(channel, match);
+        }
+
+        void swizzleRedBlue(uint8_t* pixels, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t p = vld4q_u8(pixels + i * 4);
+                swizzle(p);
+                vst4q_u8(pixels + i * 4, p);
+            }
+            scalar::swizzleRedBlue(pixels + i * 4, count - i);
+        }
+
+        void clearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t p = vld4q_u8(pixels + i * 4);
+                clearKey(p, rgb);
+                vst4q_u8(pixels + i * 4, p);
+            }
+            scalar::clearColorKey(pixels + i * 4, count - i, rgb);
+        }
+
+        void swizzleRedBlueClearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t p = vld4q_u8(pixels + i * 4);
+                swizzle(p);
+                clearKey(p, rgb);
+                vst4q_u8(pixels + i * 4, p);
+            }
+            scalar::swizzleRedBlueClearColorKey(pixels + i * 4, count - i, rgb);
+        }
+
+        void flipRows(uint8_t* data, const size_t rowBytes, const size_t rows)
+        {
+            for (size_t y = 0; y < rows / 2; ++y) {
+                uint8_t* top = data + y * rowBytes;
+                uint8_t* bottom = data + (rows - 1 - y) * rowBytes;
+
+                size_t x = 0;
+                for (; x + 16 <= rowBytes; x += 16) {
+                    const uint8x16_t a = vld1q_u8(top + x);
+                    const uint8x16_t b = vld1q_u8(bottom + x);
+                    vst1q_u8(top + x, b);
+                    vst1q_u8(bottom + x, a);
+                }
+                scalar::swapBytes(top + x, bottom + x, rowBytes - x);
+            }
+        }
+
+        void rgbToRgba(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                const uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+                const uint8x16x4_t rgba = { { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF) } };
+                vst4q_u8(dst + i * 4, rgba);
+            }
+            scalar::rgbToRgba(dst + i * 4, src + i * 3, count - i);
+        }
+
+        bool hasTransparentPixels(const uint8_t* pixels, const size_t count, const size_t minCount)
+        {
+            size_t transparent = 0;
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                const uint8x16x4_t p = vld4q_u8(pixels + i * 4);
+                transparent += vaddvq_u8(vshrq_n_u8(vceqq_u8(p.val[3], vdupq_n_u8(0)), 7));
+                if (transparent > minCount)
+                    return true;
+            }
+            return transparent + scalar::countTransparentPixels(pixels + i * 4, count - i) > minCount;
+        }
+
+        bool hasTranslucentPixel(const uint8_t* pixels, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                if (vminvq_u8(vld4q_u8(pixels + i * 4).val[3]) != 0xFF)
+                    return true;
+            }
+            return scalar::hasTranslucentPixel(pixels + i * 4, count - i);
+        }
+
+        void maxPixels(uint8_t* dst, const uint8_t* src, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                vst1q_u8(dst + i * 4, vmaxq_u8(vld1q_u8(dst + i * 4), vld1q_u8(src + i * 4)));
+            scalar::maxPixels(dst + i * 4, src + i * 4, count - i);
+        }
+
+        constexpr Kernels kernels{ swizzleRedBlue, clearColorKey, swizzleRedBlueClearColorKey, flipRows, rgbToRgba, hasTransparentPixels, hasTranslucentPixel, maxPixels };
+    }
+#endif
+
+    Pixels::Isa detectIsa()
+    {
+#if defined(PIXELS_X86)
+        return cpuHasAvx2() ? Pixels::Isa::Avx2 : Pixels::Isa::Sse2;
+#elif defined(PIXELS_NEON)
+        return Pixels::Isa::Neon;
+#else
+        return Pixels::Isa::Scalar;
+#endif
+    }
+
+    const Kernels& getKernels(const Pixels::Isa isa)
+    {
+        switch (isa) {
+#ifdef PIXELS_X86
+            case Pixels::Isa::Sse2: return sse2::kernels;
+            case Pixels::Isa::Avx2: return avx2::kernels;
+#endif
+#ifdef PIXELS_NEON
+            case Pixels::Isa::Neon: return neon::kernels;
+#endif
+            default: return scalar::kernels;
+        }
+    }
+
+    struct Dispatch
+    {
+        Pixels::Isa isa;
+        const Kernels* kernels;
+    };
+
+    Dispatch& getDispatch()
+    {
+        static Dispatch dispatch = [] {
+            const auto isa = detectIsa();
+            return Dispatch{ isa, &getKernels(isa) };
+        }();
+        return dispatch;
+    }
+}
+
+namespace Pixels
+{
+    Isa getIsa() { return getDispatch().isa; }
+
+    bool isSupported(const Isa isa)
+    {
+        switch (isa) {
+            case Isa::Scalar: return true;
+#ifdef PIXELS_X86
+            case Isa::Sse2: return true;
+            case Isa::Avx2: return cpuHasAvx2();
+#endif
+#ifdef PIXELS_NEON
+            case Isa::Neon: return true;
+#endif
+            default: return false;
+        }
+    }
+
+    bool setIsa(const Isa isa)
+    {
+        if (!isSupported(isa))
+            return false;
+
+        getDispatch() = { isa, &getKernels(isa) };
+        return true;
+    }
+
+    std::string_view getIsaName(const Isa isa)
+    {
+        switch (isa) {
+            case Isa::Sse2: return "sse2";
+            case Isa::Avx2: return "avx2";
+            case Isa::Neon: return "neon";
+            default: return "scalar";
+        }
+    }
+
+    void swizzleRedBlue(uint8_t* pixels, const size_t count) { getDispatch().kernels->swizzleRedBlue(pixels, count); }
+    void clearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb) { getDispatch().kernels->clearColorKey(pixels, count, rgb); }
+    void swizzleRedBlueClearColorKey(uint8_t* pixels, const size_t count, const uint32_t rgb) { getDispatch().kernels->swizzleRedBlueClearColorKey(pixels, count, rgb); }
+    void flipRows(uint8_t* data, const size_t rowBytes, const size_t rows) { getDispatch().kernels->flipRows(data, rowBytes, rows); }
+    void rgbToRgba(uint8_t* dst, const uint8_t* src, const size_t count) { getDispatch().kernels->rgbToRgba(dst, src, count); }
+    bool hasTransparentPixels(const uint8_t* pixels, const size_t count, const size_t minCount) { return getDispatch().kernels->hasTransparentPixels(pixels, count, minCount); }
+    bool hasTranslucentPixel(const uint8_t* pixels, const size_t count) { return getDispatch().kernels->hasTranslucentPixel(pixels, count); }
+    void maxPixels(uint8_t* dst, const uint8_t* src, const size_t count) { getDispatch().kernels->maxPixels(dst, src, count); }
+}
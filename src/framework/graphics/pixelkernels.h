@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Pixel loops of the sprite loaders, vectorized for the running cpu.
+// Every instruction set produces exactly the same output as the scalar one.
+// Pixels are 4 bytes in memory order (rgba), counts are in pixels.
+namespace Pixels
+{
+    enum class Isa : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+        Neon
+    };
+
+    // instruction set used by the kernels, the best one the cpu supports unless changed by setIsa
+    Isa getIsa();
+    bool isSupported(Isa isa);
+    // for tests and benchmarks, not thread safe; false when the cpu doesn't support it
+    bool setIsa(Isa isa);
+    std::string_view getIsaName(Isa isa);
+
+    // bgra <-> rgba
+    void swizzleRedBlue(uint8_t* pixels, size_t count);
+    // pixels whose color is rgb (r | g << 8 | b << 16) become fully transparent black
+    void clearColorKey(uint8_t* pixels, size_t count, uint32_t rgb);
+    // swizzleRedBlue followed by clearColorKey, in a single pass
+    void swizzleRedBlueClearColorKey(uint8_t* pixels, size_t count, uint32_t rgb);
+    // swaps the first row with the last one and so on
+    void flipRows(uint8_t* data, size_t rowBytes, size_t rows);
+    // expands rgb to rgba with full alpha
+    void rgbToRgba(uint8_t* dst, const uint8_t* src, size_t count);
+    // true when more than minCount pixels have alpha 0
+    bool hasTransparentPixels(const uint8_t* pixels, size_t count, size_t minCount = 0);
+    // true when any pixel alpha is below 255
+    bool hasTranslucentPixel(const uint8_t* pixels, size_t count);
+    // per channel max of both, stored in dst
+    void maxPixels(uint8_t* dst, const uint8_t* src, size_t count);
+}
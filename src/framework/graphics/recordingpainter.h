@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "painter.h"
+
+// Painter that records what would be sent to the graphics driver instead of sending it,
+// so the amount of draw calls and state changes of a submission can be checked without a gpu.
+class RecordingPainter final : public Painter
+{
+public:
+    struct Draw
+    {
+        int first{ 0 };
+        int count{ 0 };
+        uint32_t textureId{ 0 };
+        bool textured{ false };
+        bool streamed{ false };
+    };
+
+    explicit RecordingPainter(const Size& resolution = { 1024, 1024 }) : Painter(resolution) {}
+
+    void clear(const Color&) override { ++m_clears; }
+    void clearRect(const Color&, const Rect&) override { ++m_clears; }
+
+    void drawCoords(const CoordsBuffer& coordsBuffer, DrawMode) override
+    {
+        if (coordsBuffer.getVertexCount() == 0 || (coordsBuffer.getTextureCoordCount() > 0 && m_glTextureId == 0))
+            return;
+
+        m_draws.emplace_back(0, coordsBuffer.getVertexCount(), m_glTextureId, coordsBuffer.getTextureCoordCount() > 0, false);
+    }
+
+    void drawLine(const std::vector<float>&, const int size, int) override { m_draws.emplace_back(0, size, 0, false, false); }
+
+    void uploadStream(const VertexStream& stream) override
+    {
+        if (stream.isEmpty())
+            return;
+
+        claimStreamSlot(stream);
+        ++m_uploads;
+        m_uploadedVertices += stream.getVertexCount();
+    }
+
+    bool useStream(const VertexStream& stream) override { return findStreamSlot(stream) >= 0; }
+
+    void drawStream(const VertexStream::Range& range, DrawMode) override
+    {
+        if (range.count == 0 || (range.textured && m_glTextureId == 0))
+            return;
+
+        m_draws.emplace_back(range.first, range.count, m_glTextureId, range.textured, true);
+    }
+
+    const std::vector<Draw>& getDraws() const { return m_draws; }
+    size_t getDrawCalls() const { return m_draws.size(); }
+    size_t getStateChanges() const { return m_stateChanges; }
+    size_t getTextureChanges() const { return m_textureChanges; }
+    size_t getUploads() const { return m_uploads; }
+    size_t getUploadedVertices() const { return m_uploadedVertices; }
+    size_t getClears() const { return m_clears; }
+
+    void resetCounters()
+    {
+        m_draws.clear();
+        m_stateChanges = m_textureChanges = m_uploads = m_uploadedVertices = m_clears = 0;
+    }
+
+protected:
+    void updateGlTexture() const override { if (m_glTextureId != 0) { ++m_textureChanges; ++m_stateChanges; } }
+    void updateGlCompositionMode() const override { ++m_stateChanges; }
+    void updateGlBlendEquation() const override { ++m_stateChanges; }
+    void updateGlClipRect() const override { ++m_stateChanges; }
+    void updateGlAlphaWriting() const override { ++m_stateChanges; }
+    void updateGlViewport() const override {}
+
+private:
+    std::vector<Draw> m_draws;
+
+    mutable size_t m_stateChanges{ 0 };
+    mutable size_t m_textureChanges{ 0 };
+    size_t m_uploads{ 0 };
+    size_t m_uploadedVertices{ 0 };
+    size_t m_clears{ 0 };
+};
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "rectpacker.h"
+#include "textureatlas.h"
+
+#include <set>
+
+bool RectPacker::packRects(const Size& binSize, const std::vector<Size>& sizes, const std::vector<uint32_t>& order, std::vector<Point>& positions)
+{
+    std::set<FreeRegion> freeRegions{ { 0, 0, binSize.width(), binSize.height(), 0 } };
+    for (const uint32_t i : order) {
+        const auto& size = sizes[i];
+        // regions are sorted by area, the first that fits wastes the least
+        const auto it = std::ranges::find_if(freeRegions, [&](const FreeRegion& region) { return region.canFit(size.width(), size.height()); });
+        if (it == freeRegions.end())
+            return false;
+
+        const FreeRegion region = *it;
+        freeRegions.erase(it);
+        positions[i] = { region.x, region.y };
+
+        const auto& insertRegion = [&](const int x, const int y, const int w, const int h) {
+            if (w > 0 && h > 0)
+                freeRegions.insert({ x, y, w, h, 0 });
+        };
+
+        insertRegion(region.x + size.width(), region.y, region.width - size.width(), size.height());
+        insertRegion(region.x, region.y + size.height(), size.width(), region.height - size.height());
+        insertRegion(region.x + size.width(), region.y + size.height(), region.width - size.width(), region.height - size.height());
+    }
+
+    return true;
+}
+
+Size RectPacker::packFrames(const std::vector<Size>& sizes, std::vector<Point>& positions)
+{
+    positions.assign(sizes.size(), Point());
+
+    std::vector<uint32_t> order;
+    Size binSize(1);
+    int area = 0;
+    for (uint32_t i = 0; i < sizes.size(); ++i) {
+        const auto& size = sizes[i];
+        if (size.area() == 0)
+            continue;
+
+        order.emplace_back(i);
+        area += size.area();
+        while (binSize.width() < size.width())
+            binSize.setWidth(binSize.width() * 2);
+        while (binSize.height() < size.height())
+            binSize.setHeight(binSize.height() * 2);
+    }
+
+    std::ranges::sort(order, [&](const uint32_t a, const uint32_t b) {
+        return sizes[a].height() != sizes[b].height() ? sizes[a].height() > sizes[b].height() : sizes[a].width() > sizes[b].width();
+    });
+
+    const auto& grow = [&] {
+        if (binSize.width() <= binSize.height())
+            binSize.setWidth(binSize.width() * 2);
+        else
+            binSize.setHeight(binSize.height() * 2);
+    };
+
+    while (binSize.area() < area)
+        grow();
+
+    while (!packRects(binSize, sizes, order, positions))
+        grow();
+
+    return binSize;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "coordsbuffer.h"
+
+// Coords of every draw of a pool packed in one vertex/texture coord pair,
+// uploaded once per submission and drawn by ranges.
+class VertexStream
+{
+public:
+    struct Range
+    {
+        int first{ 0 };
+        int count{ 0 };
+        bool textured{ false };
+    };
+
+    void clear()
+    {
+        m_vertices.clear();
+        m_textureCoords.clear();
+        ++m_version;
+    }
+
+    Range append(const CoordsBuffer& coords)
+    {
+        const Range range{ .first = getVertexCount(), .count = coords.getVertexCount(), .textured = coords.getTextureCoordCount() > 0 };
+
+        m_vertices.insert(m_vertices.end(), coords.getVertexArray(), coords.getVertexArray() + range.count * 2);
+
+        // texture coords are kept aligned with the vertices, untextured ranges are padded
+        if (range.textured) {
+            const int count = std::min<int>(coords.getTextureCoordCount(), range.count);
+            m_textureCoords.insert(m_textureCoords.end(), coords.getTextureCoordArray(), coords.getTextureCoordArray() + count * 2);
+        }
+        m_textureCoords.resize(m_vertices.size());
+
+        return range;
+    }
+
+    const float* getVertexArray() const { return m_vertices.data(); }
+    const float* getTextureCoordArray() const { return m_textureCoords.data(); }
+    int getVertexCount() const { return m_vertices.size() / 2; }
+    bool isEmpty() const { return m_vertices.empty(); }
+
+    // changes every time the stream is cleared, so an upload of older contents can be told apart
+    uint32_t getVersion() const { return m_version; }
+
+    // bytes taken by the vertices and the texture coords
+    size_t getDataSize() const { return (m_vertices.size() + m_textureCoords.size()) * sizeof(float); }
+
+private:
+    std::vector<float> m_vertices;
+    std::vector<float> m_textureCoords;
+    uint32_t m_version{ 0 };
+};
@@ -843,6 +843,16 @@ void LuaInterface::collectGarbage() const
     }
 }
 
+bool LuaInterface::stepGarbage(const int kbytes) const
+{
+    return lua_gc(L, LUA_GCSTEP, kbytes) == 1;
+}
+
+int LuaInterface::getGarbageSize() const
+{
+    return lua_gc(L, LUA_GCCOUNT, 0);
+}
+
 void LuaInterface::loadBuffer(const std::string_view buffer, const std::string_view source)
 {
     // loads lua buffer
@@ -269,6 +269,10 @@ public:
     void closeLuaState();
 
     void collectGarbage() const;
+    // one incremental collection step of about kbytes, true when it finished a cycle
+    bool stepGarbage(int kbytes) const;
+    // kbytes in use by lua
+    int getGarbageSize() const;
 
     void loadBuffer(std::string_view buffer, std::string_view source);
 
@@ -24,6 +24,7 @@
 #include <framework/core/config.h>
 #include <framework/core/configmanager.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/garbagecollection.h>
 #include <framework/core/module.h>
 #include <framework/core/modulemanager.h>
 #include <framework/core/resourcemanager.h>
@@ -235,6 +236,27 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_dispatcher", "scheduleEvent", &EventDispatcher::scheduleEvent, &g_dispatcher);
     g_lua.bindSingletonFunction("g_dispatcher", "cycleEvent", &EventDispatcher::cycleEvent, &g_dispatcher);
     g_lua.bindSingletonFunction("g_dispatcher", "deferEvent", &EventDispatcher::deferEvent, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getQueuedTasks", &EventDispatcher::getQueuedTasks, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getContendedPushes", &EventDispatcher::getContendedPushes, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getOverflowPushes", &EventDispatcher::getOverflowPushes, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getMaxQueueDepth", &EventDispatcher::getMaxQueueDepth, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "resetQueueStats", &EventDispatcher::resetQueueStats, &g_dispatcher);
+
+    // GarbageCollection
+    g_lua.registerSingletonClass("g_gc");
+    g_lua.bindClassStaticFunction("g_gc", "collectLua", &GarbageCollection::lua);
+    g_lua.bindClassStaticFunction("g_gc", "setLuaIncremental", &GarbageCollection::setLuaIncremental);
+    g_lua.bindClassStaticFunction("g_gc", "isLuaIncremental", &GarbageCollection::isLuaIncremental);
+    g_lua.bindClassStaticFunction("g_gc", "setLuaStepBudget", &GarbageCollection::setLuaStepBudget);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaStepBudget", &GarbageCollection::getLuaStepBudget);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaHeapSize", &GarbageCollection::getLuaHeapSize);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaStepSize", &GarbageCollection::getLuaStepSize);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaLastPause", &GarbageCollection::getLuaLastPause);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaMaxPause", &GarbageCollection::getLuaMaxPause);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaTotalPause", &GarbageCollection::getLuaTotalPause);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaCycles", &GarbageCollection::getLuaCycles);
+    g_lua.bindClassStaticFunction("g_gc", "getLuaLastFreed", &GarbageCollection::getLuaLastFreed);
+    g_lua.bindClassStaticFunction("g_gc", "resetLuaStats", &GarbageCollection::resetLuaStats);
 
     // ResourceManager
     g_lua.registerSingletonClass("g_resources");
@@ -34,29 +34,14 @@ PacketPlayer::~PacketPlayer()
 PacketPlayer::PacketPlayer(const std::string_view& file)
 {
 #ifdef ANDROID
-    std::ifstream f(std::string("records/") + std::string(file));
+    const bool opened = m_reader.open(std::string("records/") + std::string(file));
 #else
-    std::ifstream f(std::filesystem::path("records") / file);
+    const bool opened = m_reader.open(std::filesystem::path("records") / file);
 #endif
-    if (!f.is_open())
+    if (!opened)
         return;
-    std::string type, packetHex;
-    ticks_t time;
-    while (f >> type >> time >> packetHex) {
-        // Convert hex string to binary data manually
-        std::string packetStr;
-        for (size_t i = 0; i < packetHex.length(); i += 2) {
-            std::string byteString = packetHex.substr(i, 2);
-            char byte = (char)strtol(byteString.c_str(), nullptr, 16);
-            packetStr.push_back(byte);
-        }
-        auto packet = std::make_shared<std::vector<uint8_t>>(packetStr.begin(), packetStr.end());
-        if (type == "<") {
-            m_input.push_back(std::make_pair(time, packet));
-        } else if (type == ">") {
-            m_output.push_back(std::make_pair(time, packet));
-        }
-    }
+
+    m_hasNextInput = readNextInput();
 }
 
 void PacketPlayer::start(std::function<void(std::shared_ptr<std::vector<uint8_t>>)> recvCallback,
@@ -83,22 +68,42 @@ void PacketPlayer::onOutputPacket(const OutputMessagePtr& packet)
     }
 }
 
+void PacketPlayer::seek(const ticks_t time)
+{
+    m_reader.seek(time);
+    m_hasNextInput = readNextInput();
+    m_start = g_clock.millis() - time;
+
+    if (m_event) {
+        m_event->cancel();
+        m_event = g_dispatcher.scheduleEvent(std::bind(&PacketPlayer::process, this), 1);
+    }
+}
+
+bool PacketPlayer::readNextInput()
+{
+    while (m_reader.next(m_nextInput)) {
+        if (m_nextInput.direction == PacketRecordInput)
+            return true;
+    }
+    return false;
+}
+
 void PacketPlayer::process()
 {
     ticks_t nextPacket = 1;
-    while (!m_input.empty()) {
-        auto& packet = m_input.front();
-        nextPacket = (packet.first + m_start) - g_clock.millis();
+    while (m_hasNextInput) {
+        nextPacket = (m_nextInput.time + m_start) - g_clock.millis();
         if (nextPacket > 1)
             break;
-        m_recvCallback(packet.second);
-        m_input.pop_front();
+        m_recvCallback(m_nextInput.data);
+        m_hasNextInput = readNextInput();
     }
 
-    if (!m_input.empty() && nextPacket > 1) {
+    if (m_hasNextInput && nextPacket > 1) {
         m_event = g_dispatcher.scheduleEvent(std::bind(&PacketPlayer::process, this), nextPacket);
     } else {
         m_disconnectCallback(asio::error::eof);
         stop();
     }
-}
\ No newline at end of file
+}
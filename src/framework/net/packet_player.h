@@ -25,6 +25,7 @@
 #include <framework/net/outputmessage.h>
 
 #include "framework/core/declarations.h"
+#include "packet_record.h"
 
 class PacketPlayer : public LuaObject
 {
@@ -35,15 +36,21 @@ public:
     void start(std::function<void(std::shared_ptr<std::vector<uint8_t>>)> recvCallback, std::function<void(std::error_code)> disconnectCallback);
     void stop();
 
+    // playback continues from time, packets recorded before it are skipped
+    void seek(ticks_t time);
+    ticks_t getDuration() const { return m_reader.getDuration(); }
+
     void onOutputPacket(const OutputMessagePtr& packet);
 
 private:
     void process();
+    bool readNextInput();
 
     ticks_t m_start;
     ScheduledEventPtr m_event;
-    std::deque<std::pair<ticks_t, std::shared_ptr<std::vector<uint8_t>>>> m_input;
-    std::deque<std::pair<ticks_t, std::shared_ptr<std::vector<uint8_t>>>> m_output;
+    PacketRecordReader m_reader;
+    PacketRecordReader::Frame m_nextInput;
+    bool m_hasNextInput{ false };
     std::function<void(std::shared_ptr<std::vector<uint8_t>>)> m_recvCallback;
     std::function<void(std::error_code)> m_disconnectCallback;
 };
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "packet_record.h"
+
+namespace
+{
+    // value of each hex digit, text records only hold valid ones
+    constexpr auto HEX_VALUES = [] {
+        std::array<uint8_t, 256> values{};
+        for (int i = 0; i < 10; ++i)
+            values['0' + i] = i;
+        for (int i = 0; i < 6; ++i)
+            values['a' + i] = values['A' + i] = 10 + i;
+        return values;
+    }();
+}
+
+bool PacketRecordReader::open(const std::filesystem::path& path)
+{
+    m_file = std::ifstream(path, std::ios::binary);
+    if (!m_file.is_open())
+        return false;
+
+    uint8_t header[PACKET_RECORD_HEADER_SIZE];
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)) || stdext::readULE32(header) != PACKET_RECORD_SIGNATURE) {
+        m_file.clear();
+        m_file.seekg(0);
+        return loadTextRecord();
+    }
+
+    if (stdext::readULE16(header + 4) > PACKET_RECORD_VERSION) {
+        g_logger.error("packet record '{}' has an unsupported version", path.string());
+        return false;
+    }
+
+    m_flags = stdext::readULE16(header + 6);
+    m_binary = true;
+
+    m_file.seekg(0, std::ios::end);
+    const uint64_t fileSize = m_file.tellg();
+    if (!loadIndex(fileSize))
+        scanBlocks(fileSize);
+
+    if (!m_blocks.empty())
+        m_duration = m_blocks.back().lastTime;
+    return true;
+}
+
+bool PacketRecordReader::loadTextRecord()
+{
+    std::string type, packetHex;
+    ticks_t time;
+    while (m_file >> type >> time >> packetHex) {
+        const bool output = type == ">";
+        if (!output && type != "<")
+            continue;
+
+        auto packet = std::make_shared<std::vector<uint8_t>>(packetHex.length() / 2);
+        for (size_t i = 0; i < packet->size(); ++i)
+            (*packet)[i] = HEX_VALUES[static_cast<uint8_t>(packetHex[i * 2])] << 4 | HEX_VALUES[static_cast<uint8_t>(packetHex[i * 2 + 1])];
+
+        m_frames.emplace_back(time, output ? PacketRecordOutput : PacketRecordInput, std::move(packet));
+        m_duration = std::max(m_duration, time);
+    }
+
+    m_file.close();
+    return true;
+}
+
+bool PacketRecordReader::loadIndex(const uint64_t fileSize)
+{
+    if (fileSize < PACKET_RECORD_HEADER_SIZE + PACKET_RECORD_TRAILER_SIZE)
+        return false;
+
+    uint8_t trailer[PACKET_RECORD_TRAILER_SIZE];
+    m_file.seekg(fileSize - PACKET_RECORD_TRAILER_SIZE);
+    if (!m_file.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) || stdext::readULE32(trailer + 8) != PACKET_RECORD_INDEX_SIGNATURE)
+        return false;
+
+    const uint64_t indexOffset = stdext::readULE64(trailer);
+    const uint64_t indexEnd = fileSize - PACKET_RECORD_TRAILER_SIZE;
+    if (indexOffset < PACKET_RECORD_HEADER_SIZE || indexOffset + 4 > indexEnd)
+        return false;
+
+    std::vector<uint8_t> index(indexEnd - indexOffset);
+    m_file.seekg(indexOffset);
+    if (!m_file.read(reinterpret_cast<char*>(index.data()), index.size()))
+        return false;
+
+    const uint32_t count = stdext::readULE32(index.data());
+    if (4 + static_cast<uint64_t>(count) * PACKET_RECORD_INDEX_ENTRY_SIZE != index.size())
+        return false;
+
+    m_blocks.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* entry = index.data() + 4 + i * PACKET_RECORD_INDEX_ENTRY_SIZE;
+        m_blocks.emplace_back(stdext::readULE32(entry), stdext::readULE32(entry + 4), stdext::readULE64(entry + 8));
+    }
+    return true;
+}
+
+void PacketRecordReader::scanBlocks(const uint64_t fileSize)
+{
+    // the recording was not closed, only the block headers are read
+    uint64_t offset = PACKET_RECORD_HEADER_SIZE;
+    uint8_t header[PACKET_RECORD_BLOCK_HEADER_SIZE];
+    while (offset + PACKET_RECORD_BLOCK_HEADER_SIZE <= fileSize) {
+        m_file.seekg(offset);
+        if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+            break;
+
+        const uint32_t firstTime = stdext::readULE32(header);
+        const uint32_t lastTime = stdext::readULE32(header + 4);
+        const uint32_t frameCount = stdext::readULE32(header + 8);
+        const uint32_t rawSize = stdext::readULE32(header + 12);
+        const uint32_t storedSize = stdext::readULE32(header + 16);
+
+        // what follows the last block may be a cut index, which does not pass for a block header
+        const uint32_t previousTime = m_blocks.empty() ? 0 : m_blocks.back().lastTime;
+        if (frameCount == 0 || storedSize == 0 || firstTime > lastTime || firstTime < previousTime
+            || rawSize < static_cast<uint64_t>(frameCount) * PACKET_RECORD_FRAME_HEADER_SIZE
+            || (!(m_flags & PacketRecordCompressed) && rawSize != storedSize))
+            break;
+
+        // last block may be cut
+        const uint64_t end = offset + PACKET_RECORD_BLOCK_HEADER_SIZE + storedSize;
+        if (end > fileSize)
+            break;
+
+        m_blocks.emplace_back(firstTime, lastTime, offset);
+        offset = end;
+    }
+    m_file.clear();
+}
+
+bool PacketRecordReader::loadBlock(const size_t index)
+{
+    m_frames.clear();
+    m_cursor = 0;
+    m_nextBlock = index + 1;
+
+    uint8_t header[PACKET_RECORD_BLOCK_HEADER_SIZE];
+    m_file.seekg(m_blocks[index].offset);
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+
+    const uint32_t frameCount = stdext::readULE32(header + 8);
+    const uint32_t rawSize = stdext::readULE32(header + 12);
+
+    std::vector<uint8_t> data(stdext::readULE32(header + 16));
+    if (!m_file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        return false;
+
+    if (m_flags & PacketRecordCompressed) {
+        std::vector<uint8_t> raw(rawSize);
+        unsigned long rawLength = rawSize;
+        if (uncompress(raw.data(), &rawLength, data.data(), data.size()) != Z_OK || rawLength != rawSize)
+            return false;
+        data = std::move(raw);
+    }
+
+    m_frames.reserve(frameCount);
+    for (size_t pos = 0; pos + PACKET_RECORD_FRAME_HEADER_SIZE <= data.size();) {
+        const uint8_t* frame = data.data() + pos;
+        const uint32_t length = stdext::readULE32(frame + 5);
+        pos += PACKET_RECORD_FRAME_HEADER_SIZE;
+        if (pos + length > data.size())
+            return false;
+
+        m_frames.emplace_back(stdext::readULE32(frame + 1), static_cast<PacketRecordDirection>(frame[0]),
+                              std::make_shared<std::vector<uint8_t>>(data.begin() + pos, data.begin() + pos + length));
+        pos += length;
+    }
+    return true;
+}
+
+bool PacketRecordReader::next(Frame& frame)
+{
+    while (m_cursor >= m_frames.size()) {
+        if (!m_binary || m_nextBlock >= m_blocks.size())
+            return false;
+
+        if (!loadBlock(m_nextBlock)) {
+            g_logger.error("packet record is corrupted, stopping at block {}", m_nextBlock - 1);
+            m_nextBlock = m_blocks.size();
+            return false;
+        }
+    }
+
+    frame = m_frames[m_cursor++];
+    return true;
+}
+
+void PacketRecordReader::seek(const ticks_t time)
+{
+    if (m_binary) {
+        // last block started before time, when every frame of it is older the next block is loaded by next()
+        const auto it = std::ranges::upper_bound(m_blocks, time, {}, [](const BlockInfo& block) { return static_cast<ticks_t>(block.firstTime); });
+        const size_t index = it == m_blocks.begin() ? 0 : std::distance(m_blocks.begin(), it) - 1;
+
+        m_frames.clear();
+        m_cursor = 0;
+        m_nextBlock = index;
+        if (index >= m_blocks.size())
+            return;
+
+        if (!loadBlock(index)) {
+            m_frames.clear();
+            m_nextBlock = m_blocks.size();
+            return;
+        }
+    }
+
+    m_cursor = std::distance(m_frames.begin(), std::ranges::lower_bound(m_frames, time, {}, &Frame::time));
+}
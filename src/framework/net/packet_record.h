@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "declarations.h"
+#include <framework/global.h>
+
+// Binary packet record, all values are little endian:
+//   header:  signature, version, flags
+//   blocks:  first time, last time, frame count, raw size, stored size, data
+//            data is a list of frames: direction, time, length, payload
+//   index:   block count, then first time, last time and offset of each block,
+//            followed by the index offset and the index signature
+// Blocks can be decoded on their own, so the index is enough to start reading at any time.
+// The index is written when the recording is closed, files without it are indexed by walking the block headers.
+constexpr uint32_t PACKET_RECORD_SIGNATURE = 0x5250544F; // OTPR
+constexpr uint32_t PACKET_RECORD_INDEX_SIGNATURE = 0x4950544F; // OTPI
+constexpr uint16_t PACKET_RECORD_VERSION = 1;
+
+constexpr uint32_t PACKET_RECORD_HEADER_SIZE = 4 + 2 + 2;
+constexpr uint32_t PACKET_RECORD_BLOCK_HEADER_SIZE = 4 + 4 + 4 + 4 + 4;
+constexpr uint32_t PACKET_RECORD_FRAME_HEADER_SIZE = 1 + 4 + 4;
+constexpr uint32_t PACKET_RECORD_INDEX_ENTRY_SIZE = 4 + 4 + 8;
+constexpr uint32_t PACKET_RECORD_TRAILER_SIZE = 8 + 4;
+
+enum PacketRecordFlags : uint16_t
+{
+    PacketRecordCompressed = 1 << 0
+};
+
+enum PacketRecordDirection : uint8_t
+{
+    PacketRecordInput = 0,
+    PacketRecordOutput = 1
+};
+
+// Reads binary records and the old text ones, where every packet is a line with its direction, time and hex payload.
+class PacketRecordReader
+{
+public:
+    struct Frame
+    {
+        ticks_t time;
+        PacketRecordDirection direction;
+        std::shared_ptr<std::vector<uint8_t>> data;
+    };
+
+    bool open(const std::filesystem::path& path);
+
+    bool isBinary() const { return m_binary; }
+    // time of the last frame
+    ticks_t getDuration() const { return m_duration; }
+
+    // false once every frame was read
+    bool next(Frame& frame);
+    // the next frame will be the first one recorded at or after time
+    void seek(ticks_t time);
+
+private:
+    struct BlockInfo
+    {
+        uint32_t firstTime;
+        uint32_t lastTime;
+        uint64_t offset;
+    };
+
+    bool loadTextRecord();
+    bool loadIndex(uint64_t fileSize);
+    void scanBlocks(uint64_t fileSize);
+    bool loadBlock(size_t index);
+
+    std::ifstream m_file;
+    std::vector<BlockInfo> m_blocks;
+    std::vector<Frame> m_frames;
+
+    size_t m_cursor{ 0 };
+    size_t m_nextBlock{ 0 };
+    ticks_t m_duration{ 0 };
+
+    uint16_t m_flags{ 0 };
+    bool m_binary{ false };
+};
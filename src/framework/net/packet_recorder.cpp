@@ -25,30 +25,47 @@
 #include "inputmessage.h"
 #include "outputmessage.h"
 #include "framework/core/clock.h"
-PacketRecorder::PacketRecorder(const std::string_view& file)
+PacketRecorder::PacketRecorder(const std::string_view& file, const bool compress) : m_compress(compress)
 {
     m_start = g_clock.millis();
 #ifdef ANDROID
     g_resources.makeDir("records");
-    m_stream = std::ofstream(std::string("records/") + std::string(file));
+    m_stream = std::ofstream(std::string("records/") + std::string(file), std::ios::binary);
 #else
     std::error_code ec;
     std::filesystem::create_directory("records", ec);
-    m_stream = std::ofstream(std::filesystem::path("records") / file);
+    m_stream = std::ofstream(std::filesystem::path("records") / file, std::ios::binary);
 #endif
+
+    uint8_t header[PACKET_RECORD_HEADER_SIZE];
+    stdext::writeULE32(header, PACKET_RECORD_SIGNATURE);
+    stdext::writeULE16(header + 4, PACKET_RECORD_VERSION);
+    stdext::writeULE16(header + 6, m_compress ? PacketRecordCompressed : 0);
+    m_stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_offset = sizeof(header);
+
+    m_writer = std::thread([this] { processBlocks(); });
 }
 
 PacketRecorder::~PacketRecorder()
 {
+    flushBlock();
+
+    {
+        std::scoped_lock l(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+
+    if (m_writer.joinable())
+        m_writer.join();
+
+    writeIndex();
 }
 
 void PacketRecorder::addInputPacket(const InputMessagePtr& packet)
 {
-    m_stream << "< " << (g_clock.millis() - m_start) << " ";
-    for (auto& buffer : packet->getBodyBuffer()) {
-        m_stream << std::setfill('0') << std::setw(2) << std::hex << (uint16_t)(uint8_t)buffer;
-    }
-    m_stream << std::dec << "\n";
+    addFrame(PacketRecordInput, packet->getBodyBuffer());
 }
 
 void PacketRecorder::addOutputPacket(const OutputMessagePtr& packet)
@@ -59,9 +76,108 @@ void PacketRecorder::addOutputPacket(const OutputMessagePtr& packet)
         return;
     }
 
-    m_stream << "> " << (g_clock.millis() - m_start) << " ";
-    for (auto& buffer : packet->getBuffer()) {
-        m_stream << std::setfill('0') << std::setw(2) << std::hex << (uint16_t)(uint8_t)buffer;
+    addFrame(PacketRecordOutput, packet->getBuffer());
+}
+
+void PacketRecorder::addFrame(const PacketRecordDirection direction, const std::string_view packet)
+{
+    const auto time = static_cast<uint32_t>(g_clock.millis() - m_start);
+    if (m_block.frames == 0)
+        m_block.firstTime = time;
+    m_block.lastTime = time;
+    ++m_block.frames;
+
+    auto& data = m_block.data;
+    const size_t pos = data.size();
+    data.resize(pos + PACKET_RECORD_FRAME_HEADER_SIZE + packet.size());
+    data[pos] = direction;
+    stdext::writeULE32(&data[pos + 1], time);
+    stdext::writeULE32(&data[pos + 5], packet.size());
+    std::memcpy(&data[pos + PACKET_RECORD_FRAME_HEADER_SIZE], packet.data(), packet.size());
+
+    if (data.size() >= BLOCK_SIZE || time - m_block.firstTime >= BLOCK_DURATION)
+        flushBlock();
+}
+
+void PacketRecorder::flushBlock()
+{
+    if (m_block.frames == 0)
+        return;
+
+    {
+        std::scoped_lock l(m_mutex);
+        m_pendingBlocks.emplace_back(std::move(m_block));
     }
-    m_stream << std::dec << "\n";
-}
\ No newline at end of file
+    m_condition.notify_one();
+
+    m_block = {};
+    m_block.data.reserve(BLOCK_SIZE + BLOCK_SIZE / 4);
+}
+
+void PacketRecorder::processBlocks()
+{
+    std::unique_lock l(m_mutex);
+    while (true) {
+        m_condition.wait(l, [this] { return m_stopping || !m_pendingBlocks.empty(); });
+
+        // pending blocks are still written when stopping
+        if (m_pendingBlocks.empty())
+            return;
+
+        const Block block = std::move(m_pendingBlocks.front());
+        m_pendingBlocks.pop_front();
+
+        l.unlock();
+        writeBlock(block);
+        l.lock();
+    }
+}
+
+void PacketRecorder::writeBlock(const Block& block)
+{
+    const uint8_t* data = block.data.data();
+    unsigned long size = block.data.size();
+
+    if (m_compress) {
+        constexpr int COMPRESS_LEVEL = 3;
+        m_compressBuffer.resize(compressBound(block.data.size()));
+        size = m_compressBuffer.size();
+        compress2(m_compressBuffer.data(), &size, block.data.data(), block.data.size(), COMPRESS_LEVEL);
+        data = m_compressBuffer.data();
+    }
+
+    uint8_t header[PACKET_RECORD_BLOCK_HEADER_SIZE];
+    stdext::writeULE32(header, block.firstTime);
+    stdext::writeULE32(header + 4, block.lastTime);
+    stdext::writeULE32(header + 8, block.frames);
+    stdext::writeULE32(header + 12, block.data.size());
+    stdext::writeULE32(header + 16, size);
+
+    m_stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_stream.write(reinterpret_cast<const char*>(data), size);
+    // a recording cut by a crash keeps every written block
+    m_stream.flush();
+
+    m_index.emplace_back(block.firstTime, block.lastTime, m_offset);
+    m_offset += sizeof(header) + size;
+}
+
+void PacketRecorder::writeIndex()
+{
+    std::vector<uint8_t> index(4 + m_index.size() * PACKET_RECORD_INDEX_ENTRY_SIZE + PACKET_RECORD_TRAILER_SIZE);
+    stdext::writeULE32(index.data(), m_index.size());
+
+    uint8_t* entry = index.data() + 4;
+    for (const auto& [firstTime, lastTime, offset] : m_index) {
+        stdext::writeULE32(entry, firstTime);
+        stdext::writeULE32(entry + 4, lastTime);
+        stdext::writeULE64(entry + 8, offset);
+        entry += PACKET_RECORD_INDEX_ENTRY_SIZE;
+    }
+
+    stdext::writeULE64(entry, m_offset);
+    stdext::writeULE32(entry + 8, PACKET_RECORD_INDEX_SIGNATURE);
+
+    m_stream.write(reinterpret_cast<const char*>(index.data()), index.size());
+    m_stream.close();
+}
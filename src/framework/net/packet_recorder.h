@@ -22,19 +22,56 @@
 
 #pragma once
 #include "declarations.h"
+#include "packet_record.h"
 #include "framework/luaengine/luaobject.h"
 
+// Writes packets in the binary record format. Frames are grouped in blocks,
+// which are compressed and written by a background thread.
 class PacketRecorder : public LuaObject
 {
 public:
-    PacketRecorder(const std::string_view& file);
+    PacketRecorder(const std::string_view& file, bool compress = true);
     virtual ~PacketRecorder();
 
     void addInputPacket(const InputMessagePtr& packet);
     void addOutputPacket(const OutputMessagePtr& packet);
 
 private:
+    // a block is closed once it reaches this size or spans this many milliseconds
+    static constexpr uint32_t BLOCK_SIZE = 64 * 1024;
+    static constexpr uint32_t BLOCK_DURATION = 5000;
+
+    struct Block
+    {
+        uint32_t firstTime{ 0 };
+        uint32_t lastTime{ 0 };
+        uint32_t frames{ 0 };
+        std::vector<uint8_t> data;
+    };
+
+    void addFrame(PacketRecordDirection direction, std::string_view packet);
+    void flushBlock();
+
+    // writer thread
+    void processBlocks();
+    void writeBlock(const Block& block);
+    void writeIndex();
+
     ticks_t m_start;
     std::ofstream m_stream;
     bool m_firstOutput = true;
+    bool m_compress;
+
+    Block m_block;
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Block> m_pendingBlocks;
+    bool m_stopping{ false };
+
+    // only used by the writer thread while it runs
+    std::vector<std::tuple<uint32_t, uint32_t, uint64_t>> m_index;
+    std::vector<uint8_t> m_compressBuffer;
+    uint64_t m_offset{ 0 };
 };
@@ -436,16 +436,21 @@ void Protocol::onPlayerPacket(const std::shared_ptr<std::vector<uint8_t>>& packe
     post(g_ioService, [&, packet] {
         if (m_disconnected)
             return;
-        m_inputMessage->reset();
-
-        m_inputMessage->setHeaderSize(0);
-        m_inputMessage->fillBuffer(packet->data(), packet->size());
-        m_inputMessage->setMessageSize(packet->size());
-        onRecv(m_inputMessage);
+        receivePacket(packet->data(), packet->size());
     });
 #endif
 }
 
+void Protocol::receivePacket(const uint8_t* data, const uint16_t size)
+{
+    m_inputMessage->reset();
+
+    m_inputMessage->setHeaderSize(0);
+    m_inputMessage->fillBuffer(data, size);
+    m_inputMessage->setMessageSize(size);
+    onRecv(m_inputMessage);
+}
+
 void Protocol::playRecord(PacketPlayerPtr player)
 {
     m_disconnected = false;
@@ -41,6 +41,8 @@ public:
 
     void setRecorder(PacketRecorderPtr recorder);
     void playRecord(PacketPlayerPtr player);
+    // handles a recorded packet right away, as if it was just read from the connection
+    void receivePacket(const uint8_t* data, uint16_t size);
 
     bool isConnected();
     bool isConnecting();
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2010-2025 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "spinlock.h"
+
+// Bounded lock-free queue with many producers and a single consumer.
+// Producers claim a cell with a CAS on the tail, the consumer drains without
+// locking. When the ring is full, items go to a spinlocked overflow list
+// until the consumer catches up, so pushing never fails and each producer
+// keeps its order.
+template<typename T, size_t Capacity = 1024>
+class MpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    MpscQueue() : m_cells(std::make_unique<Cell[]>(Capacity))
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        m_pushes.fetch_add(1, std::memory_order_relaxed);
+
+        if (!m_overflowing.load(std::memory_order_acquire) && tryEmplace(std::forward<Args>(args)...))
+            return;
+
+        SpinLock::Guard guard(m_overflowLock);
+        m_overflowing.store(true, std::memory_order_relaxed);
+        m_overflow.emplace_back(std::forward<Args>(args)...);
+        m_overflowPushes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // consumer only, returns the amount of items passed to the callback
+    template<typename Callback>
+    size_t drain(Callback&& callback)
+    {
+        size_t count = drainRing(callback);
+
+        if (m_overflowing.load(std::memory_order_acquire)) {
+            SpinLock::Guard guard(m_overflowLock);
+            // every cell claimed before the overflow started goes first, a producer that
+            // claimed one may still be writing it and its next items are in the overflow
+            count += drainRing(callback, m_tail.load(std::memory_order_acquire));
+            for (auto& value : m_overflow)
+                callback(std::move(value));
+            count += m_overflow.size();
+            m_overflow.clear();
+            m_overflowing.store(false, std::memory_order_release);
+        }
+
+        if (count > m_maxDepth.load(std::memory_order_relaxed))
+            m_maxDepth.store(count, std::memory_order_relaxed);
+
+        return count;
+    }
+
+    uint64_t getPushes() const { return m_pushes.load(std::memory_order_relaxed); }
+    // pushes that lost the race for a cell to another producer at least once
+    uint64_t getContendedPushes() const { return m_contendedPushes.load(std::memory_order_relaxed); }
+    uint64_t getOverflowPushes() const { return m_overflowPushes.load(std::memory_order_relaxed); }
+    // most items drained by a single call
+    size_t getMaxDepth() const { return m_maxDepth.load(std::memory_order_relaxed); }
+
+    void resetStats()
+    {
+        m_pushes.store(0, std::memory_order_relaxed);
+        m_contendedPushes.store(0, std::memory_order_relaxed);
+        m_overflowPushes.store(0, std::memory_order_relaxed);
+        m_maxDepth.store(0, std::memory_order_relaxed);
+    }
+
+protected:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::optional<T> value;
+    };
+
+    // claims the cell at the tail, nullptr when the ring is full
+    Cell* claim(size_t& pos, bool& contended)
+    {
+        pos = m_tail.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Cell* cell = &m_cells[pos & MASK];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    return cell;
+                contended = true;
+            } else if (diff < 0) {
+                // full, the consumer didn't release this cell yet
+                return nullptr;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+                contended = true;
+            }
+        }
+    }
+
+    template<typename... Args>
+    static void publish(Cell* cell, const size_t pos, Args&&... args)
+    {
+        cell->value.emplace(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+private:
+    template<typename... Args>
+    bool tryEmplace(Args&&... args)
+    {
+        bool contended = false;
+        size_t pos;
+
+        Cell* cell = claim(pos, contended);
+        if (cell)
+            publish(cell, pos, std::forward<Args>(args)...);
+
+        if (contended)
+            m_contendedPushes.fetch_add(1, std::memory_order_relaxed);
+        return cell != nullptr;
+    }
+
+    template<typename Callback>
+    size_t drainRing(Callback& callback)
+    {
+        size_t count = 0;
+        for (;;) {
+            auto& cell = m_cells[m_head & MASK];
+            // stops at the first cell that is not published yet, even if later ones are
+            if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+                break;
+
+            consume(cell, callback);
+            ++count;
+        }
+        return count;
+    }
+
+    // drains up to the given tail, waiting for the producers still writing a claimed cell
+    template<typename Callback>
+    size_t drainRing(Callback& callback, const size_t tail)
+    {
+        size_t count = 0;
+        while (m_head != tail) {
+            auto& cell = m_cells[m_head & MASK];
+            while (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+                std::this_thread::yield();
+
+            consume(cell, callback);
+            ++count;
+        }
+        return count;
+    }
+
+    template<typename Callback>
+    void consume(Cell& cell, Callback& callback)
+    {
+        callback(std::move(*cell.value));
+        cell.value.reset();
+        cell.sequence.store(m_head + Capacity, std::memory_order_release);
+        ++m_head;
+    }
+
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+    alignas(64) size_t m_head{ 0 };
+
+    alignas(64) std::atomic_bool m_overflowing{ false };
+    SpinLock m_overflowLock;
+    std::vector<T> m_overflow;
+
+    std::atomic<uint64_t> m_pushes{ 0 };
+    std::atomic<uint64_t> m_contendedPushes{ 0 };
+    std::atomic<uint64_t> m_overflowPushes{ 0 };
+    std::atomic<size_t> m_maxDepth{ 0 };
+};
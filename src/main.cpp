@@ -27,9 +27,10 @@
 #include "framework/luaengine/luainterface.h"
 #include "framework/platform/platform.h"
 
+#include "client/game.h"
+
 #ifndef ANDROID
 #if ENABLE_DISCORD_RPC == 1
-#include "client/game.h"
 #include "client/localplayer.h"
 #include <framework/discord/discord.h>
 #endif
@@ -117,6 +118,29 @@ extern "C" {
         if (!g_lua.safeRunScript("init.lua"))
             g_logger.fatal("Unable to run script init.lua!");
 
+        // parser benchmark: --replay-benchmark <record> <client version>
+        // the record is replayed before the main loop starts, so nothing is ever drawn
+        if (const auto it = std::ranges::find(args, "--replay-benchmark"); std::distance(it, args.end()) >= 3) {
+            int exitCode = 0;
+            try {
+                const auto version = stdext::safe_cast<uint16_t>(*(it + 2));
+                g_game.setClientVersion(version);
+                g_game.setProtocolVersion(version);
+                std::cout << g_game.benchmarkRecord(*(it + 1)) << std::endl;
+            } catch (const std::exception& e) {
+                g_logger.error("Replay benchmark failed: {}", e.what());
+                exitCode = 1;
+            }
+
+            g_app.deinit();
+            g_client.terminate();
+            g_app.terminate();
+#ifdef FRAMEWORK_NET
+            g_http.terminate();
+#endif
+            return exitCode;
+        }
+
         g_logger.info("init.lua completed successfully, starting main render loop...");
 
         // the run application main loop
@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/gameconfig.h"
+#include "client/map.h"
+#include "client/spriteprefetcher.h"
+#include "client/thing.h"
+#include "client/thingtype.h"
+#include "client/tile.h"
+#include <framework/core/graphicalapplication.h>
+#undef protected
+#undef private
+
+#include <framework/core/asyncdispatcher.h>
+
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// without animation phases the loads have no texture to read
+ThingTypePtr makeType()
+{
+    const auto& type = std::make_shared<ThingType>();
+    type->m_null = false;
+    type->m_category = ThingCategoryItem;
+    type->m_size = Size(1, 1);
+    type->m_realSize = 32;
+    type->m_layers = 1;
+    type->m_opacity = 1.f;
+    return type;
+}
+
+class PrefetchItem final : public Thing
+{
+public:
+    PrefetchItem(ThingTypePtr type) : m_type(std::move(type)) { m_clientId = 1; }
+
+    bool isItem() const override { return true; }
+    ThingType* getThingType() const override { return m_type.get(); }
+
+private:
+    ThingTypePtr m_type;
+};
+
+// keeps every g_asyncDispatcher worker busy, so the loads scheduled meanwhile stay in its queue
+class PoolBlocker
+{
+public:
+    PoolBlocker()
+    {
+        const std::shared_future<void> released = m_release.get_future().share();
+        for (size_t i = 0; i < g_asyncDispatcher.get_thread_count(); ++i)
+            g_asyncDispatcher.detach_task([released] { released.wait(); });
+
+        while (g_asyncDispatcher.get_tasks_running() < g_asyncDispatcher.get_thread_count())
+            std::this_thread::yield();
+    }
+
+    ~PoolBlocker() { release(); }
+
+    void release()
+    {
+        if (m_released)
+            return;
+        m_released = true;
+        m_release.set_value();
+    }
+
+private:
+    std::promise<void> m_release;
+    bool m_released{ false };
+};
+
+size_t runningLoads()
+{
+    std::scoped_lock l(g_spritePrefetcher.m_mutex);
+    return g_spritePrefetcher.m_running;
+}
+
+class SpritePrefetcherTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_spritePrefetcher.init();
+        g_spritePrefetcher.resetStats();
+        g_spritePrefetcher.setEnabled(true);
+    }
+
+    void TearDown() override
+    {
+        g_asyncDispatcher.wait();
+        g_spritePrefetcher.terminate();
+        g_spritePrefetcher.init();
+        g_spritePrefetcher.resetStats();
+    }
+};
+
+TEST_F(SpritePrefetcherTest, QueuesThingsOnce)
+{
+    g_spritePrefetcher.setMaxConcurrency(64);
+
+    const auto& first = makeType();
+    const auto& second = makeType();
+    {
+        PoolBlocker blocker;
+        g_spritePrefetcher.request(first.get(), SpritePrefetcher::PriorityVisible);
+        g_spritePrefetcher.request(first.get(), SpritePrefetcher::PriorityVisible);
+        g_spritePrefetcher.request(first.get(), SpritePrefetcher::PriorityPrefetch);
+        g_spritePrefetcher.request(second.get(), SpritePrefetcher::PriorityPrefetch);
+        g_spritePrefetcher.request(second.get(), SpritePrefetcher::PriorityVisible);
+        g_spritePrefetcher.request(second.get(), SpritePrefetcher::PriorityVisible);
+
+        // one load each, scheduled on the first request
+        EXPECT_EQ(2u, g_asyncDispatcher.get_tasks_queued());
+        EXPECT_EQ(2u, runningLoads());
+        EXPECT_EQ(1u, g_spritePrefetcher.getVisibleWaits());
+        EXPECT_TRUE(first->m_loadingVisible);
+        EXPECT_TRUE(second->m_loadingVisible);
+
+        // once marked visible the request doesn't take the lock
+        {
+            std::unique_lock l(g_spritePrefetcher.m_mutex);
+            auto request = std::async(std::launch::async, [&] { g_spritePrefetcher.request(first.get(), SpritePrefetcher::PriorityVisible); });
+            const bool returned = request.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+            l.unlock();
+            request.wait();
+            EXPECT_TRUE(returned);
+        }
+        EXPECT_EQ(2u, g_asyncDispatcher.get_tasks_queued());
+    }
+
+    g_asyncDispatcher.wait();
+    EXPECT_EQ(0u, runningLoads());
+    EXPECT_EQ(0u, g_spritePrefetcher.getPending());
+    EXPECT_FALSE(first->isLoading());
+    EXPECT_FALSE(second->m_loadingVisible);
+}
+
+TEST_F(SpritePrefetcherTest, PromotedThingsAreLoadedOnce)
+{
+    g_spritePrefetcher.setMaxConcurrency(1);
+
+    const auto& running = makeType();
+    const auto& promoted = makeType();
+    {
+        PoolBlocker blocker;
+        g_spritePrefetcher.request(running.get(), SpritePrefetcher::PriorityVisible);
+        g_spritePrefetcher.request(promoted.get(), SpritePrefetcher::PriorityPrefetch);
+        g_spritePrefetcher.request(promoted.get(), SpritePrefetcher::PriorityVisible);
+        g_spritePrefetcher.request(promoted.get(), SpritePrefetcher::PriorityVisible);
+
+        EXPECT_EQ(1u, g_asyncDispatcher.get_tasks_queued());
+        EXPECT_EQ(1u, g_spritePrefetcher.getPending());
+        EXPECT_EQ(1u, g_spritePrefetcher.getPrefetchPromotions());
+        EXPECT_EQ(2u, g_spritePrefetcher.getVisibleWaits());
+
+        // the entry left in the prefetch queue is skipped
+        g_spritePrefetcher.setMaxConcurrency(4);
+        EXPECT_EQ(2u, g_asyncDispatcher.get_tasks_queued());
+        EXPECT_EQ(0u, g_spritePrefetcher.getPending());
+        EXPECT_TRUE(g_spritePrefetcher.m_queues[SpritePrefetcher::PriorityPrefetch].empty());
+    }
+
+    g_asyncDispatcher.wait();
+    EXPECT_FALSE(promoted->isLoading());
+}
+
+TEST_F(SpritePrefetcherTest, BoundsTheRunningLoads)
+{
+    const uint32_t bound = std::max<uint32_t>(1, g_asyncDispatcher.get_thread_count() / 2);
+    EXPECT_EQ(bound, g_spritePrefetcher.getMaxConcurrency());
+
+    std::vector<ThingTypePtr> types;
+    for (int i = 0; i < 40; ++i)
+        types.emplace_back(makeType());
+
+    {
+        PoolBlocker blocker;
+        for (size_t i = 0; i < types.size(); ++i)
+            g_spritePrefetcher.request(types[i].get(), i % 2 ? SpritePrefetcher::PriorityVisible : SpritePrefetcher::PriorityPrefetch);
+
+        EXPECT_EQ(bound, g_asyncDispatcher.get_tasks_queued());
+        EXPECT_EQ(bound, runningLoads());
+        EXPECT_EQ(types.size() - bound, g_spritePrefetcher.getPending());
+
+        blocker.release();
+        while (g_spritePrefetcher.getPending() > 0 || runningLoads() > 0)
+            ASSERT_LE(runningLoads(), bound);
+    }
+
+    g_asyncDispatcher.wait();
+    for (const auto& type : types)
+        EXPECT_FALSE(type->isLoading());
+}
+
+class SpritePrefetcherMapTest : public SpritePrefetcherTest
+{
+protected:
+    inline static const Position CENTER{ 100, 100, 7 };
+
+    void SetUp() override
+    {
+        SpritePrefetcherTest::SetUp();
+        m_loadingAsyncTexture = g_app.m_loadingAsyncTexture;
+        g_app.m_loadingAsyncTexture = true;
+
+        g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+        g_map.m_centralPosition = CENTER;
+        g_map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+        // the floor above is drawn shifted by one tile
+        for (const int z : { 6, 7 }) {
+            const int offset = CENTER.z - z;
+            for (int y = CENTER.y + offset - 6; y <= CENTER.y + offset + 7; ++y) {
+                for (int x = CENTER.x + offset - 8; x <= CENTER.x + offset + 9; ++x) {
+                    const Position pos(x, y, z);
+                    const auto& type = makeType();
+                    g_map.createTile(pos)->addThing(std::make_shared<PrefetchItem>(type), -1);
+                    m_types.emplace_back(pos, type);
+                }
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        SpritePrefetcherTest::TearDown();
+        g_map.m_floors.clear();
+        g_app.m_loadingAsyncTexture = m_loadingAsyncTexture;
+    }
+
+    // tiles of the two rows or columns of the aware area at its border in the direction
+    static bool isAhead(const Position& pos, const Otc::Direction direction)
+    {
+        const int x = pos.x - (CENTER.z - pos.z);
+        const int y = pos.y - (CENTER.z - pos.z);
+        const auto& step = CENTER.translatedToDirection(direction);
+        return (step.x > CENTER.x && x >= CENTER.x + 9 - 1)
+            || (step.x < CENTER.x && x <= CENTER.x - 8 + 1)
+            || (step.y > CENTER.y && y >= CENTER.y + 7 - 1)
+            || (step.y < CENTER.y && y <= CENTER.y - 6 + 1);
+    }
+
+    std::vector<std::pair<Position, ThingTypePtr>> m_types;
+    bool m_loadingAsyncTexture{ false };
+};
+
+TEST_F(SpritePrefetcherMapTest, QueuesTheTilesAheadOfTheWalk)
+{
+    for (const auto direction : { Otc::East, Otc::West, Otc::South, Otc::North, Otc::NorthEast, Otc::SouthWest }) {
+        {
+            PoolBlocker blocker;
+            g_spritePrefetcher.prefetch(CENTER, direction);
+
+            size_t ahead = 0;
+            for (const auto& [pos, type] : m_types) {
+                EXPECT_EQ(isAhead(pos, direction), type->isLoading()) << pos << " direction " << static_cast<int>(direction);
+                ahead += isAhead(pos, direction);
+            }
+            EXPECT_EQ(ahead, g_spritePrefetcher.getPending() + runningLoads());
+        }
+        g_asyncDispatcher.wait();
+    }
+}
+
+TEST_F(SpritePrefetcherMapTest, DropsTheRingLeftBehind)
+{
+    g_spritePrefetcher.setMaxConcurrency(1);
+
+    PoolBlocker blocker;
+    g_spritePrefetcher.prefetch(CENTER, Otc::East);
+    g_spritePrefetcher.prefetch(CENTER, Otc::West);
+
+    // only the load already running is kept from the east ring
+    size_t running = 0;
+    for (const auto& [pos, type] : m_types) {
+        if (isAhead(pos, Otc::West))
+            EXPECT_TRUE(type->isLoading()) << pos;
+        else
+            running += type->isLoading();
+    }
+    EXPECT_EQ(1u, running);
+
+    for (const auto& type : g_spritePrefetcher.m_queues[SpritePrefetcher::PriorityPrefetch]) {
+        const auto it = std::ranges::find(m_types, type, &std::pair<Position, ThingTypePtr>::second);
+        ASSERT_NE(m_types.end(), it);
+        EXPECT_TRUE(isAhead(it->first, Otc::West)) << it->first;
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "client/spritesheetcache.h"
+
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+
+#include <vector>
+
+namespace {
+
+class SpriteSheetCacheTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_previousLogLevel = g_logger.getLevel();
+        g_logger.setLevel(Fw::LogFatal);
+
+        m_writeDir = std::filesystem::temp_directory_path() / fmt::format("otclient-sheet-cache-{}", stdext::getThreadId());
+        std::filesystem::create_directories(m_writeDir);
+
+        g_resources.init(".");
+        g_resources.setWriteDir(m_writeDir.string());
+    }
+
+    void TearDown() override
+    {
+        g_resources.terminate();
+        std::error_code ec;
+        std::filesystem::remove_all(m_writeDir, ec);
+        g_logger.setLevel(m_previousLogLevel);
+    }
+
+    bool hasCacheFiles() const { return std::filesystem::exists(m_writeDir / "sprite-cache"); }
+
+    std::filesystem::path m_writeDir;
+    Fw::LogLevel m_previousLogLevel{ Fw::LogFatal };
+};
+
+std::vector<uint8_t> makeSheet()
+{
+    std::vector<uint8_t> pixels(BYTES_IN_SPRITE_SHEET);
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = static_cast<uint8_t>(i * 7);
+    return pixels;
+}
+
+TEST_F(SpriteSheetCacheTest, StoresAndLoadsSheets)
+{
+    SpriteSheetDiskCache cache;
+    cache.setEncrypted(false);
+    cache.open("{}");
+    ASSERT_TRUE(cache.isOpen());
+
+    const auto& sheet = makeSheet();
+    cache.store("sprites-1.bmp.lzma", 42, sheet.data());
+
+    std::vector<uint8_t> pixels(BYTES_IN_SPRITE_SHEET);
+    EXPECT_TRUE(cache.load("sprites-1.bmp.lzma", 42, pixels.data()));
+    EXPECT_EQ(pixels, sheet);
+
+    // the source sheet changed
+    EXPECT_FALSE(cache.load("sprites-1.bmp.lzma", 43, pixels.data()));
+}
+
+TEST_F(SpriteSheetCacheTest, StaysClosedWhenEncrypted)
+{
+    SpriteSheetDiskCache cache;
+    cache.setEncrypted(true);
+    cache.open("{}");
+    EXPECT_FALSE(cache.isOpen());
+
+    const auto& sheet = makeSheet();
+    cache.store("sprites-1.bmp.lzma", 42, sheet.data());
+
+    std::vector<uint8_t> pixels(BYTES_IN_SPRITE_SHEET);
+    EXPECT_FALSE(cache.load("sprites-1.bmp.lzma", 42, pixels.data()));
+    EXPECT_FALSE(hasCacheFiles());
+}
+
+TEST_F(SpriteSheetCacheTest, EncryptingClosesAndDropsTheCache)
+{
+    {
+        SpriteSheetDiskCache cache;
+        cache.setEncrypted(false);
+        cache.open("{}");
+        const auto& sheet = makeSheet();
+        cache.store("sprites-1.bmp.lzma", 42, sheet.data());
+        ASSERT_TRUE(hasCacheFiles());
+
+        cache.setEncrypted(true);
+        EXPECT_FALSE(cache.isOpen());
+    }
+
+    // sheets left by an unencrypted build are removed when an encrypted one opens the cache
+    SpriteSheetDiskCache cache;
+    cache.setEncrypted(true);
+    cache.open("{}");
+    EXPECT_FALSE(hasCacheFiles());
+}
+
+}
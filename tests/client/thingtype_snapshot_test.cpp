@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/animator.h"
+#include "client/spriteappearances.h"
+#include "client/thingtype.h"
+#undef protected
+#undef private
+
+#include <framework/core/filestream.h>
+
+namespace {
+
+appearances::SpriteAnimation* addFrameGroup(appearances::Appearance& appearance, const appearances::FIXED_FRAME_GROUP group, const uint32_t firstSprite, const int phases)
+{
+    auto* frameGroup = appearance.add_frame_group();
+    frameGroup->set_fixed_frame_group(group);
+
+    auto* spriteInfo = frameGroup->mutable_sprite_info();
+    spriteInfo->set_pattern_width(2);
+    spriteInfo->set_pattern_height(1);
+    spriteInfo->set_pattern_depth(1);
+    spriteInfo->set_layers(1);
+    spriteInfo->set_is_opaque(true);
+    for (int i = 0; i < 2 * phases; ++i)
+        spriteInfo->add_sprite_id(firstSprite + i);
+
+    auto* animation = spriteInfo->mutable_animation();
+    for (int i = 0; i < phases; ++i) {
+        auto* phase = animation->add_sprite_phase();
+        phase->set_duration_min(100 + i * 50);
+        phase->set_duration_max(200 + i * 5000);
+    }
+    return animation;
+}
+
+// sets everything unserializeAppearance reads
+appearances::Appearance makeFullAppearance()
+{
+    appearances::Appearance appearance;
+    appearance.set_name("crystal lamp");
+    appearance.set_description("it glows");
+
+    auto* flags = appearance.mutable_flags();
+    flags->mutable_bank()->set_waypoints(150);
+    flags->set_unpass(true);
+    flags->set_avoid(true);
+    flags->set_take(true);
+    flags->mutable_write()->set_max_text_length(250);
+    flags->mutable_light()->set_brightness(5);
+    flags->mutable_light()->set_color(180);
+    flags->mutable_shift()->set_x(8);
+    flags->mutable_shift()->set_y(4);
+    flags->mutable_height()->set_elevation(16);
+    flags->mutable_automap()->set_color(121);
+    flags->mutable_lenshelp()->set_id(1101);
+    flags->mutable_clothes()->set_slot(3);
+    flags->mutable_default_action()->set_action(appearances::PLAYER_ACTION_USE);
+    flags->mutable_upgradeclassification()->set_upgrade_classification(4);
+
+    auto* market = flags->mutable_market();
+    market->set_category(appearances::ITEM_CATEGORY_DECORATION);
+    market->set_trade_as_object_id(3001);
+    market->set_show_as_object_id(3002);
+    market->add_restrict_to_profession(appearances::PLAYER_PROFESSION_KNIGHT);
+    market->add_restrict_to_profession(appearances::PLAYER_PROFESSION_DRUID);
+    market->set_minimum_level(80);
+
+    for (int i = 0; i < 2; ++i) {
+        auto* npc = flags->add_npcsaledata();
+        npc->set_name(fmt::format("trader {}", i));
+        npc->set_location("Thais");
+        npc->set_sale_price(1000 + i);
+        npc->set_buy_price(500 + i);
+        npc->set_currency_object_type_id(3031);
+        npc->set_currency_quest_flag_display_name("gold");
+    }
+
+    auto* idle = addFrameGroup(appearance, appearances::FIXED_FRAME_GROUP_OUTFIT_IDLE, 1, 2);
+    idle->set_synchronized(false);
+    idle->set_loop_count(3);
+    idle->set_default_start_phase(1);
+
+    auto* moving = addFrameGroup(appearance, appearances::FIXED_FRAME_GROUP_OUTFIT_MOVING, 5, 3);
+    moving->set_synchronized(true);
+
+    return appearance;
+}
+
+void expectSameAnimator(const Animator* expected, const Animator* animator)
+{
+    ASSERT_EQ(expected == nullptr, animator == nullptr);
+    if (!expected)
+        return;
+
+    EXPECT_EQ(expected->m_animationPhases, animator->m_animationPhases);
+    EXPECT_EQ(expected->m_async, animator->m_async);
+    EXPECT_EQ(expected->m_loopCount, animator->m_loopCount);
+    EXPECT_EQ(expected->m_startPhase, animator->m_startPhase);
+    EXPECT_EQ(expected->m_minDuration, animator->m_minDuration);
+    EXPECT_EQ(expected->m_phaseDurations, animator->m_phaseDurations);
+    EXPECT_EQ(expected->m_phase, animator->m_phase);
+}
+
+void expectSameType(const ThingType& expected, const ThingType& type)
+{
+    EXPECT_EQ(expected.m_null, type.m_null);
+    EXPECT_EQ(expected.m_id, type.m_id);
+    EXPECT_EQ(expected.m_category, type.m_category);
+    EXPECT_EQ(expected.m_name, type.m_name);
+    EXPECT_EQ(expected.m_description, type.m_description);
+
+    EXPECT_EQ(expected.m_flags, type.m_flags);
+    EXPECT_EQ(expected.m_size, type.m_size);
+    EXPECT_EQ(expected.m_displacement, type.m_displacement);
+    EXPECT_EQ(expected.m_opaque, type.m_opaque);
+    EXPECT_EQ(expected.m_animationPhases, type.m_animationPhases);
+    EXPECT_EQ(expected.m_realSize, type.m_realSize);
+    EXPECT_EQ(expected.m_numPatternX, type.m_numPatternX);
+    EXPECT_EQ(expected.m_numPatternY, type.m_numPatternY);
+    EXPECT_EQ(expected.m_numPatternZ, type.m_numPatternZ);
+    EXPECT_EQ(expected.m_layers, type.m_layers);
+    EXPECT_EQ(expected.m_exactHeight, type.m_exactHeight);
+    EXPECT_EQ(expected.m_minimapColor, type.m_minimapColor);
+    EXPECT_EQ(expected.m_clothSlot, type.m_clothSlot);
+    EXPECT_EQ(expected.m_lensHelp, type.m_lensHelp);
+    EXPECT_EQ(expected.m_elevation, type.m_elevation);
+    EXPECT_EQ(expected.m_defaultAction, type.m_defaultAction);
+    EXPECT_EQ(expected.m_groundSpeed, type.m_groundSpeed);
+    EXPECT_EQ(expected.m_maxTextLength, type.m_maxTextLength);
+    EXPECT_EQ(expected.m_upgradeClassification, type.m_upgradeClassification);
+    EXPECT_EQ(expected.m_light.intensity, type.m_light.intensity);
+    EXPECT_EQ(expected.m_light.color, type.m_light.color);
+    EXPECT_EQ(expected.m_opacity, type.m_opacity);
+
+    EXPECT_EQ(expected.m_market.name, type.m_market.name);
+    EXPECT_EQ(expected.m_market.category, type.m_market.category);
+    EXPECT_EQ(expected.m_market.requiredLevel, type.m_market.requiredLevel);
+    EXPECT_EQ(expected.m_market.restrictVocation, type.m_market.restrictVocation);
+    EXPECT_EQ(expected.m_market.showAs, type.m_market.showAs);
+    EXPECT_EQ(expected.m_market.tradeAs, type.m_market.tradeAs);
+
+    ASSERT_EQ(expected.m_npcData.size(), type.m_npcData.size());
+    for (size_t i = 0; i < expected.m_npcData.size(); ++i) {
+        const auto& expectedData = expected.m_npcData[i];
+        const auto& data = type.m_npcData[i];
+        EXPECT_EQ(expectedData.name, data.name);
+        EXPECT_EQ(expectedData.location, data.location);
+        EXPECT_EQ(expectedData.salePrice, data.salePrice);
+        EXPECT_EQ(expectedData.buyPrice, data.buyPrice);
+        EXPECT_EQ(expectedData.currencyObjectTypeId, data.currencyObjectTypeId);
+        EXPECT_EQ(expectedData.currencyQuestFlagDisplayName, data.currencyQuestFlagDisplayName);
+    }
+
+    EXPECT_EQ(expected.m_spritesIndex, type.m_spritesIndex);
+    EXPECT_EQ(expected.m_textureData.size(), type.m_textureData.size());
+
+    expectSameAnimator(expected.m_animator, type.m_animator);
+    expectSameAnimator(expected.m_idleAnimator, type.m_idleAnimator);
+}
+
+void expectRoundTrip(const appearances::Appearance& appearance)
+{
+    ThingType expected;
+    expected.unserializeAppearance(7, ThingCategoryItem, appearance);
+
+    // in memory stream, written from its start
+    const auto& stream = std::make_shared<FileStream>("snapshot", std::string_view(" "));
+    expected.serializeSnapshot(stream);
+    const uint32_t size = stream->tell();
+    stream->seek(0);
+
+    ThingType type;
+    type.unserializeSnapshot(7, ThingCategoryItem, stream);
+    EXPECT_EQ(size, stream->tell());
+
+    expectSameType(expected, type);
+}
+
+class ThingTypeSnapshot : public testing::Test
+{
+protected:
+    // sprites of the appearances are 64x64, in a sheet that is never read
+    void SetUp() override { g_spriteAppearances.m_sheets.emplace_back(std::make_shared<SpriteSheet>(1, 100, SpriteLayout::SIZE_64_64, "sprites-1.bmp.lzma")); }
+    void TearDown() override { g_spriteAppearances.m_sheets.clear(); }
+};
+
+TEST_F(ThingTypeSnapshot, KeepsEveryField)
+{
+    expectRoundTrip(makeFullAppearance());
+}
+
+TEST_F(ThingTypeSnapshot, KeepsTypesWithoutSpriteSheet)
+{
+    appearances::Appearance appearance;
+    appearance.set_name("unknown");
+    addFrameGroup(appearance, appearances::FIXED_FRAME_GROUP_OUTFIT_IDLE, 500, 1);
+
+    expectRoundTrip(appearance);
+}
+
+TEST_F(ThingTypeSnapshot, KeepsTypesWithoutFrames)
+{
+    expectRoundTrip(appearances::Appearance());
+}
+
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/spriteappearances.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+#undef protected
+#undef private
+
+#include <framework/core/filestream.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+void fillAppearance(appearances::Appearance& appearance, const uint32_t id, const uint32_t seed)
+{
+    appearance.set_id(id);
+    appearance.set_name(fmt::format("thing {} {}", id, seed));
+
+    auto* flags = appearance.mutable_flags();
+    if (seed % 2)
+        flags->set_unpass(true);
+    if (seed % 3 == 0)
+        flags->mutable_light()->set_brightness(seed % 7);
+    if (seed % 5 == 0)
+        flags->mutable_height()->set_elevation(8);
+    flags->mutable_automap()->set_color(seed % 215);
+
+    auto* frameGroup = appearance.add_frame_group();
+    auto* spriteInfo = frameGroup->mutable_sprite_info();
+    spriteInfo->set_pattern_width(1 + seed % 2);
+    spriteInfo->set_pattern_height(1);
+    spriteInfo->set_pattern_depth(1);
+    spriteInfo->set_layers(1);
+    const int phases = 1 + seed % 3;
+    for (uint32_t i = 0; i < spriteInfo->pattern_width() * phases; ++i)
+        spriteInfo->add_sprite_id(1 + (seed + i) % 100);
+    if (phases > 1) {
+        auto* animation = spriteInfo->mutable_animation();
+        for (int i = 0; i < phases; ++i) {
+            auto* phase = animation->add_sprite_phase();
+            phase->set_duration_min(100 + seed % 50);
+            phase->set_duration_max(200 + seed % 500);
+        }
+    }
+}
+
+// ids are shuffled, with gaps, and some repeat later in the list with other data,
+// enough items for forEachChunk to split them among the async dispatcher workers
+appearances::Appearances makeAppearances()
+{
+    std::mt19937 random(1234);
+    appearances::Appearances lib;
+
+    std::vector<uint32_t> itemIds(3000);
+    std::iota(itemIds.begin(), itemIds.end(), 0);
+    std::ranges::shuffle(itemIds, random);
+    for (size_t i = 0; i < itemIds.size(); ++i) {
+        fillAppearance(*lib.add_object(), 100 + itemIds[i] * 2, i);
+        if (i % 97 == 0)
+            fillAppearance(*lib.add_object(), 100 + itemIds[i / 3] * 2, i + 1);
+    }
+
+    for (uint32_t id = 400; id >= 1; --id)
+        fillAppearance(*lib.add_outfit(), id, id * 11);
+
+    for (uint32_t id : { 7, 3, 30, 3, 12 })
+        fillAppearance(*lib.add_effect(), id, id * 5 + lib.effect_size());
+
+    return lib;
+}
+
+// the tables as they were filled before the unserialization ran in parallel
+void sequentialLoad(const appearances::Appearances& appearancesLib, ThingTypeList (&thingTypes)[ThingLastCategory], const ThingTypePtr& nullThingType)
+{
+    for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+        const google::protobuf::RepeatedPtrField<appearances::Appearance>* appearances = nullptr;
+        switch (category) {
+            case ThingCategoryItem: appearances = &appearancesLib.object(); break;
+            case ThingCategoryCreature: appearances = &appearancesLib.outfit(); break;
+            case ThingCategoryEffect: appearances = &appearancesLib.effect(); break;
+            case ThingCategoryMissile: appearances = &appearancesLib.missile(); break;
+        }
+        uint32_t lastAppearanceId = 0;
+        for (const auto& appearance : *appearances) {
+            if (appearance.id() > lastAppearanceId)
+                lastAppearanceId = appearance.id();
+        }
+        auto& things = thingTypes[category];
+        things.clear();
+        things.resize(lastAppearanceId + 1, nullThingType);
+        for (const auto& appearance : *appearances) {
+            const auto& type = std::make_shared<ThingType>();
+            const uint16_t id = appearance.id();
+            type->unserializeAppearance(id, static_cast<ThingCategory>(category), appearance);
+            things[id] = type;
+        }
+    }
+}
+
+// every field the snapshot keeps, which is every field an appearance sets
+std::vector<uint8_t> snapshotOf(const ThingType& type)
+{
+    const auto& stream = std::make_shared<FileStream>("snapshot", std::string_view(" "));
+    type.serializeSnapshot(stream);
+    return { stream->m_data.begin(), stream->m_data.begin() + stream->tell() };
+}
+
+class ThingTypeManagerLoad : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_spriteAppearances.m_sheets.emplace_back(std::make_shared<SpriteSheet>(1, 100, SpriteLayout::SIZE_64_64, "sprites-1.bmp.lzma"));
+        g_things.init();
+    }
+
+    void TearDown() override
+    {
+        g_things.terminate();
+        g_spriteAppearances.m_sheets.clear();
+    }
+};
+
+TEST_F(ThingTypeManagerLoad, ParallelLoadMatchesSequentialLoad)
+{
+    const auto& lib = makeAppearances();
+    ASSERT_TRUE(g_things.unserializeAppearances(lib));
+
+    ThingTypeList expected[ThingLastCategory];
+    sequentialLoad(lib, expected, g_things.m_nullThingType);
+
+    for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+        const auto& types = g_things.m_thingTypes[category];
+        ASSERT_EQ(expected[category].size(), types.size()) << "category " << category;
+
+        for (size_t id = 0; id < types.size(); ++id) {
+            const auto& expectedType = expected[category][id];
+            const auto& type = types[id];
+            ASSERT_TRUE(type) << "category " << category << " id " << id;
+            ASSERT_EQ(expectedType == g_things.m_nullThingType, type == g_things.m_nullThingType) << "category " << category << " id " << id;
+            if (type == g_things.m_nullThingType)
+                continue;
+
+            EXPECT_EQ(id, type->getId());
+            EXPECT_EQ(category, type->getCategory());
+            EXPECT_EQ(expectedType->getName(), type->getName()) << "category " << category << " id " << id;
+            EXPECT_EQ(snapshotOf(*expectedType), snapshotOf(*type)) << "category " << category << " id " << id;
+        }
+    }
+
+    // the missile table is left with only the null type
+    EXPECT_EQ(1u, g_things.m_thingTypes[ThingCategoryMissile].size());
+}
+
+TEST_F(ThingTypeManagerLoad, RepeatedIdsKeepTheLastAppearance)
+{
+    appearances::Appearances lib;
+    fillAppearance(*lib.add_effect(), 5, 1);
+    fillAppearance(*lib.add_effect(), 2, 2);
+    fillAppearance(*lib.add_effect(), 5, 3);
+
+    ASSERT_TRUE(g_things.unserializeAppearances(lib));
+
+    const auto& effects = g_things.m_thingTypes[ThingCategoryEffect];
+    ASSERT_EQ(6u, effects.size());
+    EXPECT_EQ("thing 5 3", effects[5]->getName());
+    EXPECT_EQ("thing 2 2", effects[2]->getName());
+    EXPECT_EQ(g_things.m_nullThingType, effects[4]);
+}
+
+}
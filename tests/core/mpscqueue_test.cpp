@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <framework/util/mpscqueue.h>
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST(MpscQueue, KeepsOrderThroughOverflow)
+{
+    MpscQueue<int, 8> queue;
+    for (int i = 0; i < 20; ++i)
+        queue.emplace(i);
+
+    EXPECT_EQ(20u, queue.getPushes());
+    EXPECT_EQ(12u, queue.getOverflowPushes());
+
+    std::vector<int> drained;
+    EXPECT_EQ(20u, queue.drain([&](int&& value) { drained.emplace_back(value); }));
+
+    std::vector<int> expected(20);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(expected, drained);
+    EXPECT_EQ(20u, queue.getMaxDepth());
+
+    // the ring is used again once the overflow was drained
+    queue.emplace(20);
+    EXPECT_EQ(12u, queue.getOverflowPushes());
+    drained.clear();
+    EXPECT_EQ(1u, queue.drain([&](int&& value) { drained.emplace_back(value); }));
+    EXPECT_EQ(std::vector<int>({ 20 }), drained);
+    EXPECT_EQ(0u, queue.drain([](int&&) {}));
+}
+
+TEST(MpscQueue, ReleasesDrainedValues)
+{
+    const auto value = std::make_shared<int>(0);
+
+    MpscQueue<std::shared_ptr<int>, 4> queue;
+    for (int i = 0; i < 6; ++i)
+        queue.emplace(value);
+    EXPECT_EQ(7, value.use_count());
+
+    queue.drain([](std::shared_ptr<int>&&) {});
+    EXPECT_EQ(1, value.use_count());
+}
+
+namespace
+{
+    // exposes the two halves of a push, so a producer can be held between them
+    class PausableQueue : public MpscQueue<int, 4>
+    {
+    public:
+        struct Claim
+        {
+            Cell* cell{ nullptr };
+            size_t pos{ 0 };
+        };
+
+        Claim claim()
+        {
+            Claim claim;
+            bool contended = false;
+            claim.cell = MpscQueue::claim(claim.pos, contended);
+            return claim;
+        }
+
+        static void publish(const Claim& claim, const int value) { MpscQueue::publish(claim.cell, claim.pos, value); }
+    };
+
+    template<size_t Capacity>
+    struct OrderCheck
+    {
+        static constexpr int PRODUCERS = 4;
+
+        MpscQueue<std::pair<int, int>, Capacity> queue;
+        std::vector<int> next = std::vector<int>(PRODUCERS, 0);
+        bool ordered = true;
+
+        // produces from every thread while draining, so claims and drains interleave
+        void run(const int perProducer)
+        {
+            std::atomic_int running{ PRODUCERS };
+            std::vector<std::thread> producers;
+            for (int producer = 0; producer < PRODUCERS; ++producer) {
+                producers.emplace_back([&, producer] {
+                    for (int i = 0; i < perProducer; ++i)
+                        queue.emplace(producer, i);
+                    --running;
+                });
+            }
+
+            const auto consume = [&](std::pair<int, int>&& value) {
+                ordered &= value.second == next[value.first];
+                ++next[value.first];
+            };
+
+            while (running > 0)
+                queue.drain(consume);
+            queue.drain(consume);
+
+            for (auto& thread : producers)
+                thread.join();
+        }
+    };
+}
+
+TEST(MpscQueue, OverflowWaitsForClaimedCells)
+{
+    PausableQueue queue;
+
+    // the producer claims the first cell and keeps pushing before writing it
+    const auto first = queue.claim();
+    ASSERT_NE(nullptr, first.cell);
+    for (int i = 1; i <= 4; ++i)
+        queue.emplace(i);
+    EXPECT_EQ(1u, queue.getOverflowPushes());
+
+    std::vector<int> drained;
+    std::atomic_bool done{ false };
+    std::thread consumer([&] {
+        queue.drain([&](int&& value) { drained.emplace_back(value); });
+        done = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done);
+
+    PausableQueue::publish(first, 0);
+    consumer.join();
+
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4 }), drained);
+}
+
+TEST(MpscQueue, ProducersKeepTheirOrder)
+{
+    constexpr int PER_PRODUCER = 20000;
+
+    // room for every push, so all of them race for cells of the ring
+    OrderCheck<1 << 17> check;
+    check.run(PER_PRODUCER);
+
+    EXPECT_TRUE(check.ordered);
+    for (const int count : check.next)
+        EXPECT_EQ(PER_PRODUCER, count);
+    EXPECT_EQ(0u, check.queue.getOverflowPushes());
+}
+
+TEST(MpscQueue, ProducersKeepTheirOrderThroughOverflow)
+{
+    constexpr int PER_PRODUCER = 100000;
+
+    // small ring so the overflow path is taken too
+    OrderCheck<64> check;
+    check.run(PER_PRODUCER);
+
+    EXPECT_TRUE(check.ordered);
+    for (const int count : check.next)
+        EXPECT_EQ(PER_PRODUCER, count);
+    EXPECT_EQ(static_cast<uint64_t>(OrderCheck<64>::PRODUCERS * PER_PRODUCER), check.queue.getPushes());
+}
+
+TEST(MpscQueueBenchmark, DISABLED_Producers)
+{
+    constexpr int PER_PRODUCER = 100000;
+
+    OrderCheck<1024> check;
+
+    const auto begin = std::chrono::steady_clock::now();
+    check.run(PER_PRODUCER);
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << OrderCheck<1024>::PRODUCERS << " producers, " << OrderCheck<1024>::PRODUCERS * PER_PRODUCER << " pushes in " << elapsed << "ms: "
+        << check.queue.getContendedPushes() << " contended, " << check.queue.getOverflowPushes() << " overflowed, max depth "
+        << check.queue.getMaxDepth() << std::endl;
+}
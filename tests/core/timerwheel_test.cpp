@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <framework/core/scheduledevent.h>
+#include <framework/core/timerwheel.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Timer
+{
+    ticks_t ticks;
+    int id;
+};
+
+// what the ordered multiset of the dispatcher fired: every due entry, by ticks then insertion
+std::vector<int> expectedOrder(std::vector<Timer> timers)
+{
+    std::ranges::stable_sort(timers, {}, &Timer::ticks);
+
+    std::vector<int> ids;
+    for (const auto& timer : timers)
+        ids.emplace_back(timer.id);
+    return ids;
+}
+
+}
+
+TEST(TimerWheel, FiresInTickOrder)
+{
+    std::mt19937 rng(1);
+
+    for (const ticks_t range : { 100, 5000, 1 << 16, 1 << 24 }) {
+        TimerWheel<int> wheel(1000);
+
+        std::vector<Timer> timers;
+        for (int i = 0; i < 2000; ++i) {
+            const Timer timer{ 1000 + static_cast<ticks_t>(rng() % range), i };
+            timers.emplace_back(timer);
+            wheel.insert(timer.id, timer.ticks);
+        }
+
+        std::vector<int> fired;
+        // last tick already processed
+        ticks_t now = 999;
+        while (!wheel.empty()) {
+            const ticks_t previous = now;
+            now += 1 + rng() % (range / 50 + 1);
+            wheel.advance(now, [&](const int id) {
+                EXPECT_LE(timers[id].ticks, now);
+                // due entries are never left for a later call
+                EXPECT_GT(timers[id].ticks, previous);
+                fired.emplace_back(id);
+            });
+        }
+
+        EXPECT_EQ(fired, expectedOrder(timers)) << range;
+    }
+}
+
+TEST(TimerWheel, OverdueEntriesFireInTickOrder)
+{
+    TimerWheel<int> wheel(100);
+    wheel.advance(500, [](int) {});
+    EXPECT_EQ(501, wheel.getTime());
+
+    wheel.insert(0, 450);
+    wheel.insert(1, 300);
+    wheel.insert(2, 501);
+    wheel.insert(3, 300);
+
+    std::vector<int> fired;
+    wheel.advance(501, [&](const int id) { fired.emplace_back(id); });
+    EXPECT_EQ(fired, std::vector<int>({ 1, 3, 0, 2 }));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, CancelChecksGeneration)
+{
+    TimerWheel<int> wheel;
+
+    const auto first = wheel.insert(1, 10);
+    const auto far = wheel.insert(2, 100000);
+    EXPECT_EQ(2u, wheel.size());
+
+    EXPECT_TRUE(wheel.cancel(far));
+    EXPECT_FALSE(wheel.cancel(far));
+
+    // the slot of the canceled entry is reused, the old handle must not reach it
+    const auto reused = wheel.insert(3, 20);
+    EXPECT_EQ(far.index, reused.index);
+    EXPECT_FALSE(wheel.cancel(far));
+
+    std::vector<int> fired;
+    wheel.advance(50, [&](const int id) { fired.emplace_back(id); });
+    EXPECT_EQ(fired, std::vector<int>({ 1, 3 }));
+
+    // already fired
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.cancel(TimerHandle{}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, CallbackCanCancelAndInsert)
+{
+    TimerWheel<int> wheel;
+
+    TimerHandle second;
+    wheel.insert(1, 5);
+    second = wheel.insert(2, 5);
+    wheel.insert(3, 5);
+
+    std::vector<int> fired;
+    wheel.advance(5, [&](const int id) {
+        fired.emplace_back(id);
+        if (id == 1) {
+            EXPECT_TRUE(wheel.cancel(second));
+            // overdue, goes to the next tick
+            wheel.insert(4, 0);
+        }
+    });
+    EXPECT_EQ(fired, std::vector<int>({ 1, 3 }));
+
+    wheel.advance(6, [&](const int id) { fired.emplace_back(id); });
+    EXPECT_EQ(fired, std::vector<int>({ 1, 3, 4 }));
+}
+
+TEST(TimerWheel, ReleasesValues)
+{
+    const auto value = std::make_shared<int>(0);
+
+    TimerWheel<std::shared_ptr<int>> wheel;
+    const auto handle = wheel.insert(value, 10);
+    wheel.insert(value, 20);
+    EXPECT_EQ(3, value.use_count());
+
+    wheel.cancel(handle);
+    EXPECT_EQ(2, value.use_count());
+
+    wheel.advance(20, [](const std::shared_ptr<int>&) {});
+    EXPECT_EQ(1, value.use_count());
+}
+
+TEST(TimerWheelBenchmark, DISABLED_WheelVersusBtree)
+{
+    constexpr int COUNT = 100000;
+    constexpr int MAX_DELAY = 10000;
+    constexpr int FRAME = 16;
+
+    std::mt19937 rng(3);
+    std::vector<ScheduledEventPtr> events;
+    events.reserve(COUNT);
+    for (int i = 0; i < COUNT; ++i)
+        events.emplace_back(std::make_shared<ScheduledEvent>(nullptr, static_cast<int>(rng() % MAX_DELAY), 1));
+
+    const auto measure = [](auto&& f) {
+        const auto begin = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    size_t btreeFired = 0;
+    phmap::btree_multiset<ScheduledEventPtr, ScheduledEvent::Compare> btree;
+    const double btreeSchedule = measure([&] {
+        for (const auto& event : events)
+            btree.insert(event);
+    });
+    // the multiset can't find an event by identity, canceled events stay until they expire
+    const double btreeCancel = measure([&] {
+        for (int i = 0; i < COUNT; i += 2)
+            events[i]->cancel();
+    });
+    const double btreeFire = measure([&] {
+        for (ticks_t now = 0; !btree.empty(); now += FRAME) {
+            auto it = btree.begin();
+            while (it != btree.end() && (*it)->ticks() <= now) {
+                if (!(*it)->isCanceled())
+                    ++btreeFired;
+                ++it;
+            }
+            btree.erase(btree.begin(), it);
+        }
+    });
+
+    size_t wheelFired = 0;
+    std::vector<TimerHandle> handles(COUNT);
+    TimerWheel<ScheduledEventPtr> wheel;
+    const double wheelSchedule = measure([&] {
+        for (int i = 0; i < COUNT; ++i)
+            handles[i] = wheel.insert(events[i], events[i]->ticks());
+    });
+    const double wheelCancel = measure([&] {
+        for (int i = 0; i < COUNT; i += 2)
+            wheel.cancel(handles[i]);
+    });
+    const double wheelFire = measure([&] {
+        for (ticks_t now = 0; !wheel.empty(); now += FRAME)
+            wheel.advance(now, [&](const ScheduledEventPtr&) { ++wheelFired; });
+    });
+
+    EXPECT_EQ(btreeFired, wheelFired);
+
+    std::cout << COUNT << " events, half canceled: btree schedule " << btreeSchedule << "us, cancel " << btreeCancel << "us, fire " << btreeFire
+        << "us; wheel schedule " << wheelSchedule << "us, cancel " << wheelCancel << "us, fire " << wheelFire << "us" << std::endl;
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <framework/graphics/drawpool.h>
+#include <framework/graphics/recordingpainter.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+// exposes the batching and submission of a pool without the manager
+class TestDrawPool : public DrawPool
+{
+public:
+    using DrawPool::DrawObject;
+    using DrawPool::PoolState;
+    using DrawPool::batchObjects;
+    using DrawPool::submit;
+};
+
+using DrawObjects = std::vector<TestDrawPool::DrawObject>;
+
+class DrawPoolBatching : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_painter = std::make_unique<RecordingPainter>();
+    }
+
+    void TearDown() override { g_painter.reset(); }
+
+    RecordingPainter& painter() const { return static_cast<RecordingPainter&>(*g_painter); }
+
+    // textured rect, the state is identified by the texture id
+    static void addRect(DrawObjects& objects, const uint32_t textureId, const Rect& dest, const Matrix3& transform = DEFAULT_MATRIX3)
+    {
+        TestDrawPool::PoolState state;
+        state.textureId = textureId;
+        state.transformMatrix = transform;
+        state.hash = textureId;
+        if (transform != DEFAULT_MATRIX3)
+            stdext::hash_union(state.hash, transform.hash());
+
+        auto coords = std::make_shared<CoordsBuffer>();
+        coords->addRect(dest, Rect(0, 0, dest.size()));
+        objects.emplace_back(std::move(state), std::move(coords));
+    }
+
+    static void addAction(DrawObjects& objects) { objects.emplace_back([] {}); }
+
+    static std::vector<uint32_t> getTextures(const DrawObjects& objects)
+    {
+        std::vector<uint32_t> textures;
+        for (const auto& obj : objects)
+            textures.emplace_back(obj.action ? 0 : obj.state.textureId);
+        return textures;
+    }
+};
+
+TEST_F(DrawPoolBatching, MergesSameStateAcrossDisjointDraws)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addRect(objects, 2, Rect(32, 0, 32, 32));
+    addRect(objects, 1, Rect(64, 0, 32, 32));
+    addRect(objects, 2, Rect(96, 0, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+
+    EXPECT_EQ(getTextures(objects), std::vector<uint32_t>({ 1, 2 }));
+    EXPECT_EQ(objects[0].coords->getVertexCount(), 12);
+    EXPECT_EQ(objects[1].coords->getVertexCount(), 12);
+}
+
+TEST_F(DrawPoolBatching, KeepsOrderOfOverlappingDraws)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addRect(objects, 2, Rect(16, 16, 32, 32));
+    addRect(objects, 1, Rect(32, 32, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+
+    EXPECT_EQ(getTextures(objects), std::vector<uint32_t>({ 1, 2, 1 }));
+}
+
+TEST_F(DrawPoolBatching, TouchingDrawsDoNotOverlap)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addRect(objects, 2, Rect(32, 0, 32, 32));
+    addRect(objects, 1, Rect(0, 32, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+
+    EXPECT_EQ(getTextures(objects), std::vector<uint32_t>({ 1, 2 }));
+}
+
+TEST_F(DrawPoolBatching, MergedDrawsKeepTheirOrder)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addRect(objects, 2, Rect(64, 0, 32, 32));
+    addRect(objects, 1, Rect(8, 8, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+
+    ASSERT_EQ(getTextures(objects), std::vector<uint32_t>({ 1, 2 }));
+
+    // second rect of the batch is the one drawn last
+    const float* vertices = objects[0].coords->getVertexArray();
+    EXPECT_EQ(vertices[0], 0.f);
+    EXPECT_EQ(vertices[12], 8.f);
+}
+
+TEST_F(DrawPoolBatching, DoesNotCrossActions)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addAction(objects);
+    addRect(objects, 1, Rect(64, 0, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+
+    EXPECT_EQ(getTextures(objects), std::vector<uint32_t>({ 1, 0, 1 }));
+}
+
+TEST_F(DrawPoolBatching, TransformedDrawsAreNotCrossed)
+{
+    const Matrix3 translated = {
+        1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f,
+        100.0f, 0.0f, 1.0f
+    };
+
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addRect(objects, 2, Rect(500, 500, 32, 32), translated);
+    addRect(objects, 1, Rect(64, 0, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+
+    EXPECT_EQ(getTextures(objects), std::vector<uint32_t>({ 1, 2, 1 }));
+}
+
+TEST_F(DrawPoolBatching, SubmitsOneStreamAndOneDrawPerBatch)
+{
+    DrawObjects objects;
+    for (int i = 0; i < 64; ++i)
+        addRect(objects, 1 + i % 4, Rect(i * 32, 0, 32, 32));
+
+    TestDrawPool::batchObjects(objects);
+    ASSERT_EQ(objects.size(), 4u);
+
+    TestDrawPool pool;
+    pool.submit(objects);
+
+    EXPECT_EQ(painter().getUploads(), 1u);
+    EXPECT_EQ(painter().getUploadedVertices(), 64u * 6);
+    EXPECT_EQ(painter().getDrawCalls(), 4u);
+    EXPECT_EQ(painter().getTextureChanges(), 4u);
+
+    int first = 0;
+    for (const auto& draw : painter().getDraws()) {
+        EXPECT_TRUE(draw.streamed);
+        EXPECT_EQ(draw.first, first);
+        EXPECT_EQ(draw.count, 16 * 6);
+        first += draw.count;
+    }
+}
+
+TEST_F(DrawPoolBatching, ResubmitReusesTheStream)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+    addAction(objects);
+    addRect(objects, 2, Rect(0, 0, 32, 32));
+
+    TestDrawPool pool;
+    pool.submit(objects);
+    pool.submit(objects, false);
+
+    EXPECT_EQ(painter().getUploads(), 1u);
+    EXPECT_EQ(painter().getUploadedVertices(), 12u);
+    ASSERT_EQ(painter().getDrawCalls(), 4u);
+    EXPECT_EQ(painter().getDraws()[1].first, 6);
+    EXPECT_EQ(painter().getDraws()[3].first, 6);
+}
+
+TEST_F(DrawPoolBatching, ResubmitUploadsAgainOnceTheBufferWasReused)
+{
+    DrawObjects objects;
+    addRect(objects, 1, Rect(0, 0, 32, 32));
+
+    TestDrawPool pool;
+    pool.submit(objects);
+
+    // enough other pools to go around the whole ring of buffers
+    std::vector<TestDrawPool> others(8);
+    for (auto& other : others)
+        other.submit(objects);
+
+    painter().resetCounters();
+    pool.submit(objects, false);
+
+    EXPECT_EQ(painter().getUploads(), 1u);
+    EXPECT_EQ(painter().getDrawCalls(), 1u);
+}
+
+}
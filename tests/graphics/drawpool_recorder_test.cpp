@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include <framework/graphics/drawpoolmanager.h>
+#undef protected
+#undef private
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// clears the pool selected on the calling thread, see drawpoolmanager.cpp
+void resetSelectedPool();
+
+namespace {
+
+constexpr size_t CHUNKS = 4;
+constexpr int DRAWS_PER_CHUNK = 24;
+
+// what a recorded draw turns into, enough to tell two pools apart
+struct RecordedObject
+{
+    size_t hash{ 0 };
+    Color color;
+    std::vector<float> vertices;
+
+    bool operator==(const RecordedObject&) const = default;
+};
+
+// same draws for the same chunk, repeating colors so neighbors share a state
+// across chunk boundaries too
+void recordChunk(const size_t chunk)
+{
+    static const Color colors[] = { Color::red, Color::red, Color::green, Color::blue };
+
+    for (int i = 0; i < DRAWS_PER_CHUNK; ++i) {
+        const int n = static_cast<int>(chunk) * DRAWS_PER_CHUNK + i;
+        g_drawPool.addFilledRect(Rect(n * 8, n % 5 * 8, 8, 8), colors[(n / 3) % 4]);
+    }
+}
+
+std::vector<RecordedObject> getObjects(const DrawPool& pool)
+{
+    std::vector<RecordedObject> objects;
+    for (const auto& obj : pool.m_objectsFlushed) {
+        auto& object = objects.emplace_back(obj.state.hash, obj.state.color);
+        if (obj.coords)
+            object.vertices.assign(obj.coords->getVertexArray(), obj.coords->getVertexArray() + obj.coords->getVertexCount() * 2);
+    }
+    return objects;
+}
+
+class DrawPoolRecorders : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_drawPool.m_pools[static_cast<uint8_t>(DrawPoolType::MAP)] = &m_pool;
+        g_drawPool.m_pools[static_cast<uint8_t>(DrawPoolType::FOREGROUND)] = &m_other;
+    }
+
+    void TearDown() override
+    {
+        g_drawPool.m_pools[static_cast<uint8_t>(DrawPoolType::MAP)] = nullptr;
+        g_drawPool.m_pools[static_cast<uint8_t>(DrawPoolType::FOREGROUND)] = nullptr;
+    }
+
+    DrawPool m_pool;
+    DrawPool m_other;
+};
+
+TEST_F(DrawPoolRecorders, SplicingKeepsTheSequentialOrder)
+{
+    g_drawPool.select(DrawPoolType::MAP);
+    for (size_t chunk = 0; chunk < CHUNKS; ++chunk)
+        recordChunk(chunk);
+    resetSelectedPool();
+    m_pool.flush();
+
+    const auto sequential = getObjects(m_pool);
+    ASSERT_FALSE(sequential.empty());
+    m_pool.m_objectsFlushed.clear();
+
+    // recorded in reverse, the result only depends on the index
+    m_pool.prepareRecorders(CHUNKS);
+    std::vector<std::thread> workers;
+    for (size_t chunk = CHUNKS; chunk-- > 0;) {
+        workers.emplace_back([chunk] {
+            g_drawPool.record(DrawPoolType::MAP, chunk, [chunk] { recordChunk(chunk); });
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    m_pool.spliceRecorders(CHUNKS);
+
+    EXPECT_EQ(sequential, getObjects(m_pool));
+}
+
+TEST_F(DrawPoolRecorders, ThrowingRecordingUnbindsTheThread)
+{
+    m_pool.prepareRecorders(1);
+
+    EXPECT_THROW(g_drawPool.record(DrawPoolType::MAP, 0, [] { throw std::runtime_error("failed"); }), std::runtime_error);
+
+    // later draws on this thread go to the pool selected, not to the recorder
+    EXPECT_FALSE(g_drawPool.isPreDrawing());
+    g_drawPool.select(DrawPoolType::FOREGROUND);
+    EXPECT_EQ(&m_other, g_drawPool.getCurrentPool());
+    resetSelectedPool();
+}
+
+}
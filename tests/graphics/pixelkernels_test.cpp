@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <framework/graphics/pixelkernels.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t MAGENTA = 0xFF00FF;
+constexpr size_t SHEET_SIZE = 384;
+
+// odd sizes so every kernel goes through its scalar tail
+constexpr size_t COUNTS[] = { 0, 1, 3, 4, 5, 7, 8, 15, 16, 17, 31, 33, 63, 100, 257, SHEET_SIZE * SHEET_SIZE };
+
+class PixelsIsa
+{
+public:
+    explicit PixelsIsa(const Pixels::Isa isa) : m_previous(Pixels::getIsa()) { m_supported = Pixels::setIsa(isa); }
+    ~PixelsIsa() { Pixels::setIsa(m_previous); }
+
+    bool isSupported() const { return m_supported; }
+
+private:
+    Pixels::Isa m_previous;
+    bool m_supported{ false };
+};
+
+std::vector<Pixels::Isa> getVectorIsas()
+{
+    std::vector<Pixels::Isa> isas;
+    for (const auto isa : { Pixels::Isa::Sse2, Pixels::Isa::Avx2, Pixels::Isa::Neon }) {
+        if (Pixels::isSupported(isa))
+            isas.emplace_back(isa);
+    }
+    return isas;
+}
+
+// random pixels with some color key ones and a mix of alpha values
+std::vector<uint8_t> makePixels(const size_t count, const uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> pixels(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* p = &pixels[i * 4];
+        for (int c = 0; c < 4; ++c)
+            p[c] = static_cast<uint8_t>(rng());
+
+        switch (rng() % 6) {
+            case 0: p[0] = 0xFF; p[1] = 0x00; p[2] = 0xFF; break;
+            case 1: p[3] = 0x00; break;
+            case 2: p[3] = 0xFF; break;
+            default: break;
+        }
+    }
+    return pixels;
+}
+
+std::vector<uint8_t> makeOpaquePixels(const size_t count)
+{
+    std::vector<uint8_t> pixels(count * 4, 0x7F);
+    for (size_t i = 0; i < count; ++i)
+        pixels[i * 4 + 3] = 0xFF;
+    return pixels;
+}
+
+template<typename Kernel>
+std::vector<uint8_t> runWith(const Pixels::Isa isa, std::vector<uint8_t> pixels, Kernel&& kernel)
+{
+    PixelsIsa scope(isa);
+    kernel(pixels);
+    return pixels;
+}
+
+template<typename Kernel>
+void expectSameAsScalar(Kernel&& kernel)
+{
+    for (const auto isa : getVectorIsas()) {
+        for (const size_t count : COUNTS) {
+            const auto& pixels = makePixels(count, static_cast<uint32_t>(count));
+            EXPECT_EQ(runWith(Pixels::Isa::Scalar, pixels, kernel), runWith(isa, pixels, kernel))
+                << Pixels::getIsaName(isa) << ", " << count << " pixels";
+        }
+    }
+}
+
+TEST(PixelKernels, ScalarSwizzleClearsColorKey)
+{
+    PixelsIsa scope(Pixels::Isa::Scalar);
+
+    std::vector<uint8_t> pixels = { 1, 2, 3, 4, 0xFF, 0x00, 0xFF, 0x80, 0xFF, 0x01, 0xFF, 0xFF };
+    Pixels::swizzleRedBlueClearColorKey(pixels.data(), 3, MAGENTA);
+    EXPECT_EQ(pixels, std::vector<uint8_t>({ 3, 2, 1, 4, 0, 0, 0, 0, 0xFF, 0x01, 0xFF, 0xFF }));
+}
+
+TEST(PixelKernels, SwizzleMatchesScalar)
+{
+    expectSameAsScalar([](std::vector<uint8_t>& pixels) { Pixels::swizzleRedBlue(pixels.data(), pixels.size() / 4); });
+}
+
+TEST(PixelKernels, ClearColorKeyMatchesScalar)
+{
+    expectSameAsScalar([](std::vector<uint8_t>& pixels) { Pixels::clearColorKey(pixels.data(), pixels.size() / 4, MAGENTA); });
+}
+
+TEST(PixelKernels, SwizzleClearColorKeyMatchesScalar)
+{
+    expectSameAsScalar([](std::vector<uint8_t>& pixels) { Pixels::swizzleRedBlueClearColorKey(pixels.data(), pixels.size() / 4, MAGENTA); });
+}
+
+TEST(PixelKernels, FlipRowsMatchesScalar)
+{
+    for (const size_t rowBytes : { 4, 12, 36, 100, 132, 1536 }) {
+        expectSameAsScalar([rowBytes](std::vector<uint8_t>& pixels) {
+            Pixels::flipRows(pixels.data(), rowBytes, pixels.size() / rowBytes);
+        });
+    }
+}
+
+TEST(PixelKernels, RgbToRgbaMatchesScalar)
+{
+    expectSameAsScalar([](std::vector<uint8_t>& pixels) {
+        // the first three quarters are the rgb source
+        const size_t count = pixels.size() / 4;
+        const std::vector<uint8_t> rgb(pixels.begin(), pixels.begin() + count * 3);
+        Pixels::rgbToRgba(pixels.data(), rgb.data(), count);
+    });
+}
+
+TEST(PixelKernels, ScalarMaxPixelsTakesHighestChannels)
+{
+    PixelsIsa scope(Pixels::Isa::Scalar);
+
+    std::vector<uint8_t> pixels = { 10, 200, 0, 255, 0xFF, 0, 0x80, 0 };
+    const std::vector<uint8_t> light = { 20, 100, 0, 0, 0, 0xFF, 0x7F, 0x10 };
+    Pixels::maxPixels(pixels.data(), light.data(), 2);
+    EXPECT_EQ(pixels, std::vector<uint8_t>({ 20, 200, 0, 255, 0xFF, 0xFF, 0x80, 0x10 }));
+}
+
+TEST(PixelKernels, MaxPixelsMatchesScalar)
+{
+    expectSameAsScalar([](std::vector<uint8_t>& pixels) {
+        const size_t count = pixels.size() / 4;
+        const auto& light = makePixels(count, static_cast<uint32_t>(count) + 7);
+        Pixels::maxPixels(pixels.data(), light.data(), count);
+    });
+}
+
+TEST(PixelKernels, TransparencyMatchesScalar)
+{
+    for (const auto isa : getVectorIsas()) {
+        for (const size_t count : COUNTS) {
+            auto pixels = makePixels(count, static_cast<uint32_t>(count) + 1);
+            const auto& opaque = makeOpaquePixels(count);
+
+            for (const size_t minCount : { 0, 4, 100 }) {
+                bool expected;
+                {
+                    PixelsIsa scope(Pixels::Isa::Scalar);
+                    expected = Pixels::hasTransparentPixels(pixels.data(), count, minCount);
+                    EXPECT_FALSE(Pixels::hasTransparentPixels(opaque.data(), count, minCount));
+                }
+                PixelsIsa scope(isa);
+                EXPECT_EQ(expected, Pixels::hasTransparentPixels(pixels.data(), count, minCount)) << Pixels::getIsaName(isa) << ", " << count << " pixels";
+                EXPECT_FALSE(Pixels::hasTransparentPixels(opaque.data(), count, minCount));
+            }
+
+            PixelsIsa scope(isa);
+            EXPECT_FALSE(Pixels::hasTranslucentPixel(opaque.data(), count));
+            if (count > 0) {
+                // a single translucent pixel, at the end so it is found by the tail
+                auto translucent = opaque;
+                translucent[count * 4 - 1] = 0xFE;
+                EXPECT_TRUE(Pixels::hasTranslucentPixel(translucent.data(), count)) << Pixels::getIsaName(isa) << ", " << count << " pixels";
+            }
+        }
+    }
+}
+
+TEST(PixelKernelsBenchmark, DISABLED_SpriteSheet)
+{
+    constexpr int ITERATIONS = 50;
+    constexpr size_t COUNT = SHEET_SIZE * SHEET_SIZE;
+
+    auto pixels = makePixels(COUNT, 42);
+    std::vector<uint8_t> rgba(COUNT * 4);
+
+    auto isas = getVectorIsas();
+    isas.insert(isas.begin(), Pixels::Isa::Scalar);
+
+    for (const auto isa : isas) {
+        PixelsIsa scope(isa);
+
+        const auto measure = [&](auto&& kernel) {
+            const auto begin = std::chrono::steady_clock::now();
+            for (int i = 0; i < ITERATIONS; ++i)
+                kernel();
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / ITERATIONS;
+        };
+
+        const double swizzle = measure([&] { Pixels::swizzleRedBlueClearColorKey(pixels.data(), COUNT, MAGENTA); });
+        const double flip = measure([&] { Pixels::flipRows(pixels.data(), SHEET_SIZE * 4, SHEET_SIZE); });
+        const double expand = measure([&] { Pixels::rgbToRgba(rgba.data(), pixels.data(), COUNT); });
+        // minCount of every pixel, so the whole sheet is scanned
+        const double transparent = measure([&] { Pixels::hasTransparentPixels(pixels.data(), COUNT, COUNT); });
+
+        std::cout << Pixels::getIsaName(isa) << " per 384x384 sheet: swizzle+key " << swizzle << "us, flip " << flip
+            << "us, rgb to rgba " << expand << "us, transparency " << transparent << "us" << std::endl;
+    }
+}
+
+}
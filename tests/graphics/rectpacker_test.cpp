@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <framework/graphics/image.h>
+#include <framework/graphics/rectpacker.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+bool isPowerOfTwo(const int value) { return value > 0 && (value & (value - 1)) == 0; }
+
+// every non empty size lies inside the bin and no two of them overlap
+void expectPacked(const Size& binSize, const std::vector<Size>& sizes, const std::vector<Point>& positions)
+{
+    ASSERT_EQ(sizes.size(), positions.size());
+
+    const Rect bin(Point(), binSize);
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (sizes[i].area() == 0)
+            continue;
+
+        const Rect rect(positions[i], sizes[i]);
+        EXPECT_TRUE(bin.contains(rect)) << "rect " << i;
+        for (size_t j = i + 1; j < sizes.size(); ++j) {
+            if (sizes[j].area() != 0)
+                EXPECT_FALSE(rect.intersects(Rect(positions[j], sizes[j]))) << "rects " << i << " and " << j;
+        }
+    }
+}
+
+TEST(RectPacker, PackRectsFailsWhenTheBinIsTooSmall)
+{
+    const std::vector<Size> sizes = { Size(32, 32), Size(32, 32), Size(32, 32) };
+    const std::vector<uint32_t> order = { 0, 1, 2 };
+    std::vector<Point> positions(sizes.size());
+
+    EXPECT_FALSE(RectPacker::packRects(Size(64, 32), sizes, order, positions));
+
+    ASSERT_TRUE(RectPacker::packRects(Size(64, 64), sizes, order, positions));
+    expectPacked(Size(64, 64), sizes, positions);
+}
+
+TEST(RectPacker, PackRectsOnlyPlacesTheOrderedSizes)
+{
+    const std::vector<Size> sizes = { Size(64, 64), Size(16, 8) };
+    std::vector<Point> positions(sizes.size(), Point(-1, -1));
+
+    ASSERT_TRUE(RectPacker::packRects(Size(16, 8), sizes, { 1 }, positions));
+    EXPECT_EQ(positions[0], Point(-1, -1));
+    EXPECT_EQ(positions[1], Point(0, 0));
+}
+
+TEST(RectPacker, PackFramesUsesAPowerOfTwoBin)
+{
+    std::mt19937 rng(7);
+    for (int round = 0; round < 50; ++round) {
+        std::vector<Size> sizes(1 + rng() % 40);
+        for (auto& size : sizes) {
+            // some frames have nothing to draw
+            size = rng() % 8 == 0 ? Size(0) : Size(1 + rng() % 64, 1 + rng() % 64);
+        }
+
+        std::vector<Point> positions;
+        const auto& binSize = RectPacker::packFrames(sizes, positions);
+        EXPECT_TRUE(isPowerOfTwo(binSize.width()) && isPowerOfTwo(binSize.height())) << binSize.width() << "x" << binSize.height();
+        expectPacked(binSize, sizes, positions);
+    }
+}
+
+TEST(RectPacker, PackFramesOfEmptySizes)
+{
+    std::vector<Point> positions;
+    EXPECT_EQ(RectPacker::packFrames({ Size(0), Size(0) }, positions), Size(1));
+    EXPECT_EQ(positions, std::vector<Point>(2, Point()));
+
+    EXPECT_EQ(RectPacker::packFrames({ Size(32, 32) }, positions), Size(32, 32));
+    EXPECT_EQ(positions, std::vector<Point>{ Point() });
+}
+
+TEST(ImageBlit, CopiesOnlyTheSourceRect)
+{
+    const auto& sprite = std::make_shared<Image>(Size(4, 4));
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x)
+            sprite->setPixel(x, y, Color(static_cast<uint8_t>(x * 16 + y), 0, 0, 255));
+    }
+    // transparent pixels inside the rect keep what is under them
+    sprite->setPixel(2, 2, Color::alpha);
+
+    const auto& image = std::make_shared<Image>(Size(2, 2));
+    image->setPixel(1, 1, Color::white);
+    image->blit(Point(0, 0), sprite, Rect(1, 1, 2, 2));
+
+    EXPECT_EQ(image->getPixel(0, 0)[0], 1 * 16 + 1);
+    EXPECT_EQ(image->getPixel(1, 0)[0], 2 * 16 + 1);
+    EXPECT_EQ(image->getPixel(0, 1)[0], 1 * 16 + 2);
+    EXPECT_EQ(image->getPixel(1, 1)[0], 0xFF);
+    EXPECT_EQ(image->getPixel(1, 1)[3], 0xFF);
+}
+
+}
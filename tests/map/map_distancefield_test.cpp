@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "client/distancefield.h"
+#include "client/pathfinder.h"
+
+#include <chrono>
+#include <random>
+
+namespace {
+
+constexpr int GRID_SIZE = 200;
+
+// synthetic map so the field can be checked against PathFinder without setting up tiles
+class Grid
+{
+public:
+    explicit Grid(const uint32_t seed) : m_cells(GRID_SIZE * GRID_SIZE)
+    {
+        std::mt19937 rng(seed);
+        for (auto& cell : m_cells) {
+            cell.flags = PathFinder::CellWasSeen;
+            cell.speed = 100 + (rng() % 4) * 50;
+            if (rng() % 8 == 0)
+                cell.flags |= PathFinder::CellNotWalkable | PathFinder::CellNotPathable;
+            else if (rng() % 40 == 0)
+                cell.flags |= PathFinder::CellHasCreature;
+        }
+    }
+
+    PathFinder::Cell operator()(const Position& pos) const
+    {
+        if (pos.x < 0 || pos.y < 0 || pos.x >= GRID_SIZE || pos.y >= GRID_SIZE)
+            return { .flags = PathFinder::CellWasSeen | PathFinder::CellNotWalkable | PathFinder::CellNotPathable };
+        return m_cells[pos.y * GRID_SIZE + pos.x];
+    }
+
+    PathFinder::Cell& at(const Position& pos) { return m_cells[pos.y * GRID_SIZE + pos.x]; }
+
+private:
+    std::vector<PathFinder::Cell> m_cells;
+};
+
+float pathCost(const Grid& grid, Position pos, const std::vector<Otc::Direction>& dirs)
+{
+    float cost = 0;
+    for (const auto dir : dirs) {
+        pos = pos.translatedToDirection(dir);
+        cost += (grid(pos).speed * (dir >= Otc::NorthEast ? 3.0f : 1.0f)) / 100.0f;
+    }
+    return cost;
+}
+
+} // namespace
+
+TEST(DistanceField, StartAndUnreachable)
+{
+    Grid grid(1);
+    const Position start(100, 100, 7);
+    grid.at(start) = {};
+
+    const auto& wallPos = start.translated(2, 0);
+    grid.at(wallPos).flags |= PathFinder::CellNotWalkable;
+
+    DistanceField field(0, std::ref(grid));
+    field.compute(start, 10);
+
+    EXPECT_EQ(0.f, field.getCost(start));
+    EXPECT_EQ(0, field.getDistance(start));
+    EXPECT_EQ(Otc::InvalidDirection, field.getNextStep(start));
+    EXPECT_TRUE(field.getPath(start).empty());
+
+    EXPECT_FALSE(field.isReachable(wallPos));
+    EXPECT_EQ(-1.f, field.getCost(wallPos));
+    EXPECT_FALSE(field.isReachable(start.translated(0, 0, 1)));
+    EXPECT_FALSE(field.isReachable(start.translated(11, 0)));
+}
+
+TEST(DistanceField, CreaturesAreTargetsButNotWalkedThrough)
+{
+    Grid grid(2);
+    const Position start(100, 100, 7);
+
+    // corridor going east with a creature in the middle
+    for (int y = -2; y <= 2; ++y)
+        for (int x = -2; x <= 8; ++x)
+            grid.at(start.translated(x, y)) = { .flags = PathFinder::CellWasSeen | (y == 0 && x >= 0 ? 0 : PathFinder::CellNotWalkable) };
+
+    const auto& creaturePos = start.translated(3, 0);
+    grid.at(creaturePos).flags |= PathFinder::CellHasCreature;
+
+    DistanceField field(0, std::ref(grid));
+    field.compute(start, 20);
+
+    ASSERT_TRUE(field.isReachable(creaturePos));
+    EXPECT_EQ(3, field.getDistance(creaturePos));
+    EXPECT_EQ(Otc::East, field.getNextStep(creaturePos));
+    EXPECT_EQ(std::vector<Otc::Direction>(3, Otc::East), field.getPath(creaturePos));
+    EXPECT_FALSE(field.isReachable(start.translated(4, 0)));
+
+    EXPECT_EQ(creaturePos, field.getClosest({ start.translated(6, 0), creaturePos, start.translated(-1, -1) }));
+}
+
+TEST(DistanceField, MatchesPathFinder)
+{
+    const Grid grid(3);
+    const Position start(100, 100, 7);
+
+    DistanceField field(0, std::cref(grid));
+    field.compute(start, 60);
+
+    PathFinder finder;
+    std::mt19937 rng(4);
+    for (int i = 0; i < 300; ++i) {
+        const auto& goal = start.translated(static_cast<int>(rng() % 61) - 30, static_cast<int>(rng() % 61) - 30);
+        if (goal == start)
+            continue;
+
+        const auto& [dirs, result] = finder.find(start, goal, 100000, 0, std::cref(grid));
+        ASSERT_EQ(result == Otc::PathFindResultOk, field.isReachable(goal)) << goal;
+        if (result != Otc::PathFindResultOk)
+            continue;
+
+        const auto& path = field.getPath(goal);
+        EXPECT_NEAR(pathCost(grid, start, dirs), field.getCost(goal), 0.01f) << goal;
+        EXPECT_NEAR(field.getCost(goal), pathCost(grid, start, path), 0.01f) << goal;
+        ASSERT_EQ(static_cast<size_t>(field.getDistance(goal)), path.size());
+        EXPECT_EQ(path.front(), field.getNextStep(goal));
+        EXPECT_EQ(path.back(), field.getDirection(goal));
+    }
+}
+
+TEST(DistanceFieldBenchmark, DISABLED_FieldVersusPerTargetSearch)
+{
+    const Grid grid(5);
+    const Position start(100, 100, 7);
+
+    std::mt19937 rng(6);
+    std::vector<Position> targets;
+    for (int i = 0; i < 200; ++i)
+        targets.emplace_back(start.translated(static_cast<int>(rng() % 21) - 10, static_cast<int>(rng() % 17) - 8));
+
+    PathFinder finder;
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& target : targets)
+        finder.find(start, target, 10000, 0, std::cref(grid));
+    const double search = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+    DistanceField field(0, std::cref(grid));
+    begin = std::chrono::steady_clock::now();
+    field.compute(start, 20);
+    float total = 0;
+    for (const auto& target : targets)
+        total += field.getCost(target);
+    const double bulk = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << targets.size() << " targets: per-target search " << search << "us, distance field " << bulk << "us (" << total << ")" << std::endl;
+}
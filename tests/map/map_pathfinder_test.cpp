@@ -0,0 +1,768 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/map.h"
+
+#include "client/gameconfig.h"
+#include "client/item.h"
+#include "client/minimap.h"
+#include "client/pathplanner.h"
+#include "client/tile.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+#include "client/walksnapshot.h"
+
+#undef protected
+#undef private
+
+#include "map_test_environment.h"
+
+#include <chrono>
+#include <list>
+#include <random>
+
+namespace {
+
+constexpr uint16_t WALL_ID = 10;
+constexpr uint16_t FIRST_GROUND_ID = 100;
+
+void registerItemType(const uint16_t id, const uint64_t flags, const uint16_t groundSpeed)
+{
+    auto& types = g_things.m_thingTypes[ThingCategoryItem];
+    if (types.size() <= id)
+        types.resize(id + 1, g_things.m_nullThingType);
+
+    const auto& type = std::make_shared<ThingType>();
+    type->m_null = false;
+    type->m_id = id;
+    type->m_category = ThingCategoryItem;
+    type->m_size = Size(1, 1);
+    type->m_realSize = 32;
+    type->m_layers = 1;
+    type->m_animationPhases = 1;
+    type->m_opacity = 1.f;
+    type->m_flags = flags;
+    type->m_groundSpeed = groundSpeed;
+    types[id] = type;
+}
+
+// grounds with speeds 100, 150, 200 and 250
+ItemPtr makeGround(const uint8_t speedLevel) { return Item::create(FIRST_GROUND_ID + speedLevel); }
+ItemPtr makeWall() { return Item::create(WALL_ID); }
+
+class PathFinderEnvironment : public FrameworkEnvironment
+{
+public:
+    void SetUp() override
+    {
+        FrameworkEnvironment::SetUp();
+        g_things.init();
+        g_minimap.init();
+
+        registerItemType(WALL_ID, ThingFlagAttrNotWalkable | ThingFlagAttrNotPathable | ThingFlagAttrOnBottom, 0);
+        for (uint8_t i = 0; i < 4; ++i)
+            registerItemType(FIRST_GROUND_ID + i, ThingFlagAttrGround, 100 + i * 50);
+    }
+
+    void TearDown() override
+    {
+        g_minimap.terminate();
+        g_things.terminate();
+        FrameworkEnvironment::TearDown();
+    }
+};
+
+[[maybe_unused]] testing::Environment* const g_frameworkEnv = testing::AddGlobalTestEnvironment(new PathFinderEnvironment);
+
+constexpr int MAP_RADIUS = 100;
+
+enum class Layout
+{
+    Plain,
+    Open,
+    Maze
+};
+
+void setupMap(Map& map, const Position& center, const Layout layout, const uint32_t seed)
+{
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_centralPosition = center;
+    map.m_awareRange = { .left = MAP_RADIUS, .top = MAP_RADIUS, .right = MAP_RADIUS, .bottom = MAP_RADIUS };
+
+    std::mt19937 rng(seed);
+    for (int y = -MAP_RADIUS; y <= MAP_RADIUS; ++y) {
+        for (int x = -MAP_RADIUS; x <= MAP_RADIUS; ++x) {
+            const auto& pos = center.translated(x, y);
+            const auto& tile = map.createTile(pos);
+            tile->addThing(makeGround(rng() % 4), -1);
+
+            bool wall = false;
+            if (layout == Layout::Open)
+                wall = rng() % 12 == 0;
+            else if (layout == Layout::Maze) // vertical walls every 4 columns with random gaps
+                wall = (x + MAP_RADIUS) % 4 == 2 && rng() % 10 != 0;
+
+            if (wall && pos != center)
+                tile->addThing(makeWall(), -1);
+        }
+    }
+}
+
+// copy of the node-per-tile dijkstra search that Map::findPath used before PathFinder
+std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> legacyFindPath(Map& map, const Position& startPos, const Position& goalPos, const int maxComplexity, const int flags)
+{
+    struct SNode
+    {
+        SNode(const Position& pos) :
+            pos(pos) {}
+        float cost{ 0 };
+        float totalCost{ 0 };
+        Position pos;
+        SNode* prev{ nullptr };
+        Otc::Direction dir{ Otc::InvalidDirection };
+    };
+
+    struct LessNode
+    {
+        bool operator()(const std::pair<SNode*, float> a, const std::pair<SNode*, float> b) const
+        {
+            return b.second < a.second;
+        }
+    };
+
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
+    std::vector<Otc::Direction>& dirs = std::get<0>(ret);
+    Otc::PathFindResult& result = std::get<1>(ret);
+
+    result = Otc::PathFindResultNoWay;
+
+    if (startPos == goalPos) {
+        result = Otc::PathFindResultSamePosition;
+        return ret;
+    }
+
+    if (startPos.z != goalPos.z) {
+        result = Otc::PathFindResultImpossible;
+        return ret;
+    }
+
+    if (map.isAwareOfPosition(goalPos)) {
+        const auto& goalTile = map.getTile(goalPos);
+        if (!goalTile || (!goalTile->isWalkable(flags & Otc::PathFindIgnoreCreatures))) {
+            return ret;
+        }
+    } else {
+        const auto& goalTile = g_minimap.getTile(goalPos);
+        if (goalTile.hasFlag(MinimapTileNotWalkable)) {
+            return ret;
+        }
+    }
+
+    stdext::map<Position, SNode*, Position::Hasher> nodes;
+    std::priority_queue<std::pair<SNode*, float>, std::vector<std::pair<SNode*, float>>, LessNode> searchList;
+
+    auto* currentNode = new SNode(startPos);
+    nodes[startPos] = currentNode;
+    SNode* foundNode = nullptr;
+    while (currentNode) {
+        if (static_cast<int>(nodes.size()) > maxComplexity) {
+            result = Otc::PathFindResultTooFar;
+            break;
+        }
+
+        if (currentNode->pos == goalPos && (!foundNode || currentNode->cost < foundNode->cost))
+            foundNode = currentNode;
+
+        if (foundNode && currentNode->totalCost >= foundNode->cost)
+            break;
+
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                bool wasSeen = false;
+                bool hasCreature = false;
+                bool isNotWalkable = true;
+                bool isNotPathable = true;
+                int speed = 100;
+
+                Position neighborPos = currentNode->pos.translated(i, j);
+                if (neighborPos.x < 0 || neighborPos.y < 0) continue;
+                if (map.isAwareOfPosition(neighborPos)) {
+                    wasSeen = true;
+                    if (const auto& tile = map.getTile(neighborPos)) {
+                        hasCreature = tile->hasCreatures() && (!(flags & Otc::PathFindIgnoreCreatures));
+                        isNotWalkable = !tile->isWalkable(flags & Otc::PathFindIgnoreCreatures);
+                        isNotPathable = !tile->isPathable();
+                        speed = tile->getGroundSpeed();
+                    }
+                } else {
+                    const auto& mtile = g_minimap.getTile(neighborPos);
+                    wasSeen = mtile.hasFlag(MinimapTileWasSeen);
+                    isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
+                    isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
+                    if (isNotWalkable || isNotPathable)
+                        wasSeen = true;
+                    speed = mtile.getSpeed();
+                }
+
+                if (neighborPos != goalPos) {
+                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+                        continue;
+                    if (wasSeen) {
+                        if (!(flags & Otc::PathFindAllowCreatures) && hasCreature)
+                            continue;
+                        if (!(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
+                            continue;
+                        if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                            continue;
+                    }
+                } else {
+                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+                        continue;
+                    if (wasSeen && !(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                        continue;
+                }
+
+                const Otc::Direction walkDir = currentNode->pos.getDirectionFromPosition(neighborPos);
+                const float walkFactor = walkDir >= Otc::NorthEast ? 3.0f : 1.0f;
+                const float cost = currentNode->cost + (speed * walkFactor) / 100.0f;
+
+                SNode* neighborNode;
+                if (!nodes.contains(neighborPos)) {
+                    neighborNode = new SNode(neighborPos);
+                    nodes[neighborPos] = neighborNode;
+                } else {
+                    neighborNode = nodes[neighborPos];
+                    if (neighborNode->cost <= cost)
+                        continue;
+                }
+
+                neighborNode->prev = currentNode;
+                neighborNode->cost = cost;
+                neighborNode->totalCost = neighborNode->cost + neighborPos.distance(goalPos);
+                neighborNode->dir = walkDir;
+                searchList.emplace(neighborNode, neighborNode->totalCost);
+            }
+        }
+
+        if (!searchList.empty()) {
+            currentNode = searchList.top().first;
+            searchList.pop();
+        } else
+            currentNode = nullptr;
+    }
+
+    if (foundNode) {
+        currentNode = foundNode;
+        while (currentNode) {
+            dirs.push_back(currentNode->dir);
+            currentNode = currentNode->prev;
+        }
+        dirs.pop_back();
+        std::ranges::reverse(dirs);
+        result = Otc::PathFindResultOk;
+    }
+
+    for (const auto& it : nodes)
+        delete it.second;
+
+    return ret;
+}
+
+// walks the path over the map, returns the accumulated cost or -1 when it doesn't end at the goal
+float pathCost(Map& map, Position pos, const Position& goal, const std::vector<Otc::Direction>& dirs)
+{
+    float cost = 0;
+    for (const auto dir : dirs) {
+        pos = pos.translatedToDirection(dir);
+        const auto& tile = map.getTile(pos);
+        if (!tile)
+            return -1;
+        cost += (tile->getGroundSpeed() * (dir >= Otc::NorthEast ? 3.0f : 1.0f)) / 100.0f;
+    }
+    return pos == goal ? cost : -1;
+}
+
+std::vector<std::pair<Position, Position>> makeQueries(const Position& center, const uint32_t seed, const int count)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> offset(-MAP_RADIUS + 1, MAP_RADIUS - 1);
+
+    std::vector<std::pair<Position, Position>> queries;
+    for (int i = 0; i < count; ++i)
+        queries.emplace_back(center.translated(offset(rng), offset(rng)), center.translated(offset(rng), offset(rng)));
+    return queries;
+}
+
+void expectParity(const Layout layout)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, layout, 7);
+
+    for (const auto& [start, goal] : makeQueries(center, 11, 40)) {
+        const auto& [legacyDirs, legacyResult] = legacyFindPath(map, start, goal, 100000, 0);
+        const auto& [dirs, result] = map.findPath(start, goal, 100000, 0);
+
+        ASSERT_EQ(legacyResult, result) << start << " -> " << goal;
+        if (result == Otc::PathFindResultOk) {
+            const float legacyCost = pathCost(map, start, goal, legacyDirs);
+            const float cost = pathCost(map, start, goal, dirs);
+            ASSERT_GE(cost, 0.f);
+            EXPECT_NEAR(legacyCost, cost, 0.01f) << start << " -> " << goal;
+        }
+    }
+}
+
+double benchmark(const std::function<void(const Position&, const Position&)>& search, const std::vector<std::pair<Position, Position>>& queries)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    for (const auto& [start, goal] : queries)
+        search(start, goal);
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / queries.size();
+}
+
+} // namespace
+
+TEST(PathFinder, TrivialResults)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, Layout::Plain, 1);
+
+    EXPECT_EQ(Otc::PathFindResultSamePosition, std::get<1>(map.findPath(center, center, 1000)));
+    EXPECT_EQ(Otc::PathFindResultImpossible, std::get<1>(map.findPath(center, center.translated(0, 0, 1), 1000)));
+
+    const auto& wallPos = center.translated(3, 0);
+    map.getTile(wallPos)->addThing(makeWall(), -1);
+    EXPECT_EQ(Otc::PathFindResultNoWay, std::get<1>(map.findPath(center, wallPos, 1000)));
+    EXPECT_EQ(Otc::PathFindResultTooFar, std::get<1>(map.findPath(center, center.translated(50, 50), 10)));
+}
+
+TEST(PathFinder, StraightLine)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_centralPosition = center;
+    map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+    for (int x = 0; x <= 5; ++x)
+        map.createTile(center.translated(x, 0))->addThing(makeGround(0), -1);
+
+    const auto& [dirs, result] = map.findPath(center, center.translated(5, 0), 1000);
+    ASSERT_EQ(Otc::PathFindResultOk, result);
+    EXPECT_EQ(std::vector<Otc::Direction>(5, Otc::East), dirs);
+}
+
+TEST(PathFinder, MatchesLegacyOnOpenMap)
+{
+    expectParity(Layout::Open);
+}
+
+TEST(PathFinder, MatchesLegacyOnMaze)
+{
+    expectParity(Layout::Maze);
+}
+
+TEST(PathFinder, MatchesLegacyOnLongDetour)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, Layout::Plain, 1);
+
+    // the goal is close but the only way around the wall is a gap far to the south
+    for (int y = -MAP_RADIUS; y <= MAP_RADIUS; ++y) {
+        if (y != 40)
+            map.getTile(center.translated(2, y))->addThing(makeWall(), -1);
+    }
+
+    for (const auto& goal : { center.translated(4, 0), center.translated(3, -5), center.translated(6, 45) }) {
+        const auto& [legacyDirs, legacyResult] = legacyFindPath(map, center, goal, 100000, 0);
+        const auto& [dirs, result] = map.findPath(center, goal, 100000, 0);
+
+        ASSERT_EQ(Otc::PathFindResultOk, legacyResult) << goal;
+        ASSERT_EQ(legacyResult, result) << goal;
+        EXPECT_NEAR(pathCost(map, center, goal, legacyDirs), pathCost(map, center, goal, dirs), 0.01f) << goal;
+    }
+
+    // a budget too small for the detour still gives up the same way
+    const auto& goal = center.translated(4, 0);
+    EXPECT_EQ(std::get<1>(legacyFindPath(map, center, goal, 500, 0)), std::get<1>(map.findPath(center, goal, 500, 0)));
+}
+
+TEST(PathFinderBenchmark, DISABLED_LegacyVersusGrid)
+{
+    const Position center(1000, 1000, 7);
+
+    for (const auto layout : { Layout::Open, Layout::Maze }) {
+        Map map;
+        setupMap(map, center, layout, 3);
+
+        const auto& queries = makeQueries(center, 5, 50);
+        const double legacy = benchmark([&](const Position& start, const Position& goal) {
+            legacyFindPath(map, start, goal, 100000, 0);
+        }, queries);
+        const double grid = benchmark([&](const Position& start, const Position& goal) {
+            map.findPath(start, goal, 100000, 0);
+        }, queries);
+
+        std::cout << (layout == Layout::Open ? "open" : "maze") << " map: legacy " << legacy << "us/path, grid " << grid << "us/path" << std::endl;
+    }
+}
+
+namespace {
+
+// queries the planner can handle, the window it keeps is smaller than the PathFinder one
+std::vector<std::pair<Position, Position>> makePlannerQueries(const Position& center, const uint32_t seed, const int count)
+{
+    auto queries = makeQueries(center, seed, count * 4);
+    std::erase_if(queries, [](const auto& query) {
+        return std::max(std::abs(query.first.x - query.second.x), std::abs(query.first.y - query.second.y)) > PathPlanner::MAX_DISTANCE;
+    });
+    queries.resize(std::min<size_t>(queries.size(), count));
+    return queries;
+}
+
+void expectSameCost(Map& map, const Position& start, const Position& goal, const std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult>& planned)
+{
+    const auto& [dirs, result] = map.findPath(start, goal, 100000, 0);
+    ASSERT_EQ(result == Otc::PathFindResultOk, std::get<1>(planned) == Otc::PathFindResultOk) << start << " -> " << goal;
+    if (result == Otc::PathFindResultOk) {
+        const float cost = pathCost(map, start, goal, std::get<0>(planned));
+        ASSERT_GE(cost, 0.f);
+        EXPECT_NEAR(pathCost(map, start, goal, dirs), cost, 0.01f) << start << " -> " << goal;
+    }
+}
+
+// second tile of the path that is not the goal, a good spot to block
+Position blockingPosition(const Position& start, const std::vector<Otc::Direction>& dirs)
+{
+    Position pos = start;
+    for (size_t i = 0; i < std::min<size_t>(dirs.size() - 1, 2); ++i)
+        pos = pos.translatedToDirection(dirs[i]);
+    return pos;
+}
+
+} // namespace
+
+TEST(PathPlanner, MatchesPathFinder)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, Layout::Maze, 9);
+
+    for (const auto& [start, goal] : makePlannerQueries(center, 13, 30)) {
+        const auto& planner = map.createPathPlanner(start, goal);
+        planner->setMaxComplexity(100000);
+        expectSameCost(map, start, goal, planner->getPath());
+    }
+}
+
+TEST(PathPlanner, RepairsAfterTileUpdate)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, Layout::Open, 21);
+
+    for (const auto& [start, goal] : makePlannerQueries(center, 17, 20)) {
+        const auto& planner = map.createPathPlanner(start, goal);
+        planner->setMaxComplexity(100000);
+
+        const auto& [dirs, result] = planner->getPath();
+        if (result != Otc::PathFindResultOk || dirs.size() < 3)
+            continue;
+        const uint32_t fullComplexity = planner->getLastComplexity();
+
+        // block the path, only the area around the wall has to be searched again
+        const auto& blockPos = blockingPosition(start, dirs);
+        const auto& wall = makeWall();
+        map.addThing(wall, blockPos, -1);
+
+        const auto& repaired = planner->getPath();
+        expectSameCost(map, start, goal, repaired);
+        EXPECT_LE(planner->getLastComplexity(), fullComplexity);
+
+        Position pos = start;
+        for (const auto dir : std::get<0>(repaired)) {
+            pos = pos.translatedToDirection(dir);
+            ASSERT_NE(blockPos, pos);
+        }
+
+        // walk a step and open the way again
+        if (!std::get<0>(repaired).empty()) {
+            const auto& next = start.translatedToDirection(std::get<0>(repaired).front());
+            planner->setStart(next);
+
+            map.getTile(blockPos)->removeThing(wall);
+            map.notificateTileUpdate(blockPos, wall, Otc::OPERATION_REMOVE);
+
+            expectSameCost(map, next, goal, planner->getPath());
+        }
+    }
+}
+
+TEST(PathPlannerBenchmark, DISABLED_RepairVersusSearch)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, Layout::Open, 4);
+
+    const auto& queries = makePlannerQueries(center, 19, 20);
+
+    std::vector<PathPlannerPtr> planners;
+    for (const auto& [start, goal] : queries) {
+        planners.emplace_back(map.createPathPlanner(start, goal));
+        planners.back()->setMaxComplexity(100000);
+        planners.back()->getPath();
+    }
+
+    // a creature stepping next to each start forces a re-plan
+    double search = 0;
+    double repair = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const auto& [start, goal] = queries[i];
+        const auto& blockPos = start.translated(1, 0);
+        if (blockPos == goal)
+            continue;
+
+        const auto& tile = map.getTile(blockPos);
+        const auto& wall = makeWall();
+        tile->addThing(wall, -1);
+        map.notificateTileUpdate(blockPos, wall, Otc::OPERATION_ADD);
+
+        search += benchmark([&](const Position& from, const Position& to) { map.findPath(from, to, 100000, 0); }, { queries[i] });
+        repair += benchmark([&](const Position&, const Position&) { planners[i]->getPath(); }, { queries[i] });
+
+        tile->removeThing(wall);
+        map.notificateTileUpdate(blockPos, wall, Otc::OPERATION_REMOVE);
+    }
+
+    std::cout << "re-plan: full search " << search / queries.size() << "us/path, repair " << repair / queries.size() << "us/path" << std::endl;
+}
+
+namespace {
+
+// copy of Map::newFindPath from before the walk snapshot, searching over a list of nodes
+// built from the visible tiles the way Map::findPathAsync used to
+PathFindResult_ptr legacyNewFindPath(Map& map, const Position& start, const Position& goal)
+{
+    std::list<Node*> visibleNodes;
+    for (const auto& tile : map.getTiles(start.z)) {
+        if (tile->getPosition() == start)
+            continue;
+        const bool isNotWalkable = !tile->isWalkable(false);
+        const bool isNotPathable = !tile->isPathable();
+        const float speed = tile->getGroundSpeed();
+        if ((isNotWalkable || isNotPathable) && tile->getPosition() != goal)
+            visibleNodes.push_back(new Node{ .cost = speed, .totalCost = 0, .pos = tile->getPosition(), .prev = nullptr, .distance = 0, .unseen = 0 });
+        else
+            visibleNodes.push_back(new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = tile->getPosition(), .prev = nullptr, .distance = 0, .unseen = 0 });
+    }
+
+    auto ret = std::make_shared<PathFindResult>();
+    ret->start = start;
+    ret->destination = goal;
+
+    const auto& cleanup = [&] {
+        for (const auto* node : visibleNodes)
+            delete node;
+    };
+
+    if (start == goal) {
+        ret->status = Otc::PathFindResultSamePosition;
+        cleanup();
+        return ret;
+    }
+
+    if (goal.z != start.z) {
+        cleanup();
+        return ret;
+    }
+
+    if (map.isAwareOfPosition(goal)) {
+        const auto& goalTile = map.getTile(goal);
+        if (!goalTile || !goalTile->isWalkable()) {
+            cleanup();
+            return ret;
+        }
+    } else if (g_minimap.getTile(goal).hasFlag(MinimapTileNotWalkable)) {
+        cleanup();
+        return ret;
+    }
+
+    struct LessNode
+    {
+        bool operator()(const Node* a, const Node* b) const
+        {
+            return b->totalCost < a->totalCost;
+        }
+    };
+
+    stdext::map<Position, Node*, Position::Hasher> nodes;
+    std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+
+    for (auto& node : visibleNodes)
+        nodes.emplace(node->pos, node);
+
+    const auto& initNode = new Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
+    nodes[start] = initNode;
+    searchList.push(initNode);
+
+    int limit = 50000;
+    const float distance = start.distance(goal);
+
+    const Node* dstNode = nullptr;
+    while (!searchList.empty() && --limit) {
+        Node* node = searchList.top();
+        searchList.pop();
+        if (node->pos == goal) {
+            dstNode = node;
+            break;
+        }
+        if (node->pos.distance(goal) > distance + 10000)
+            continue;
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+                Position neighbor = node->pos.translated(i, j);
+                if (neighbor.x < 0 || neighbor.y < 0) continue;
+                auto it = nodes.find(neighbor);
+                if (it == nodes.end()) {
+                    const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
+                    const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
+                    const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
+                    const bool isNotPathable = tile.hasFlag(MinimapTileNotPathable);
+                    const bool isEmpty = tile.hasFlag(MinimapTileEmpty);
+                    float speed = tile.getSpeed();
+                    if ((isNotWalkable || isNotPathable || isEmpty) && neighbor != goal) {
+                        it = nodes.emplace(neighbor, nullptr).first;
+                    } else {
+                        if (!wasSeen)
+                            speed = 2000;
+                        it = nodes.emplace(neighbor, new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev = node,
+                                               .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 }).first;
+                    }
+                }
+                if (!it->second) // no way
+                    continue;
+
+                if (it->second->unseen > 50)
+                    continue;
+
+                const float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
+                float cost = it->second->cost * diagonal;
+                cost += diagonal * (50.0f * std::max<float>(5.0f, it->second->pos.distance(goal))); // heuristic
+                if (node->totalCost + cost + 50 < it->second->totalCost) {
+                    it->second->totalCost = node->totalCost + cost;
+                    it->second->prev = node;
+                    if (it->second->unseen)
+                        it->second->unseen = node->unseen + 1;
+                    it->second->distance = node->distance + 1;
+                    searchList.push(it->second);
+                }
+            }
+        }
+    }
+
+    if (dstNode) {
+        while (dstNode && dstNode->prev) {
+            if (dstNode->unseen) {
+                ret->path.clear();
+            } else {
+                ret->path.push_back(dstNode->prev->pos.getDirectionFromPosition(dstNode->pos));
+            }
+            dstNode = dstNode->prev;
+        }
+        std::reverse(ret->path.begin(), ret->path.end());
+        ret->status = Otc::PathFindResultOk;
+    }
+    ret->complexity = 50000 - limit;
+
+    for (const auto& node : nodes)
+        delete node.second;
+
+    return ret;
+}
+
+void expectSameResult(const PathFindResult_ptr& expected, const PathFindResult_ptr& result)
+{
+    EXPECT_EQ(expected->status, result->status) << expected->start << " -> " << expected->destination;
+    EXPECT_EQ(expected->path, result->path) << expected->start << " -> " << expected->destination;
+    EXPECT_EQ(expected->complexity, result->complexity) << expected->start << " -> " << expected->destination;
+}
+
+void expectSnapshotParity(const Layout layout)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, layout, 13);
+
+    const auto& snapshot = map.getWalkSnapshot(center.z);
+    ASSERT_TRUE(snapshot);
+
+    for (const auto& [start, goal] : makeQueries(center, 17, 20))
+        expectSameResult(legacyNewFindPath(map, start, goal), map.newFindPath(start, goal, snapshot));
+}
+
+} // namespace
+
+TEST(WalkSnapshot, SearchMatchesVisibleNodesOnOpenMap)
+{
+    expectSnapshotParity(Layout::Open);
+}
+
+TEST(WalkSnapshot, SearchMatchesVisibleNodesOnMaze)
+{
+    expectSnapshotParity(Layout::Maze);
+}
+
+TEST(WalkSnapshot, HeldVersionOutlivesTileChanges)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    setupMap(map, center, Layout::Plain, 1);
+
+    const auto& goal = center.translated(6, 0);
+    const auto& held = map.getWalkSnapshot(center.z);
+    const auto& before = map.newFindPath(center, goal, held);
+    ASSERT_EQ(Otc::PathFindResultOk, before->status);
+    ASSERT_EQ(std::vector<Otc::Direction>(6, Otc::East), before->path);
+
+    // a wall on the way while a search still holds the old version
+    const auto& wallPos = center.translated(3, 0);
+    const auto& wall = makeWall();
+    map.getTile(wallPos)->addThing(wall, -1);
+    map.notificateTileUpdate(wallPos, wall, Otc::OPERATION_ADD);
+
+    const auto& current = map.getWalkSnapshot(center.z);
+    ASSERT_NE(held, current);
+    EXPECT_GT(current->getVersion(), held->getVersion());
+    EXPECT_TRUE(held->isWalkable(wallPos));
+    EXPECT_FALSE(current->isWalkable(wallPos));
+
+    expectSameResult(before, map.newFindPath(center, goal, held));
+
+    const auto& after = map.newFindPath(center, goal, current);
+    expectSameResult(legacyNewFindPath(map, center, goal), after);
+    EXPECT_NE(before->path, after->path);
+
+    // the current version was handed out as well, removing the wall goes to another copy
+    map.getTile(wallPos)->removeThing(wall);
+    map.notificateTileUpdate(wallPos, wall, Otc::OPERATION_REMOVE);
+    EXPECT_FALSE(current->isWalkable(wallPos));
+    EXPECT_TRUE(map.getWalkSnapshot(center.z)->isWalkable(wallPos));
+}
@@ -12,9 +12,10 @@
 #undef protected
 #undef private
 
-#include <framework/core/logger.h>
-#include <framework/core/resourcemanager.h>
-#include <framework/graphics/texturemanager.h>
+#include "map_test_environment.h"
+
+#include <chrono>
+#include <random>
 
 namespace {
 
@@ -99,29 +100,6 @@ public:
     }
 };
 
-class FrameworkEnvironment : public testing::Environment
-{
-public:
-    void SetUp() override
-    {
-        m_previousLogLevel = g_logger.getLevel();
-        g_logger.setLevel(Fw::LogFatal);
-        g_resources.init(".");
-        g_resources.addSearchPath(".");
-        g_textures.init();
-    }
-
-    void TearDown() override
-    {
-        g_textures.terminate();
-        g_resources.terminate();
-        g_logger.setLevel(m_previousLogLevel);
-    }
-
-private:
-    Fw::LogLevel m_previousLogLevel{ Fw::LogFatal };
-};
-
 [[maybe_unused]] testing::Environment* const g_frameworkEnv = testing::AddGlobalTestEnvironment(new FrameworkEnvironment);
 
 CreaturePtr makeCreature(const uint32_t id, const Position& position)
@@ -513,3 +491,122 @@ TEST(MapSpectators, UniqueCreatures)
     ASSERT_EQ(1u, spectators.size());
     EXPECT_EQ(shared, spectators.front());
 }
+
+TEST(MapSpectators, CreatureIndexFollowsTiles)
+{
+    const Position center(240, 340, 7);
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_centralPosition = center;
+
+    const auto fromTile = map.createTile(center);
+    const auto toTile = map.createTile(center.translated(40, 0));
+
+    auto creature = makeCreature(70, center);
+    fromTile->addThing(makeItem(center), -1);
+    fromTile->addThing(creature, -1);
+    EXPECT_EQ(1u, map.m_creatureIndex.size());
+
+    // a second creature on the same tile doesn't register it twice
+    auto other = makeCreature(71, center);
+    fromTile->addThing(other, -1);
+    EXPECT_EQ(1u, map.m_creatureIndex.size());
+    fromTile->removeThing(other);
+    EXPECT_EQ(1u, map.m_creatureIndex.size());
+
+    // walking into another block
+    fromTile->removeThing(creature);
+    EXPECT_EQ(0u, map.m_creatureIndex.size());
+    toTile->addThing(creature, -1);
+    EXPECT_EQ(1u, map.m_creatureIndex.size());
+
+    EXPECT_TRUE(map.getSpectatorsInRangeEx(center, false, 1, 1, 1, 1).empty());
+    EXPECT_EQ(std::vector<CreaturePtr>{ creature }, map.getSpectatorsInRangeEx(center, false, 0, 40, 0, 0));
+
+    toTile->clean();
+    EXPECT_EQ(0u, map.m_creatureIndex.size());
+
+    // replacing a tile drops the old one from the index
+    const auto replaced = map.createTile(center);
+    replaced->addThing(creature, -1);
+    map.createTile(center);
+    EXPECT_EQ(0u, map.m_creatureIndex.size());
+    EXPECT_TRUE(map.getSpectatorsInRangeEx(center, true, 2, 2, 2, 2).empty());
+}
+
+TEST(MapSpectators, CreatureIndexMatchesLegacyTraversal)
+{
+    const Position center(1000, 1000, 7);
+    constexpr int AREA = 60;
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_centralPosition = center;
+
+    std::mt19937 rng(17);
+    const auto randomPosition = [&] {
+        return center.translated(static_cast<int>(rng() % (AREA * 2 + 1)) - AREA, static_cast<int>(rng() % (AREA * 2 + 1)) - AREA, static_cast<int>(rng() % 3) - 1);
+    };
+
+    std::vector<CreaturePtr> creatures;
+    for (uint32_t id = 1; id <= 300; ++id) {
+        const auto& pos = randomPosition();
+        auto creature = makeCreature(id, pos);
+        map.getOrCreateTile(pos)->addThing(creature, -1);
+        map.m_knownCreatures.try_emplace(id, creature);
+        creatures.emplace_back(creature);
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        // move some creatures around, like the server would
+        for (int i = 0; i < 20; ++i) {
+            const auto& creature = creatures[rng() % creatures.size()];
+            map.getTile(creature->getPosition())->removeThing(creature);
+            const auto& pos = randomPosition();
+            creature->setPosition(pos);
+            map.getOrCreateTile(pos)->addThing(creature, -1);
+        }
+
+        const auto& queryCenter = center.translated(static_cast<int>(rng() % 41) - 20, static_cast<int>(rng() % 41) - 20);
+        const int minX = rng() % 20;
+        const int maxX = rng() % 20;
+        const int minY = rng() % 15;
+        const int maxY = rng() % 15;
+        const bool multiFloor = rng() % 2;
+
+        const auto expected = emulateLegacySpectatorCollection(map, queryCenter, multiFloor, minX, maxX, minY, maxY);
+        const auto actual = map.getSpectatorsInRangeEx(queryCenter, multiFloor, minX, maxX, minY, maxY);
+        ASSERT_EQ(expected, actual) << "round " << round;
+    }
+}
+
+TEST(MapSpectatorsBenchmark, DISABLED_IndexVersusFullScan)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_centralPosition = center;
+
+    std::mt19937 rng(23);
+    for (uint32_t id = 1; id <= 50; ++id) {
+        const auto& pos = center.translated(static_cast<int>(rng() % 19) - 9, static_cast<int>(rng() % 15) - 7, static_cast<int>(rng() % 3) - 1);
+        map.getOrCreateTile(pos)->addThing(makeCreature(id, pos), -1);
+    }
+
+    constexpr int ITERATIONS = 2000;
+    size_t found = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        found += emulateLegacySpectatorCollection(map, center, true, 9, 10, 7, 8).size();
+    const double scan = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / ITERATIONS;
+
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        found += map.getSpectatorsInRangeEx(center, true, 9, 10, 7, 8).size();
+    const double indexed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / ITERATIONS;
+
+    std::cout << "getSpectators: full scan " << scan << "us, creature index " << indexed << "us (" << found << ")" << std::endl;
+}
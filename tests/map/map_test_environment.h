@@ -0,0 +1,31 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+#include <framework/graphics/texturemanager.h>
+
+// framework singletons the map code touches, with the logger silenced
+class FrameworkEnvironment : public testing::Environment
+{
+public:
+    void SetUp() override
+    {
+        m_previousLogLevel = g_logger.getLevel();
+        g_logger.setLevel(Fw::LogFatal);
+        g_resources.init(".");
+        g_resources.addSearchPath(".");
+        g_textures.init();
+    }
+
+    void TearDown() override
+    {
+        g_textures.terminate();
+        g_resources.terminate();
+        g_logger.setLevel(m_previousLogLevel);
+    }
+
+private:
+    Fw::LogLevel m_previousLogLevel{ Fw::LogFatal };
+};
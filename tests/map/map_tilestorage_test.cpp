@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/map.h"
+
+#include "client/gameconfig.h"
+#include "client/tile.h"
+
+#undef protected
+#undef private
+
+#include <chrono>
+
+namespace {
+
+AwareRange makeAwareRange()
+{
+    const auto& viewPort = g_gameConfig.getMapViewPort();
+    return {
+        .left = static_cast<uint8_t>(viewPort.width()),
+        .top = static_cast<uint8_t>(viewPort.height()),
+        .right = static_cast<uint8_t>(viewPort.width() + 1),
+        .bottom = static_cast<uint8_t>(viewPort.height() + 1)
+    };
+}
+
+template<typename Fn>
+void forEachAwarePosition(const Position& center, const AwareRange& range, Fn&& fn)
+{
+    for (int z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+        for (int y = center.y - range.top; y <= center.y + range.bottom; ++y) {
+            for (int x = center.x - range.left; x <= center.x + range.right; ++x)
+                fn(Position(x, y, z));
+        }
+    }
+}
+
+// storage used before the page table, kept to compare lookups
+class LegacyTileStorage
+{
+public:
+    explicit LegacyTileStorage(const size_t floors) : m_floors(floors) {}
+
+    void create(const Position& pos) { m_floors[pos.z][getBlockIndex(pos)].getOrCreate(pos); }
+
+    const TilePtr& get(const Position& pos)
+    {
+        static const TilePtr nulltile;
+
+        auto& tileBlocks = m_floors[pos.z];
+        const auto it = tileBlocks.find(getBlockIndex(pos));
+        if (it != tileBlocks.end())
+            return it->second.get(pos);
+
+        return nulltile;
+    }
+
+private:
+    static uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+
+    std::vector<std::unordered_map<uint32_t, TileBlock>> m_floors;
+};
+
+} // namespace
+
+TEST(MapTileStorage, DistantBlocksDoNotCollide)
+{
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+
+    // both blocks had the same 16 bit index in the hashed storage
+    const Position first(100, 100, 7);
+    const Position second(100, 1124, 7);
+
+    const auto firstTile = map.getOrCreateTile(first);
+    const auto secondTile = map.getOrCreateTile(second);
+
+    ASSERT_NE(firstTile, secondTile);
+    EXPECT_EQ(map.getTile(first), firstTile);
+    EXPECT_EQ(map.getTile(second), secondTile);
+    EXPECT_EQ(map.m_floors[7].tileBlocks.size(), 2u);
+}
+
+TEST(MapTileStorage, LookupsFollowErasedBlocks)
+{
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+
+    const Position first(1000, 1000, 7);
+    const Position second(1040, 1000, 7);
+
+    map.getOrCreateTile(first);
+    map.getOrCreateTile(second);
+    ASSERT_NE(map.getTile(first), nullptr);
+
+    auto& tileBlocks = map.m_floors[7].tileBlocks;
+    ASSERT_EQ(tileBlocks.size(), 2u);
+
+    // the first block is the last one found, erasing it must drop the cached lookup
+    tileBlocks.erase(0);
+    EXPECT_EQ(map.getTile(first), nullptr);
+    EXPECT_NE(map.getTile(second), nullptr);
+
+    const auto recreated = map.getOrCreateTile(first);
+    EXPECT_EQ(map.getTile(first), recreated);
+
+    map.m_floors[7].tileBlocks.clear();
+    EXPECT_EQ(map.getTile(first), nullptr);
+    EXPECT_EQ(map.getTile(second), nullptr);
+}
+
+TEST(MapTileStorage, BlocksAtMapEdges)
+{
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+
+    for (const auto& pos : { Position(0, 0, 0), Position(65535, 0, 0), Position(0, 65535, 0), Position(65535, 65535, 0) })
+        map.getOrCreateTile(pos);
+
+    EXPECT_EQ(map.m_floors[0].tileBlocks.size(), 4u);
+    EXPECT_EQ(map.getTiles(0).size(), 4u);
+    EXPECT_NE(map.getTile(Position(65535, 65535, 0)), nullptr);
+    EXPECT_EQ(map.getTile(Position(65534, 65535, 0)), nullptr);
+}
+
+TEST(MapTileStorageBenchmark, DISABLED_GetTileAwareRange)
+{
+    const Position center(1000, 1000, 7);
+    const auto range = makeAwareRange();
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    LegacyTileStorage legacy(g_gameConfig.getMapMaxZ() + 1);
+
+    size_t positions = 0;
+    forEachAwarePosition(center, range, [&](const Position& pos) {
+        map.getOrCreateTile(pos);
+        legacy.create(pos);
+        ++positions;
+    });
+
+    constexpr int ITERATIONS = 200;
+    size_t found = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        forEachAwarePosition(center, range, [&](const Position& pos) { found += legacy.get(pos) != nullptr; });
+    const double hashed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (ITERATIONS * positions);
+
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        forEachAwarePosition(center, range, [&](const Position& pos) { found += map.getTile(pos) != nullptr; });
+    const double paged = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (ITERATIONS * positions);
+
+    EXPECT_EQ(found, 2 * ITERATIONS * positions);
+    std::cout << "getTile over " << positions << " positions: hashed blocks " << hashed << "ns, page table " << paged << "ns" << std::endl;
+}
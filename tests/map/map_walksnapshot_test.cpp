@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include "client/walksnapshot.h"
+
+namespace {
+
+TEST(WalkSnapshot, ContainsOnlyItsFloorAndArea)
+{
+    const WalkSnapshot snapshot(Position(100, 200, 7), 18, 14);
+
+    EXPECT_TRUE(snapshot.contains(Position(100, 200, 7)));
+    EXPECT_TRUE(snapshot.contains(Position(117, 213, 7)));
+    EXPECT_FALSE(snapshot.contains(Position(118, 200, 7)));
+    EXPECT_FALSE(snapshot.contains(Position(100, 214, 7)));
+    EXPECT_FALSE(snapshot.contains(Position(99, 200, 7)));
+    EXPECT_FALSE(snapshot.contains(Position(100, 199, 7)));
+    EXPECT_FALSE(snapshot.contains(Position(100, 200, 6)));
+}
+
+TEST(WalkSnapshot, KeepsCellsUntilRemoved)
+{
+    WalkSnapshot snapshot(Position(100, 200, 7), 18, 14);
+
+    const Position pos(110, 205, 7);
+    EXPECT_FALSE(snapshot.hasTile(pos));
+
+    snapshot.setCell(pos, { .speed = 150, .walkable = true, .pathable = false });
+    EXPECT_TRUE(snapshot.hasTile(pos));
+    EXPECT_TRUE(snapshot.isWalkable(pos));
+    EXPECT_FALSE(snapshot.isPathable(pos));
+    EXPECT_EQ(snapshot.getSpeed(pos), 150);
+
+    // neighbors share the bitplane words
+    EXPECT_FALSE(snapshot.hasTile(pos.translated(1, 0)));
+    EXPECT_FALSE(snapshot.hasTile(pos.translated(-1, 0)));
+
+    snapshot.setCell(pos, { .speed = 80, .walkable = false, .pathable = true });
+    EXPECT_FALSE(snapshot.isWalkable(pos));
+    EXPECT_TRUE(snapshot.isPathable(pos));
+    EXPECT_EQ(snapshot.getSpeed(pos), 80);
+
+    snapshot.removeCell(pos);
+    EXPECT_FALSE(snapshot.hasTile(pos));
+
+    // outside positions are ignored
+    snapshot.setCell(Position(100, 200, 6), { .speed = 150, .walkable = true, .pathable = true });
+    EXPECT_FALSE(snapshot.hasTile(Position(100, 200, 6)));
+}
+
+}
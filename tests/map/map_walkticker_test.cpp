@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/map.h"
+
+#include "client/creature.h"
+#include "client/gameconfig.h"
+#include "client/thingtype.h"
+#include "client/walkticker.h"
+
+#include <framework/core/clock.h>
+#include <framework/core/eventdispatcher.h>
+
+#undef protected
+#undef private
+
+#include "map_test_environment.h"
+
+#include <functional>
+#include <vector>
+
+namespace {
+
+class WalkTickerEnvironment : public FrameworkEnvironment
+{
+public:
+    void SetUp() override
+    {
+        FrameworkEnvironment::SetUp();
+        // events scheduled by the walks are queued, never polled
+        g_dispatcher.init();
+    }
+};
+
+[[maybe_unused]] testing::Environment* const g_frameworkEnv = testing::AddGlobalTestEnvironment(new WalkTickerEnvironment);
+
+class WalkingCreature final : public Creature
+{
+public:
+    WalkingCreature(const uint16_t speed)
+    {
+        m_speed = speed;
+        setRemovedSilently(false);
+    }
+
+    void onPositionChange(const Position&, const Position& oldPos) override { setOldPositionSilently(oldPos); }
+    void onAppear() override { setRemovedSilently(false); }
+    void onDisappear() override { setRemovedSilently(true); }
+
+    ThingType* getThingType() const override
+    {
+        static ThingType type;
+
+        static const bool initialized = [] {
+            type.m_null = false;
+            type.m_category = ThingCategoryCreature;
+            type.m_size = Size(1, 1);
+            type.m_realSize = 32;
+            type.m_layers = 1;
+            type.m_animationPhases = 1;
+            type.m_opacity = 1.f;
+            return true;
+        }();
+
+        (void)initialized;
+        return &type;
+    }
+
+    void onWalking() override
+    {
+        ++*updates;
+        if (onUpdate)
+            onUpdate();
+    }
+
+    void terminateWalk() override
+    {
+        Creature::terminateWalk();
+        finishedAt = g_clock.millis();
+    }
+
+    // kept outside, the creature may be gone when it is read
+    std::shared_ptr<int> updates = std::make_shared<int>(0);
+    std::function<void()> onUpdate;
+    ticks_t finishedAt{ -1 };
+};
+
+using WalkingCreaturePtr = std::shared_ptr<WalkingCreature>;
+
+constexpr ticks_t START = 100000;
+const Position FROM(100, 100, 7);
+const Position TO(101, 100, 7);
+
+// when the step ends with one event per creature, scheduled a walk duration after each update
+ticks_t eventFinishTime(const ticks_t start, const uint16_t stepDuration, const uint16_t walkDuration)
+{
+    const float walkTicksPerPixel = stepDuration / static_cast<float>(g_gameConfig.getSpriteSize());
+    for (ticks_t time = start;; time += walkDuration) {
+        if (std::min<int>((time - start) / walkTicksPerPixel, g_gameConfig.getSpriteSize()) == g_gameConfig.getSpriteSize())
+            return time;
+    }
+}
+
+// polls every millisecond from the given time until no one walks, starting each walk at its time
+void run(const std::vector<std::pair<WalkingCreaturePtr, ticks_t>>& walks, const ticks_t from, uint64_t* maxUpdatesPerTick = nullptr)
+{
+    for (ticks_t time = from; time < from + 10000; ++time) {
+        g_clock.m_currentMillis = time;
+        for (const auto& [creature, start] : walks) {
+            if (start == time)
+                creature->walk(FROM, TO);
+        }
+
+        const auto updates = g_walkTicker.getUpdates();
+        g_walkTicker.tick();
+        if (maxUpdatesPerTick)
+            *maxUpdatesPerTick = std::max(*maxUpdatesPerTick, g_walkTicker.getUpdates() - updates);
+
+        if (g_walkTicker.getActiveWalkers() == 0 && time > walks.back().second)
+            return;
+    }
+    FAIL() << "walks didn't end";
+}
+
+WalkingCreaturePtr makeCreature(const uint32_t id, const uint16_t speed)
+{
+    const auto& creature = std::make_shared<WalkingCreature>(speed);
+    creature->setId(id);
+    creature->setPosition(TO);
+    return creature;
+}
+
+class WalkTickerTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_previousMillis = g_clock.m_currentMillis;
+        g_clock.m_currentMillis = START;
+        g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+        g_walkTicker.resetStats();
+    }
+
+    void TearDown() override
+    {
+        g_walkTicker.terminate();
+        g_map.m_floors.clear();
+        g_clock.m_currentMillis = m_previousMillis;
+    }
+
+    ticks_t m_previousMillis{ 0 };
+};
+
+TEST_F(WalkTickerTest, OneTickAdvancesEveryDueWalker)
+{
+    const std::vector<std::pair<uint16_t, ticks_t>> setups{
+        { 110, 0 }, { 110, 0 }, { 220, 0 }, { 400, 5 }, { 800, 7 }, { 1000, 7 }, { 320, 30 }
+    };
+
+    std::vector<std::pair<WalkingCreaturePtr, ticks_t>> walks;
+    for (size_t i = 0; i < setups.size(); ++i)
+        walks.emplace_back(makeCreature(i + 1, setups[i].first), START + setups[i].second);
+
+    uint64_t maxUpdatesPerTick = 0;
+    run(walks, START, &maxUpdatesPerTick);
+
+    uint64_t updates = 0;
+    for (const auto& [creature, start] : walks) {
+        const auto& step = creature->m_stepCache;
+        ASSERT_GT(step.walkDuration, 0);
+
+        const ticks_t expected = eventFinishTime(start, step.duration, step.walkDuration);
+        EXPECT_EQ(expected, creature->finishedAt) << "creature " << creature->getId();
+        EXPECT_FALSE(creature->isWalking());
+        EXPECT_EQ(UINT32_MAX, creature->m_walkTickerIndex);
+
+        // the first update is done by walk()
+        EXPECT_EQ(1 + (expected - start) / step.walkDuration, *creature->updates) << "creature " << creature->getId();
+        updates += (expected - start) / step.walkDuration;
+    }
+
+    EXPECT_EQ(updates, g_walkTicker.getUpdates());
+    EXPECT_GE(maxUpdatesPerTick, 3u);
+}
+
+// walkers are kept in the order they started, the remover stops the victim on its first
+// update by the ticker, when the victim is due too and only referenced by the ticker
+void expectRemovedWalkerIsNotStepped(const size_t walkers, const size_t removerIndex, const size_t victimIndex)
+{
+    std::vector<WalkingCreaturePtr> creatures;
+    for (size_t i = 0; i < walkers; ++i)
+        creatures.emplace_back(makeCreature(i + 1, 200));
+
+    g_clock.m_currentMillis = START;
+    for (const auto& creature : creatures)
+        creature->walk(FROM, TO);
+
+    const auto remover = creatures[removerIndex];
+    const std::weak_ptr<WalkingCreature> victim = creatures[victimIndex];
+    const auto victimUpdates = creatures[victimIndex]->updates;
+    int victimUpdatesAtRemoval = -1;
+
+    remover->onUpdate = [&, remover = remover.get()] {
+        if (*remover->updates < 2 || victimUpdatesAtRemoval != -1)
+            return;
+
+        const auto& creature = victim.lock();
+        ASSERT_TRUE(creature);
+        creature->stopWalk();
+        victimUpdatesAtRemoval = *victimUpdates;
+    };
+    creatures.erase(creatures.begin() + victimIndex);
+
+    std::vector<std::pair<WalkingCreaturePtr, ticks_t>> walks;
+    for (const auto& creature : creatures)
+        walks.emplace_back(creature, START);
+    run(walks, START + 1);
+
+    ASSERT_NE(-1, victimUpdatesAtRemoval);
+    EXPECT_EQ(victimUpdatesAtRemoval, *victimUpdates);
+
+    // the others keep their pace, whichever walker took the place of the victim
+    for (const auto& creature : creatures) {
+        const auto& step = creature->m_stepCache;
+        EXPECT_EQ(eventFinishTime(START, step.duration, step.walkDuration), creature->finishedAt) << "creature " << creature->getId();
+    }
+}
+
+TEST_F(WalkTickerTest, RemovedWalkerBeforeTheUpdatedOneIsNotSteppedAgain)
+{
+    expectRemovedWalkerIsNotStepped(4, 2, 0);
+}
+
+TEST_F(WalkTickerTest, RemovedWalkerAfterTheUpdatedOneIsNotStepped)
+{
+    expectRemovedWalkerIsNotStepped(4, 0, 2);
+}
+
+TEST_F(WalkTickerTest, RemovingTheLastWalkerKeepsThePaceOfTheOthers)
+{
+    expectRemovedWalkerIsNotStepped(4, 1, 3);
+}
+
+}
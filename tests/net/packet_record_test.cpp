@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#define private public
+#include <framework/core/clock.h>
+#include <framework/net/packet_player.h>
+#include <framework/net/packet_recorder.h>
+#undef private
+
+#include <framework/core/logger.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct RecordedFrame
+{
+    ticks_t time;
+    PacketRecordDirection direction;
+    std::vector<uint8_t> data;
+};
+
+// a frame every 150ms for 18 seconds, with a few large packets, so blocks are
+// closed both by duration and by size
+std::vector<RecordedFrame> makeFrames()
+{
+    std::vector<RecordedFrame> frames;
+    for (int i = 0; i < 120; ++i) {
+        const size_t size = i % 25 == 7 ? 40 * 1024 : 1 + i * 13 % 200;
+        std::vector<uint8_t> data(size);
+        for (size_t j = 0; j < size; ++j)
+            data[j] = static_cast<uint8_t>(i * 31 + j * 7);
+        frames.emplace_back(i * 150, i % 3 == 2 ? PacketRecordOutput : PacketRecordInput, std::move(data));
+    }
+    return frames;
+}
+
+class PacketRecordTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_previousLogLevel = g_logger.getLevel();
+        g_logger.setLevel(Fw::LogFatal);
+        m_previousMillis = g_clock.m_currentMillis;
+
+        // recorder and player work on the records directory of the working directory
+        m_previousPath = std::filesystem::current_path();
+        m_workDir = std::filesystem::temp_directory_path() / fmt::format("otclient-packet-record-{}", stdext::getThreadId());
+        std::filesystem::create_directories(m_workDir / "records");
+        std::filesystem::current_path(m_workDir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::current_path(m_previousPath);
+        std::error_code ec;
+        std::filesystem::remove_all(m_workDir, ec);
+        g_clock.m_currentMillis = m_previousMillis;
+        g_logger.setLevel(m_previousLogLevel);
+    }
+
+    static void record(const std::string& file, const bool compress, const std::vector<RecordedFrame>& frames)
+    {
+        constexpr ticks_t START = 100000;
+        g_clock.m_currentMillis = START;
+
+        PacketRecorder recorder(file, compress);
+        for (const auto& frame : frames) {
+            g_clock.m_currentMillis = START + frame.time;
+            recorder.addFrame(frame.direction, { reinterpret_cast<const char*>(frame.data.data()), frame.data.size() });
+        }
+    }
+
+    static std::filesystem::path path(const std::string& file) { return std::filesystem::path("records") / file; }
+
+    static uint64_t indexOffset(const std::string& file)
+    {
+        std::ifstream stream(path(file), std::ios::binary);
+        uint8_t trailer[PACKET_RECORD_TRAILER_SIZE];
+        stream.seekg(-static_cast<std::streamoff>(PACKET_RECORD_TRAILER_SIZE), std::ios::end);
+        stream.read(reinterpret_cast<char*>(trailer), sizeof(trailer));
+        return stdext::readULE64(trailer);
+    }
+
+    static std::vector<RecordedFrame> readAll(PacketRecordReader& reader)
+    {
+        std::vector<RecordedFrame> frames;
+        PacketRecordReader::Frame frame;
+        while (reader.next(frame))
+            frames.emplace_back(frame.time, frame.direction, *frame.data);
+        return frames;
+    }
+
+    static void expectFrames(const std::vector<RecordedFrame>& expected, const std::vector<RecordedFrame>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i].time, actual[i].time) << "frame " << i;
+            EXPECT_EQ(expected[i].direction, actual[i].direction) << "frame " << i;
+            EXPECT_EQ(expected[i].data, actual[i].data) << "frame " << i;
+        }
+    }
+
+    std::filesystem::path m_workDir;
+    std::filesystem::path m_previousPath;
+    ticks_t m_previousMillis{ 0 };
+    Fw::LogLevel m_previousLogLevel{ Fw::LogFatal };
+};
+
+TEST_F(PacketRecordTest, RoundTripsCompressedFrames)
+{
+    const auto& frames = makeFrames();
+    record("compressed.otpr", true, frames);
+
+    PacketRecordReader reader;
+    ASSERT_TRUE(reader.open(path("compressed.otpr")));
+    EXPECT_TRUE(reader.isBinary());
+    EXPECT_EQ(PacketRecordCompressed, reader.m_flags);
+    EXPECT_GT(reader.m_blocks.size(), 3u);
+    EXPECT_EQ(frames.back().time, reader.getDuration());
+    expectFrames(frames, readAll(reader));
+}
+
+TEST_F(PacketRecordTest, RoundTripsUncompressedFrames)
+{
+    const auto& frames = makeFrames();
+    record("raw.otpr", false, frames);
+
+    PacketRecordReader reader;
+    ASSERT_TRUE(reader.open(path("raw.otpr")));
+    EXPECT_TRUE(reader.isBinary());
+    EXPECT_EQ(0, reader.m_flags);
+    EXPECT_GT(reader.m_blocks.size(), 3u);
+    EXPECT_EQ(frames.back().time, reader.getDuration());
+    expectFrames(frames, readAll(reader));
+}
+
+TEST_F(PacketRecordTest, PlayerSeeksToTheNextInputAcrossBlocks)
+{
+    const auto& frames = makeFrames();
+    record("seek.otpr", true, frames);
+
+    PacketPlayer player("seek.otpr");
+    ASSERT_GT(player.m_reader.m_blocks.size(), 3u);
+
+    std::vector<ticks_t> times{ 0, 1, 150, 299, 300, 17850, 17851, 30000 };
+    // just before, at and after the start of every block
+    for (const auto& block : player.m_reader.m_blocks) {
+        times.emplace_back(static_cast<ticks_t>(block.firstTime) - 1);
+        times.emplace_back(block.firstTime);
+        times.emplace_back(block.firstTime + 1);
+        times.emplace_back(block.lastTime + 1);
+    }
+
+    // going back and forth, the reader keeps no state between seeks
+    for (const auto direction : { 1, -1 }) {
+        for (size_t i = 0; i < times.size(); ++i) {
+            const ticks_t time = times[direction > 0 ? i : times.size() - 1 - i];
+            player.seek(time);
+
+            const auto it = std::ranges::find_if(frames, [&](const RecordedFrame& frame) {
+                return frame.direction == PacketRecordInput && frame.time >= time;
+            });
+            if (it == frames.end()) {
+                EXPECT_FALSE(player.m_hasNextInput) << "seek " << time;
+                continue;
+            }
+
+            ASSERT_TRUE(player.m_hasNextInput) << "seek " << time;
+            EXPECT_EQ(it->time, player.m_nextInput.time) << "seek " << time;
+            EXPECT_EQ(it->data, *player.m_nextInput.data) << "seek " << time;
+        }
+    }
+}
+
+TEST_F(PacketRecordTest, ReadsRecordsWithoutIndex)
+{
+    const auto& frames = makeFrames();
+    record("unclosed.otpr", true, frames);
+
+    PacketRecordReader indexed;
+    ASSERT_TRUE(indexed.open(path("unclosed.otpr")));
+    const auto blocks = indexed.m_blocks.size();
+
+    // a recording that was never closed ends right after its last block
+    std::filesystem::resize_file(path("unclosed.otpr"), indexOffset("unclosed.otpr"));
+
+    PacketRecordReader reader;
+    ASSERT_TRUE(reader.open(path("unclosed.otpr")));
+    EXPECT_EQ(blocks, reader.m_blocks.size());
+    EXPECT_EQ(frames.back().time, reader.getDuration());
+    expectFrames(frames, readAll(reader));
+
+    reader.seek(9000);
+    PacketRecordReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(9000, frame.time);
+}
+
+TEST_F(PacketRecordTest, ReadsRecordsWithTruncatedIndex)
+{
+    const auto& frames = makeFrames();
+    record("truncated.otpr", false, frames);
+
+    PacketRecordReader indexed;
+    ASSERT_TRUE(indexed.open(path("truncated.otpr")));
+    const auto blocks = indexed.m_blocks.size();
+
+    // the index signature is cut, the leftover index must not be read as blocks
+    const auto size = std::filesystem::file_size(path("truncated.otpr"));
+    std::filesystem::resize_file(path("truncated.otpr"), size - 5);
+
+    PacketRecordReader reader;
+    ASSERT_TRUE(reader.open(path("truncated.otpr")));
+    EXPECT_EQ(blocks, reader.m_blocks.size());
+    EXPECT_EQ(frames.back().time, reader.getDuration());
+    expectFrames(frames, readAll(reader));
+}
+
+TEST_F(PacketRecordTest, DropsTheCutLastBlock)
+{
+    const auto& frames = makeFrames();
+    record("cut.otpr", true, frames);
+    std::filesystem::resize_file(path("cut.otpr"), indexOffset("cut.otpr") - 10);
+
+    PacketRecordReader reader;
+    ASSERT_TRUE(reader.open(path("cut.otpr")));
+    ASSERT_FALSE(reader.m_blocks.empty());
+
+    // every block before the cut one is read
+    const auto& read = readAll(reader);
+    ASSERT_FALSE(read.empty());
+    ASSERT_LT(read.size(), frames.size());
+    EXPECT_EQ(reader.m_blocks.back().lastTime, read.back().time);
+    expectFrames({ frames.begin(), frames.begin() + read.size() }, read);
+}
+
+TEST_F(PacketRecordTest, ReadsLegacyTextRecords)
+{
+    {
+        std::ofstream stream(path("legacy.log"));
+        stream << "< 0 0a0B\n"
+               << "> 12 ff00\n"
+               << "< 30 DEADbeef\n"
+               << "< 45 01\n";
+    }
+
+    PacketRecordReader reader;
+    ASSERT_TRUE(reader.open(path("legacy.log")));
+    EXPECT_FALSE(reader.isBinary());
+    EXPECT_EQ(45, reader.getDuration());
+
+    const std::vector<RecordedFrame> expected{
+        { 0, PacketRecordInput, { 0x0a, 0x0b } },
+        { 12, PacketRecordOutput, { 0xff, 0x00 } },
+        { 30, PacketRecordInput, { 0xde, 0xad, 0xbe, 0xef } },
+        { 45, PacketRecordInput, { 0x01 } },
+    };
+    expectFrames(expected, readAll(reader));
+
+    reader.seek(13);
+    expectFrames({ expected.begin() + 2, expected.end() }, readAll(reader));
+
+    PacketPlayer player("legacy.log");
+    player.seek(1);
+    ASSERT_TRUE(player.m_hasNextInput);
+    EXPECT_EQ(30, player.m_nextInput.time);
+}
+
+}